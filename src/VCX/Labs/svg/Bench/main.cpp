@@ -0,0 +1,695 @@
+//=============================================================================
+// svg-bench - Rendering benchmark on synthetic scenes
+//
+// Generates parameterized documents and times each pipeline stage on its own:
+//   parse      SVGParser::ParseString into an SVGDocument
+//   parse_flat SVGParser::ParseString into a FlatDocument
+//   flatten    fill geometry of every shape (paths flattened, shapes tessellated)
+//   stroke     stroke expansion (geometry with strokes minus fill only)
+//   rasterize  edge setup + scan conversion into a null sink
+//   blend      replay of the recorded coverage spans into a render target
+//   render     SVGRendererV2::RenderSVG end to end, for reference
+//   render_flat the same from the FlatDocument
+// Results are written as JSON (stdout or -o file).
+//=============================================================================
+
+#include "Labs/svg/SVGParser.h"
+#include "Labs/svg/Renderer/SVGRendererV2.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+    #define NOMINMAX
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+using namespace VCX::Labs;
+using namespace VCX::Labs::SVG;
+
+namespace {
+
+    struct BenchOptions {
+        std::vector<std::string> scenes;    // Empty = all
+        int count = 0;                      // 0 = per-scene default
+        int width = 1024;
+        int height = 768;
+        int repeat = 5;
+        unsigned seed = 1;
+        ScanlineRasterizer::AAMode aaMode = ScanlineRasterizer::AAMode::Coverage4x;
+        bool enableAA = true;
+        std::string output;                 // Empty = stdout
+    };
+
+    //=========================================================================
+    // Synthetic scenes
+    //=========================================================================
+
+    struct Scene {
+        std::string name;
+        std::string svg;
+        int elements = 0;                   // Drawable elements generated
+        bool gradient = false;              // Blend samples a gradient paint
+    };
+
+    struct SceneGenerator {
+        const char* name;
+        int defaultCount;
+        const char* description;
+        std::function<Scene(int count, int width, int height, unsigned seed)> generate;
+    };
+
+    class SvgWriter {
+    public:
+        SvgWriter(int width, int height) {
+            _out << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width
+                 << "\" height=\"" << height << "\">\n";
+        }
+        std::ostringstream& Out() { return _out; }
+        std::string Finish() { _out << "</svg>\n"; return _out.str(); }
+
+    private:
+        std::ostringstream _out;
+    };
+
+    class Random {
+    public:
+        explicit Random(unsigned seed) : _engine(seed) {}
+        float Uniform(float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(_engine); }
+        int Int(int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(_engine); }
+        std::string Color() {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "#%06x", Int(0, 0xffffff));
+            return buf;
+        }
+
+    private:
+        std::mt19937 _engine;
+    };
+
+    Scene GenerateRects(int count, int width, int height, unsigned seed) {
+        Random rng(seed);
+        SvgWriter svg(width, height);
+        for (int i = 0; i < count; ++i) {
+            float w = rng.Uniform(4, width * 0.15f);
+            float h = rng.Uniform(4, height * 0.15f);
+            svg.Out() << "<rect x=\"" << rng.Uniform(-w * 0.5f, width - w * 0.5f)
+                      << "\" y=\"" << rng.Uniform(-h * 0.5f, height - h * 0.5f)
+                      << "\" width=\"" << w << "\" height=\"" << h
+                      << "\" fill=\"" << rng.Color() << "\" fill-opacity=\"" << rng.Uniform(0.3f, 1.0f) << "\"";
+            if (i % 4 == 0) svg.Out() << " stroke=\"" << rng.Color() << "\" stroke-width=\"2\"";
+            svg.Out() << "/>\n";
+        }
+        return { "rects", svg.Finish(), count };
+    }
+
+    Scene GenerateCircles(int count, int width, int height, unsigned seed) {
+        Random rng(seed);
+        SvgWriter svg(width, height);
+        for (int i = 0; i < count; ++i) {
+            svg.Out() << "<circle cx=\"" << rng.Uniform(0, width) << "\" cy=\"" << rng.Uniform(0, height)
+                      << "\" r=\"" << rng.Uniform(2, width * 0.05f)
+                      << "\" fill=\"" << rng.Color() << "\" fill-opacity=\"" << rng.Uniform(0.3f, 1.0f) << "\"";
+            if (i % 4 == 0) svg.Out() << " stroke=\"" << rng.Color() << "\" stroke-width=\"1.5\"";
+            svg.Out() << "/>\n";
+        }
+        return { "circles", svg.Finish(), count };
+    }
+
+    // count polylines of 500 points each, stroked only
+    Scene GeneratePolylines(int count, int width, int height, unsigned seed) {
+        Random rng(seed);
+        SvgWriter svg(width, height);
+        const int points = 500;
+        for (int i = 0; i < count; ++i) {
+            float x = rng.Uniform(0, width);
+            float y = rng.Uniform(0, height);
+            svg.Out() << "<path d=\"M " << x << " " << y;
+            for (int k = 1; k < points; ++k) {
+                x = std::clamp(x + rng.Uniform(-20, 20), 0.0f, static_cast<float>(width));
+                y = std::clamp(y + rng.Uniform(-20, 20), 0.0f, static_cast<float>(height));
+                svg.Out() << " L " << x << " " << y;
+            }
+            svg.Out() << "\" fill=\"none\" stroke=\"" << rng.Color() << "\" stroke-width=\"1.5\"/>\n";
+        }
+        return { "polylines", svg.Finish(), count };
+    }
+
+    // count shapes spread over groups nested 32 levels deep
+    Scene GenerateNestedGroups(int count, int width, int height, unsigned seed) {
+        Random rng(seed);
+        SvgWriter svg(width, height);
+        const int depth = 32;
+        int perLevel = std::max(1, count / depth);
+        int emitted = 0;
+        for (int level = 0; level < depth; ++level) {
+            svg.Out() << "<g transform=\"translate(" << rng.Uniform(-2, 2) << " " << rng.Uniform(-2, 2)
+                      << ") rotate(" << rng.Uniform(-1, 1) << ")\" fill=\"" << rng.Color() << "\">\n";
+            int n = level == depth - 1 ? count - emitted : std::min(perLevel, count - emitted);
+            for (int i = 0; i < n; ++i, ++emitted) {
+                if (i % 2 == 0) {
+                    svg.Out() << "<rect x=\"" << rng.Uniform(0, width) << "\" y=\"" << rng.Uniform(0, height)
+                              << "\" width=\"" << rng.Uniform(4, 60) << "\" height=\"" << rng.Uniform(4, 60) << "\"/>\n";
+                } else {
+                    svg.Out() << "<circle cx=\"" << rng.Uniform(0, width) << "\" cy=\"" << rng.Uniform(0, height)
+                              << "\" r=\"" << rng.Uniform(2, 30) << "\"/>\n";
+                }
+            }
+        }
+        for (int level = 0; level < depth; ++level) svg.Out() << "</g>\n";
+        return { "nested-groups", svg.Finish(), count };
+    }
+
+    // Closed filled paths of 16 cubic and quadratic segments each
+    Scene GenerateCurves(int count, int width, int height, unsigned seed) {
+        Random rng(seed);
+        SvgWriter svg(width, height);
+        for (int i = 0; i < count; ++i) {
+            float cx = rng.Uniform(0, width);
+            float cy = rng.Uniform(0, height);
+            float r = rng.Uniform(10, width * 0.1f);
+            auto point = [&]() {
+                std::ostringstream p;
+                p << cx + rng.Uniform(-r, r) << " " << cy + rng.Uniform(-r, r);
+                return p.str();
+            };
+            svg.Out() << "<path d=\"M " << point();
+            for (int k = 0; k < 16; ++k) {
+                if (k % 2 == 0) svg.Out() << " C " << point() << " " << point() << " " << point();
+                else            svg.Out() << " Q " << point() << " " << point();
+            }
+            svg.Out() << " Z\" fill=\"" << rng.Color() << "\" fill-opacity=\"0.7\""
+                      << (i % 2 ? " fill-rule=\"evenodd\"" : "") << "/>\n";
+        }
+        return { "curves", svg.Finish(), count };
+    }
+
+    // Thick dashed strokes along curves, round joins and caps
+    Scene GenerateDashedStrokes(int count, int width, int height, unsigned seed) {
+        Random rng(seed);
+        SvgWriter svg(width, height);
+        for (int i = 0; i < count; ++i) {
+            float x = rng.Uniform(0, width);
+            float y = rng.Uniform(0, height);
+            svg.Out() << "<path d=\"M " << x << " " << y;
+            for (int k = 0; k < 4; ++k) {
+                svg.Out() << " C " << x + rng.Uniform(-150, 150) << " " << y + rng.Uniform(-150, 150)
+                          << " " << x + rng.Uniform(-150, 150) << " " << y + rng.Uniform(-150, 150);
+                x = rng.Uniform(0, width);
+                y = rng.Uniform(0, height);
+                svg.Out() << " " << x << " " << y;
+            }
+            svg.Out() << "\" fill=\"none\" stroke=\"" << rng.Color() << "\" stroke-width=\"" << rng.Uniform(6, 16)
+                      << "\" stroke-dasharray=\"" << rng.Uniform(10, 30) << "," << rng.Uniform(5, 15)
+                      << "\" stroke-linecap=\"round\" stroke-linejoin=\"round\"/>\n";
+        }
+        return { "dashed-strokes", svg.Finish(), count };
+    }
+
+    // The parser does not read gradient definitions yet, so these shapes carry
+    // solid fills and the blend stage samples a gradient paint per pixel instead
+    // (the renderer's paint path: Paint::Sample + blendColors)
+    Scene GenerateGradients(int count, int width, int height, unsigned seed) {
+        Scene scene = GenerateRects(count, width, height, seed);
+        scene.name = "gradients";
+        scene.gradient = true;
+        return scene;
+    }
+
+    const std::vector<SceneGenerator>& SceneGenerators() {
+        static const std::vector<SceneGenerator> generators = {
+            { "rects",          10000, "random rects, 1/4 stroked",             GenerateRects },
+            { "circles",        10000, "random circles, 1/4 stroked",           GenerateCircles },
+            { "polylines",      100,   "stroked polylines of 500 points",       GeneratePolylines },
+            { "nested-groups",  5000,  "shapes in groups nested 32 deep",       GenerateNestedGroups },
+            { "curves",         2000,  "filled paths of 16 curve segments",     GenerateCurves },
+            { "dashed-strokes", 500,   "thick dashed round-joined curves",      GenerateDashedStrokes },
+            { "gradients",      2000,  "random rects blended with a gradient",  GenerateGradients },
+        };
+        return generators;
+    }
+
+    //=========================================================================
+    // Measurement
+    //=========================================================================
+
+    using Clock = std::chrono::steady_clock;
+
+    double Nanoseconds(Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double, std::nano>(to - from).count();
+    }
+
+    // Peak resident set size of the process so far, in bytes (0 if unknown)
+    std::uint64_t PeakRSS() {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    #if defined(__APPLE__)
+        return static_cast<std::uint64_t>(usage.ru_maxrss);            // bytes
+    #else
+        return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;     // kilobytes
+    #endif
+#endif
+    }
+
+    // Coverage spans of one fill, kept for the blend stage
+    struct RecordedSpan {
+        int y, x0, x1;
+        float alpha;
+        std::int64_t coverage;      // Offset into the coverage buffer, or -1
+        std::uint32_t fill;         // Index of the fill (color/paint)
+    };
+
+    struct RecordedFill {
+        glm::vec4 color;
+        BBox bounds;
+    };
+
+    struct SpanRecording {
+        std::vector<RecordedSpan> spans;
+        std::vector<float> coverage;
+        std::vector<RecordedFill> fills;
+        std::uint64_t pixels = 0;
+
+        void Clear() { spans.clear(); coverage.clear(); fills.clear(); pixels = 0; }
+    };
+
+    struct StageTimes {
+        double parse = 0, parseFlat = 0, flatten = 0, stroke = 0, rasterize = 0, blend = 0, render = 0, renderFlat = 0;
+    };
+
+    class SceneBench {
+    public:
+        explicit SceneBench(const BenchOptions& options) : _options(options) {
+            _renderer.SetAntiAliasing(options.enableAA);
+            _renderer.SetAAMode(options.aaMode);
+            _renderer.SetGeometryCacheEnabled(false);
+            _rasterizer.SetAAMode(options.enableAA ? options.aaMode : ScanlineRasterizer::AAMode::None);
+        }
+
+        bool Run(const Scene& scene, StageTimes& result, std::uint64_t& coveredPixels);
+
+    private:
+        const BenchOptions& _options;
+        SVGRendererV2 _renderer;
+        ScanlineRasterizer _rasterizer;
+        const BlendKernels& _blend = GetBlendKernels();
+        std::vector<PreparedShape> _shapes;
+        SpanRecording _recording;
+
+        template <typename Sink>
+        void ForEachFill(const RenderTarget& target, Sink&& sink);
+        void Record(const RenderTarget& target);
+        void Replay(const Scene& scene, RenderTarget& target);
+    };
+
+    // Every fill of the prepared shapes in draw order: (edges, fill rule, color)
+    template <typename Sink>
+    void SceneBench::ForEachFill(const RenderTarget& target, Sink&& sink) {
+        int w = target.GetWidth();
+        int h = target.GetHeight();
+        for (const auto& shape : _shapes) {
+            const ElementGeometry& geometry = *shape.geometry;
+            if (shape.fillColor.a > 0 && !geometry.fill.IsEmpty()) {
+                sink(_rasterizer.PrepareEdges(geometry.fill, w, h), shape.fillRule, shape.fillColor, geometry.bounds);
+            }
+            if (shape.strokeColor.a > 0) {
+                for (const auto& outline : geometry.strokes) {
+                    if (outline.size() < 3) continue;
+                    sink(_rasterizer.PrepareEdges(outline, w, h), FillRule::NonZero, shape.strokeColor, geometry.bounds);
+                }
+            }
+        }
+    }
+
+    void SceneBench::Record(const RenderTarget& target) {
+        _recording.Clear();
+        PixelRect clip = target.Bounds();
+        ForEachFill(target, [&](const EdgeList& edges, FillRule rule, const glm::vec4& color, const BBox& bounds) {
+            if (edges.IsEmpty()) return;
+            std::uint32_t fill = static_cast<std::uint32_t>(_recording.fills.size());
+            _recording.fills.push_back({ color, bounds });
+            _rasterizer.SetFillRule(rule);
+            _rasterizer.RasterizeClipped(edges, clip.x0, clip.y0, clip.x1, clip.y1, [&](const CoverageSpan& span) {
+                std::int64_t offset = -1;
+                int count = span.x1 - span.x0 + 1;
+                if (span.coverage) {
+                    offset = static_cast<std::int64_t>(_recording.coverage.size());
+                    _recording.coverage.insert(_recording.coverage.end(), span.coverage, span.coverage + count);
+                }
+                _recording.spans.push_back({ span.y, span.x0, span.x1, span.alpha, offset, fill });
+                _recording.pixels += count;
+            });
+        });
+    }
+
+    // Same per-span work as SVGRendererV2::BlendSpan / ExecuteCommand
+    void SceneBench::Replay(const Scene& scene, RenderTarget& target) {
+        LinearGradient gradient(Vec2(0, 0), Vec2(1, 1));
+        gradient.AddStop(0.0f, glm::vec4(1, 0, 0, 1));
+        gradient.AddStop(0.5f, glm::vec4(0, 1, 0, 0.6f));
+        gradient.AddStop(1.0f, glm::vec4(0, 0, 1, 1));
+        Paint paint(gradient);
+
+        for (const auto& span : _recording.spans) {
+            const RecordedFill& fill = _recording.fills[span.fill];
+            glm::vec4* row = target.Row(span.y);
+            int count = span.x1 - span.x0 + 1;
+            const float* mask = span.coverage >= 0 ? _recording.coverage.data() + span.coverage : nullptr;
+
+            if (scene.gradient) {
+                const int chunkSize = 64;
+                glm::vec4 colors[chunkSize];
+                for (int x0 = span.x0; x0 <= span.x1; x0 += chunkSize) {
+                    int n = std::min(chunkSize, span.x1 - x0 + 1);
+                    for (int i = 0; i < n; ++i) {
+                        colors[i] = paint.Sample(Vec2(x0 + i + 0.5f, span.y + 0.5f), fill.bounds);
+                    }
+                    _blend.blendColors(row + x0, colors, mask ? mask + (x0 - span.x0) : nullptr, span.alpha, n);
+                }
+                continue;
+            }
+
+            glm::vec4 src(fill.color.r, fill.color.g, fill.color.b, 1.0f);
+            if (mask) {
+                _blend.blendSolidMask(row + span.x0, mask, count, src, fill.color.a);
+                continue;
+            }
+            float alpha = fill.color.a * span.alpha;
+            if (alpha <= 0) continue;
+            if (alpha >= 1.0f) {
+                _blend.fillOpaque(row + span.x0, count, src);
+            } else {
+                _blend.blendSolid(row + span.x0, count, src * alpha, 1.0f - alpha);
+            }
+        }
+    }
+
+    bool SceneBench::Run(const Scene& scene, StageTimes& result, std::uint64_t& coveredPixels) {
+        std::vector<StageTimes> runs;
+        RenderTarget target(_options.width, _options.height);
+
+        for (int r = 0; r < _options.repeat; ++r) {
+            StageTimes t;
+
+            auto t0 = Clock::now();
+            SVGParser parser;
+            SVGDocument document;
+            if (!parser.ParseString(scene.svg, document)) {
+                std::cerr << scene.name << ": parse failed" << std::endl;
+                return false;
+            }
+            auto t1 = Clock::now();
+            t.parse = Nanoseconds(t0, t1);
+
+            t0 = Clock::now();
+            FlatDocument flat;
+            if (!parser.ParseString(scene.svg, flat)) {
+                std::cerr << scene.name << ": flat parse failed" << std::endl;
+                return false;
+            }
+            t1 = Clock::now();
+            t.parseFlat = Nanoseconds(t0, t1);
+
+            t0 = Clock::now();
+            _renderer.PrepareShapes(document, target, false, _shapes);
+            t1 = Clock::now();
+            t.flatten = Nanoseconds(t0, t1);
+
+            t0 = Clock::now();
+            _renderer.PrepareShapes(document, target, true, _shapes);
+            t1 = Clock::now();
+            t.stroke = std::max(0.0, Nanoseconds(t0, t1) - t.flatten);
+
+            // Scan conversion alone: spans go nowhere
+            t0 = Clock::now();
+            PixelRect clip = target.Bounds();
+            ForEachFill(target, [&](const EdgeList& edges, FillRule rule, const glm::vec4&, const BBox&) {
+                if (edges.IsEmpty()) return;
+                _rasterizer.SetFillRule(rule);
+                _rasterizer.RasterizeClipped(edges, clip.x0, clip.y0, clip.x1, clip.y1, [](const CoverageSpan&) {});
+            });
+            t1 = Clock::now();
+            t.rasterize = Nanoseconds(t0, t1);
+
+            // Blending alone: spans recorded beforehand (untimed)
+            Record(target);
+            target.Clear(glm::vec4(1));
+            t0 = Clock::now();
+            Replay(scene, target);
+            t1 = Clock::now();
+            t.blend = Nanoseconds(t0, t1);
+            coveredPixels = _recording.pixels;
+
+            t0 = Clock::now();
+            Common::ImageRGB image = _renderer.RenderSVG(document, _options.width, _options.height);
+            t1 = Clock::now();
+            t.render = Nanoseconds(t0, t1);
+
+            t0 = Clock::now();
+            image = _renderer.RenderSVG(flat, _options.width, _options.height);
+            t1 = Clock::now();
+            t.renderFlat = Nanoseconds(t0, t1);
+
+            runs.push_back(t);
+        }
+
+        // Median per stage
+        auto median = [&](double StageTimes::* field) {
+            std::vector<double> values;
+            for (const auto& run : runs) values.push_back(run.*field);
+            std::sort(values.begin(), values.end());
+            return values[values.size() / 2];
+        };
+        result.parse = median(&StageTimes::parse);
+        result.parseFlat = median(&StageTimes::parseFlat);
+        result.flatten = median(&StageTimes::flatten);
+        result.stroke = median(&StageTimes::stroke);
+        result.rasterize = median(&StageTimes::rasterize);
+        result.blend = median(&StageTimes::blend);
+        result.render = median(&StageTimes::render);
+        result.renderFlat = median(&StageTimes::renderFlat);
+        return true;
+    }
+
+    //=========================================================================
+    // Command line and report
+    //=========================================================================
+
+    void PrintUsage() {
+        std::cout <<
+            "Usage: svg-bench [options]\n"
+            "\n"
+            "Options:\n"
+            "  -s, --scene <name>      Scene to run (repeatable, default: all)\n"
+            "  -n, --count <n>         Elements per scene (default: per scene)\n"
+            "  -W, --width <px>        Target width (default: 1024)\n"
+            "  -H, --height <px>       Target height (default: 768)\n"
+            "  -r, --repeat <n>        Runs per scene, the median is reported (default: 5)\n"
+            "      --seed <n>          Scene generator seed (default: 1)\n"
+            "  -a, --aa <mode>         none | 4x | 8x | 16x | analytical | area (default: 4x)\n"
+            "  -o, --output <file>     Write the JSON report to a file (default: stdout)\n"
+            "  -l, --list              List scenes\n"
+            "  -h, --help              Show this help\n";
+    }
+
+    bool ParseAAMode(const std::string& name, BenchOptions& options) {
+        options.enableAA = true;
+        if (name == "none")            { options.enableAA = false; options.aaMode = ScanlineRasterizer::AAMode::None; }
+        else if (name == "4x")         options.aaMode = ScanlineRasterizer::AAMode::Coverage4x;
+        else if (name == "8x")         options.aaMode = ScanlineRasterizer::AAMode::Coverage8x;
+        else if (name == "16x")        options.aaMode = ScanlineRasterizer::AAMode::Coverage16x;
+        else if (name == "analytical") options.aaMode = ScanlineRasterizer::AAMode::Analytical;
+        else if (name == "area")       options.aaMode = ScanlineRasterizer::AAMode::AccumulatedArea;
+        else return false;
+        return true;
+    }
+
+    const char* AAModeName(const BenchOptions& options) {
+        if (!options.enableAA) return "none";
+        switch (options.aaMode) {
+            case ScanlineRasterizer::AAMode::Coverage4x: return "4x";
+            case ScanlineRasterizer::AAMode::Coverage8x: return "8x";
+            case ScanlineRasterizer::AAMode::Coverage16x: return "16x";
+            case ScanlineRasterizer::AAMode::Analytical: return "analytical";
+            case ScanlineRasterizer::AAMode::AccumulatedArea: return "area";
+            default: return "none";
+        }
+    }
+
+    bool ParseArguments(int argc, char** argv, BenchOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> const char* {
+                if (i + 1 >= argc) {
+                    std::cerr << "Missing value for " << arg << std::endl;
+                    return nullptr;
+                }
+                return argv[++i];
+            };
+
+            if (arg == "-h" || arg == "--help") {
+                PrintUsage();
+                std::exit(0);
+            } else if (arg == "-l" || arg == "--list") {
+                for (const auto& generator : SceneGenerators()) {
+                    std::printf("%-16s %6d  %s\n", generator.name, generator.defaultCount, generator.description);
+                }
+                std::exit(0);
+            } else if (arg == "-s" || arg == "--scene") {
+                const char* v = value(); if (!v) return false;
+                options.scenes.push_back(v);
+            } else if (arg == "-n" || arg == "--count") {
+                const char* v = value(); if (!v) return false;
+                options.count = std::atoi(v);
+            } else if (arg == "-W" || arg == "--width") {
+                const char* v = value(); if (!v) return false;
+                options.width = std::atoi(v);
+            } else if (arg == "-H" || arg == "--height") {
+                const char* v = value(); if (!v) return false;
+                options.height = std::atoi(v);
+            } else if (arg == "-r" || arg == "--repeat") {
+                const char* v = value(); if (!v) return false;
+                options.repeat = std::atoi(v);
+            } else if (arg == "--seed") {
+                const char* v = value(); if (!v) return false;
+                options.seed = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+            } else if (arg == "-a" || arg == "--aa") {
+                const char* v = value(); if (!v) return false;
+                if (!ParseAAMode(v, options)) {
+                    std::cerr << "Unknown AA mode: " << v << std::endl;
+                    return false;
+                }
+            } else if (arg == "-o" || arg == "--output") {
+                const char* v = value(); if (!v) return false;
+                options.output = v;
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        }
+
+        if (options.width <= 0 || options.height <= 0 || options.repeat <= 0 || options.count < 0) {
+            std::cerr << "Width, height, repeat and count must be positive" << std::endl;
+            return false;
+        }
+        for (const auto& name : options.scenes) {
+            auto& generators = SceneGenerators();
+            if (std::none_of(generators.begin(), generators.end(), [&](const SceneGenerator& g) { return name == g.name; })) {
+                std::cerr << "Unknown scene: " << name << " (see --list)" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void WriteStage(std::ostream& out, const char* name, double ns, int elements, const char* trailer) {
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "        \"%s\": { \"ms\": %.3f, \"ns_per_element\": %.1f }%s\n",
+                      name, ns * 1e-6, elements > 0 ? ns / elements : 0.0, trailer);
+        out << buf;
+    }
+
+    double MegapixelsPerSecond(double pixels, double ns) {
+        return ns > 0 ? pixels / ns * 1e3 : 0.0;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!ParseArguments(argc, argv, options)) return 2;
+
+    std::ostringstream report;
+    report << "{\n"
+           << "  \"width\": " << options.width << ",\n"
+           << "  \"height\": " << options.height << ",\n"
+           << "  \"aa\": \"" << AAModeName(options) << "\",\n"
+           << "  \"simd\": \"" << GetSimdLevelName(DetectSimdLevel()) << "\",\n"
+           << "  \"repeat\": " << options.repeat << ",\n"
+           << "  \"seed\": " << options.seed << ",\n"
+           << "  \"scenes\": [\n";
+
+    SceneBench bench(options);
+    bool ok = true;
+    bool first = true;
+    for (const auto& generator : SceneGenerators()) {
+        if (!options.scenes.empty() &&
+            std::find(options.scenes.begin(), options.scenes.end(), generator.name) == options.scenes.end()) {
+            continue;
+        }
+
+        int count = options.count > 0 ? options.count : generator.defaultCount;
+        Scene scene = generator.generate(count, options.width, options.height, options.seed);
+
+        StageTimes times;
+        std::uint64_t covered = 0;
+        if (!bench.Run(scene, times, covered)) {
+            ok = false;
+            continue;
+        }
+        double targetPixels = static_cast<double>(options.width) * options.height;
+
+        char buf[256];
+        report << (first ? "" : ",\n") << "    {\n"
+               << "      \"name\": \"" << scene.name << "\",\n"
+               << "      \"elements\": " << scene.elements << ",\n"
+               << "      \"bytes\": " << scene.svg.size() << ",\n"
+               << "      \"covered_pixels\": " << covered << ",\n"
+               << "      \"stages\": {\n";
+        WriteStage(report, "parse", times.parse, scene.elements, ",");
+        WriteStage(report, "parse_flat", times.parseFlat, scene.elements, ",");
+        WriteStage(report, "flatten", times.flatten, scene.elements, ",");
+        WriteStage(report, "stroke", times.stroke, scene.elements, ",");
+        WriteStage(report, "rasterize", times.rasterize, scene.elements, ",");
+        WriteStage(report, "blend", times.blend, scene.elements, ",");
+        WriteStage(report, "render", times.render, scene.elements, ",");
+        WriteStage(report, "render_flat", times.renderFlat, scene.elements, "");
+        std::snprintf(buf, sizeof(buf),
+                      "      },\n"
+                      "      \"rasterize_mpix_per_s\": %.2f,\n"
+                      "      \"blend_mpix_per_s\": %.2f,\n"
+                      "      \"render_mpix_per_s\": %.2f,\n",
+                      MegapixelsPerSecond(static_cast<double>(covered), times.rasterize),
+                      MegapixelsPerSecond(static_cast<double>(covered), times.blend),
+                      MegapixelsPerSecond(targetPixels, times.render));
+        report << buf
+               << "      \"peak_rss_bytes\": " << PeakRSS() << "\n"
+               << "    }";
+        first = false;
+
+        std::cerr << scene.name << ": render " << times.render * 1e-6 << " ms" << std::endl;
+    }
+    report << "\n  ]\n}\n";
+
+    if (options.output.empty()) {
+        std::cout << report.str();
+    } else {
+        std::ofstream file(options.output);
+        if (!file || !(file << report.str())) {
+            std::cerr << options.output << ": write failed" << std::endl;
+            return 1;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -2,18 +2,31 @@
 #include "Labs/Common/ImGuiHelper.h"
 
 #include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <cstring>
 #include <sstream>
 #include <fstream>
 #include <cmath>
 #include <filesystem>
+#include <functional>
 
 namespace VCX::Labs::SVG {
 
+    // InputTextMultiline 写入 std::string：缓冲区不够时扩容，并保持 size 与文本长度一致
+    static int ResizeTextCallback(ImGuiInputTextCallbackData* data) {
+        if (data->EventFlag == ImGuiInputTextFlags_CallbackResize) {
+            auto* text = static_cast<std::string*>(data->UserData);
+            text->resize(data->BufTextLen);
+            data->Buf = text->data();
+        }
+        return 0;
+    }
+
     CaseSVGRender::CaseSVGRender():
         _texture({ .MinFilter = Engine::GL::FilterMode::Linear, .MagFilter = Engine::GL::FilterMode::Nearest }) {
-        std::memset(_svgTextBuffer, 0, sizeof(_svgTextBuffer));
         _svgTextContent = "";
         
         // Find project root by searching for assets folder
@@ -152,7 +165,7 @@ namespace VCX::Labs::SVG {
                 }
                 
                 if (_enableAntiAliasing) {
-                    const char* aaModeNames[] = { "None", "4x Coverage", "8x Coverage", "16x Coverage", "Analytical" };
+                    const char* aaModeNames[] = { "None", "4x Coverage", "8x Coverage", "16x Coverage", "Analytical", "Accumulated Area" };
                     if (ImGui::Combo("AA Mode", &_aaMode, aaModeNames, IM_ARRAYSIZE(aaModeNames))) {
                         _recompute = true;
                     }
@@ -162,7 +175,8 @@ namespace VCX::Labs::SVG {
                             "4x Coverage: 4 samples per pixel\n"
                             "8x Coverage: 8 samples per pixel\n"
                             "16x Coverage: 16 samples per pixel (best quality)\n"
-                            "Analytical: Distance-based edge smoothing"
+                            "Analytical: Distance-based edge smoothing\n"
+                            "Accumulated Area: Exact signed-area coverage (fast for large fills)"
                         );
                     }
                 }
@@ -175,6 +189,99 @@ namespace VCX::Labs::SVG {
                                       "Higher = faster rendering (fewer segments)\n"
                                       "Recommended: 0.25 - 1.0");
                 }
+
+                if (ImGui::SliderInt("Render Threads", &_renderThreads, 0, 16, _renderThreads == 0 ? "Auto" : "%d")) {
+                    _recompute = true;
+                }
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("1 = single-threaded\n"
+                                      ">1 = 64x64 tiles rendered in parallel\n"
+                                      "0 = one thread per core\n"
+                                      "Output is identical in all cases");
+                }
+
+                if (ImGui::Checkbox("Geometry Cache", &_geometryCache)) {
+                    _recompute = true;
+                }
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("Reuse flattened paths and stroke outlines\n"
+                                      "of unchanged elements between renders");
+                }
+                if (_geometryCache) {
+                    const auto& stats = _svgRendererV2.GetGeometryCache().GetStats();
+                    ImGui::Text("Cache: %zu hit, %zu moved, %zu rebuilt",
+                                stats.hits, stats.translated, stats.misses);
+
+                    if (ImGui::Checkbox("Incremental Redraw", &_incrementalRender)) {
+                        _recompute = true;
+                    }
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("Only redraw the area covered by elements\n"
+                                          "that changed since the last frame");
+                    }
+                    if (_incrementalRender) {
+                        ImGui::Text("Redrawn: %dx%d", _lastDamage.x1 - _lastDamage.x0 + 1,
+                                    _lastDamage.y1 - _lastDamage.y0 + 1);
+                    }
+                }
+
+                if (ImGui::Checkbox("Render Stats", &_renderStats)) {
+                    _recompute = true;
+                }
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("Time each stage of the last frame and count\n"
+                                      "edges, covered pixels and culled elements\n"
+                                      "(adds a little overhead per span)");
+                }
+                if (_renderStats) {
+                    const RenderStats& stats = _svgRendererV2.GetLastStats();
+                    auto stageMs = [&](RenderStats::Stage stage) {
+                        return stage == RenderStats::Stage::Parse ? _parseMs : stats.Time(stage);
+                    };
+
+                    double total = 0;
+                    for (int i = 0; i < static_cast<int>(RenderStats::Stage::Count); ++i) {
+                        total += stageMs(static_cast<RenderStats::Stage>(i));
+                    }
+                    ImGui::Text("Frame: %.2f ms", stats.frameMs);
+                    for (int i = 0; i < static_cast<int>(RenderStats::Stage::Count); ++i) {
+                        auto stage = static_cast<RenderStats::Stage>(i);
+                        char label[64];
+                        std::snprintf(label, sizeof(label), "%s %.2f ms", RenderStats::StageName(stage), stageMs(stage));
+                        ImGui::ProgressBar(total > 0 ? static_cast<float>(stageMs(stage) / total) : 0.0f,
+                                           ImVec2(-1, 0), label);
+                    }
+                    ImGui::Text("Elements: %llu (%llu culled)",
+                                static_cast<unsigned long long>(stats.elements),
+                                static_cast<unsigned long long>(stats.elementsCulled));
+                    ImGui::Text("Fills: %llu, edges: %llu",
+                                static_cast<unsigned long long>(stats.fills),
+                                static_cast<unsigned long long>(stats.edges));
+                    ImGui::Text("Pixels covered: %llu",
+                                static_cast<unsigned long long>(stats.pixelsCovered));
+                    ImGui::Text("Coverage buffers: %.1f KB", stats.coverageBytes / 1024.0);
+
+                    if (ImGui::Button("Export Chrome Trace", ImVec2(-1, 0))) {
+                        std::filesystem::path tracePath = std::filesystem::path(_projectRoot) / "render_trace.json";
+                        RenderStats trace = stats;
+                        trace.Time(RenderStats::Stage::Parse) = _parseMs;
+                        if (trace.WriteChromeTrace(tracePath.string())) {
+                            std::cout << "Render trace written: " << tracePath.string() << std::endl;
+                        } else {
+                            std::cerr << "Failed to write render trace: " << tracePath.string() << std::endl;
+                        }
+                    }
+                }
+
+                if (ImGui::Checkbox("Cost Heatmap", &_costHeatmap)) {
+                    _recompute = true;
+                }
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("Tint each element by what it cost to render\n"
+                                      "(blue = cheap, red = expensive) and list the\n"
+                                      "most expensive ones in the Layers tab.\n"
+                                      "Renders full frames without the geometry cache.");
+                }
                 
                 ImGui::Unindent();
             }
@@ -227,8 +334,9 @@ namespace VCX::Labs::SVG {
                 _isDragging = false;
                 
                 // 清空文本编辑器
-                std::memset(_svgTextBuffer, 0, sizeof(_svgTextBuffer));
+                _svgTextBuffer.clear();
                 _svgTextContent = "";
+                InvalidateSourceMap();
                 
                 _fileLoaded = false;  // 完全重置状态
                 
@@ -251,26 +359,26 @@ namespace VCX::Labs::SVG {
     }
 
     void CaseSVGRender::DrawCodeEditor() {
-        ImGuiInputTextFlags flags = ImGuiInputTextFlags_AllowTabInput;
+        ImGuiInputTextFlags flags = ImGuiInputTextFlags_AllowTabInput | ImGuiInputTextFlags_CallbackResize;
         // Calculate available height for the editor
         float buttonHeight = _autoSyncText ? 0 : 30;
         float height = ImGui::GetContentRegionAvail().y - buttonHeight - 10;
         
-        bool textChanged = ImGui::InputTextMultiline("##SVGEditor", _svgTextBuffer, 
-                                     sizeof(_svgTextBuffer), 
-                                     ImVec2(-1, height > 100 ? height : 100), flags);
+        bool textChanged = ImGui::InputTextMultiline("##SVGEditor", _svgTextBuffer.data(),
+                                     _svgTextBuffer.capacity() + 1,
+                                     ImVec2(-1, height > 100 ? height : 100), flags,
+                                     ResizeTextCallback, &_svgTextBuffer);
         
-        // 实时检测文本变化
+        // 实时检测文本变化（只在输入后比较，大文件不必每帧复制）
         if (_autoSyncText) {
-            std::string currentText(_svgTextBuffer);
-            if (currentText != _svgTextContent) {
-                _svgTextContent = currentText;
+            if (textChanged && _svgTextBuffer != _svgTextContent) {
+                _svgTextContent = _svgTextBuffer;
                 UpdateSVGFromText();
                 UpdateRender();
             }
         } else if (textChanged) {
             // 非实时模式下，只在编辑完成时更新
-            _svgTextContent = std::string(_svgTextBuffer);
+            _svgTextContent = _svgTextBuffer;
         }
         
         if (!_autoSyncText && ImGui::Button("Apply Changes", ImVec2(-1, 0))) {
@@ -296,6 +404,12 @@ namespace VCX::Labs::SVG {
         auto& element = _svgDocument.elements[_selectedElementIndex];
         const auto& bounds = _elementBounds[_selectedElementIndex];
 
+        // 记录修改标记，面板里改了几何/样式/变换后只刷新这一个元素的拾取数据
+        const std::uint32_t versionBefore = element.version;
+        const std::uint32_t styleVersionBefore = element.styleVersion;
+        const Point2D offsetBefore = element.contentOffset;
+        const glm::mat3 transformBefore = element.transform.matrix;
+
         ImGui::Text("Selected Element");
         ImGui::Separator();
         ImGui::Text("Type: %s", bounds.tagName.c_str());
@@ -311,7 +425,7 @@ namespace VCX::Labs::SVG {
         
         if (ImGui::InputText("ID", idBuf, sizeof(idBuf))) {
             element.id = idBuf;
-            UpdateTextFromSVG();
+            SyncElementToText(_selectedElementIndex);
             UpdateRender();
         }
 
@@ -336,7 +450,8 @@ namespace VCX::Labs::SVG {
                     default:
                         break;
                 }
-                UpdateTextFromSVG();
+                element.MarkStyleModified();
+                SyncElementToText(_selectedElementIndex);
                 UpdateRender();
             }
         } else {
@@ -356,7 +471,8 @@ namespace VCX::Labs::SVG {
                     default:
                         break;
                 }
-                UpdateTextFromSVG();
+                element.MarkStyleModified();
+                SyncElementToText(_selectedElementIndex);
                 UpdateRender();
             }
         }
@@ -379,7 +495,8 @@ namespace VCX::Labs::SVG {
                     default:
                         break;
                 }
-                UpdateTextFromSVG();
+                element.MarkStyleModified();
+                SyncElementToText(_selectedElementIndex);
                 UpdateRender();
             }
         } else {
@@ -399,7 +516,8 @@ namespace VCX::Labs::SVG {
                     default:
                         break;
                 }
-                UpdateTextFromSVG();
+                element.MarkStyleModified();
+                SyncElementToText(_selectedElementIndex);
                 UpdateRender();
             }
         }
@@ -420,7 +538,8 @@ namespace VCX::Labs::SVG {
                 default:
                     break;
             }
-            UpdateTextFromSVG();
+            element.MarkStyleModified();
+            SyncElementToText(_selectedElementIndex);
             UpdateRender();
         }
 
@@ -432,15 +551,17 @@ namespace VCX::Labs::SVG {
             case SVGElement::Type::Rect: {
                 float pos[2] = { element.rect.position.x, element.rect.position.y };
                 if (ImGui::DragFloat2("Position", pos, 1.0f)) {
+                    element.MarkTranslated(pos[0] - element.rect.position.x, pos[1] - element.rect.position.y);
                     element.rect.position = Point2D(pos[0], pos[1]);
-                    UpdateTextFromSVG();
+                    SyncElementToText(_selectedElementIndex);
                     UpdateRender();
                 }
                 float size[2] = { element.rect.width, element.rect.height };
                 if (ImGui::DragFloat2("Size", size, 1.0f, 0.0f, 10000.0f)) {
                     element.rect.width = size[0];
                     element.rect.height = size[1];
-                    UpdateTextFromSVG();
+                    element.MarkModified();
+                    SyncElementToText(_selectedElementIndex);
                     UpdateRender();
                 }
                 break;
@@ -448,14 +569,16 @@ namespace VCX::Labs::SVG {
             case SVGElement::Type::Circle: {
                 float center[2] = { element.circle.center.x, element.circle.center.y };
                 if (ImGui::DragFloat2("Center", center, 1.0f)) {
+                    element.MarkTranslated(center[0] - element.circle.center.x, center[1] - element.circle.center.y);
                     element.circle.center = Point2D(center[0], center[1]);
-                    UpdateTextFromSVG();
+                    SyncElementToText(_selectedElementIndex);
                     UpdateRender();
                 }
                 float radius = element.circle.radius;
                 if (ImGui::DragFloat("Radius", &radius, 1.0f, 0.0f, 10000.0f)) {
                     element.circle.radius = radius;
-                    UpdateTextFromSVG();
+                    element.MarkModified();
+                    SyncElementToText(_selectedElementIndex);
                     UpdateRender();
                 }
                 break;
@@ -464,13 +587,15 @@ namespace VCX::Labs::SVG {
                 float start[2] = { element.line.start.x, element.line.start.y };
                 if (ImGui::DragFloat2("Start", start, 1.0f)) {
                     element.line.start = Point2D(start[0], start[1]);
-                    UpdateTextFromSVG();
+                    element.MarkModified();
+                    SyncElementToText(_selectedElementIndex);
                     UpdateRender();
                 }
                 float end[2] = { element.line.end.x, element.line.end.y };
                 if (ImGui::DragFloat2("End", end, 1.0f)) {
                     element.line.end = Point2D(end[0], end[1]);
-                    UpdateTextFromSVG();
+                    element.MarkModified();
+                    SyncElementToText(_selectedElementIndex);
                     UpdateRender();
                 }
                 break;
@@ -490,14 +615,21 @@ namespace VCX::Labs::SVG {
             }
         }
         if (changed) {
-            UpdateTextFromSVG();
+            SyncElementToText(_selectedElementIndex);
             UpdateRender();
         }
 
+        if (element.version != versionBefore || element.styleVersion != styleVersionBefore ||
+            element.contentOffset.x != offsetBefore.x || element.contentOffset.y != offsetBefore.y ||
+            element.transform.matrix != transformBefore) {
+            UpdateElementBounds(_selectedElementIndex);
+        }
+
         ImGui::Separator();
         if (ImGui::Button("Delete Element", ImVec2(-1, 0))) {
             _svgDocument.elements.erase(_svgDocument.elements.begin() + _selectedElementIndex);
             _selectedElementIndex = -1;
+            UpdateElementBounds();
             UpdateTextFromSVG();
             UpdateRender();
         }
@@ -509,6 +641,44 @@ namespace VCX::Labs::SVG {
         ImGui::Text("Elements: %zu", _svgDocument.elements.size());
         ImGui::Separator();
 
+        // 耗时排行（来自上一帧的逐元素统计）
+        if (_useV2Renderer && _costHeatmap) {
+            std::vector<RenderStats::ElementCost> costs = _svgRendererV2.GetLastStats().elementCosts;
+            size_t count = std::min(costs.size(), static_cast<size_t>(std::max(_costTopN, 0)));
+            std::partial_sort(costs.begin(), costs.begin() + count, costs.end(),
+                              [](const auto& a, const auto& b) { return a.ms > b.ms; });
+
+            ImGui::Text("Most expensive:");
+            ImGui::SliderInt("Top N", &_costTopN, 1, 50);
+            for (size_t k = 0; k < count; ++k) {
+                const auto& cost = costs[k];
+                int index = -1;
+                for (size_t i = 0; i < _svgDocument.elements.size(); ++i) {
+                    if (_svgDocument.elements[i].uid == cost.element) {
+                        index = static_cast<int>(i);
+                        break;
+                    }
+                }
+                if (index < 0) continue;
+
+                const auto& elem = _svgDocument.elements[index];
+                std::string name = elem.id.empty() ?
+                    (elem.type == SVGElement::Type::Path ? "Path" :
+                     elem.type == SVGElement::Type::Rect ? "Rect" :
+                     elem.type == SVGElement::Type::Circle ? "Circle" : "Element") : elem.id;
+                char label[256];
+                std::snprintf(label, sizeof(label), "%-12.12s %7.3f ms  %6llu edges  %8llu px##cost%zu",
+                              name.c_str(), cost.ms,
+                              static_cast<unsigned long long>(cost.edges),
+                              static_cast<unsigned long long>(cost.pixels), k);
+                if (ImGui::Selectable(label, _selectedElementIndex == index)) {
+                    _selectedElementIndex = index;
+                    UpdateRender();
+                }
+            }
+            ImGui::Separator();
+        }
+
         ImGui::BeginChild("LayersList");
         for (size_t i = 0; i < _svgDocument.elements.size(); ++i) {
             const auto& elem = _svgDocument.elements[i];
@@ -603,6 +773,7 @@ namespace VCX::Labs::SVG {
             if (_selectedElementIndex >= 0 && _selectedElementIndex < _svgDocument.elements.size()) {
                 _svgDocument.elements.erase(_svgDocument.elements.begin() + _selectedElementIndex);
                 _selectedElementIndex = -1;
+                UpdateElementBounds();
                 UpdateTextFromSVG();
                 UpdateRender();
             }
@@ -743,9 +914,9 @@ namespace VCX::Labs::SVG {
             _isDragging = false;
             _draggedControlPointIndex = -1;
             
-            // 同步到文本
+            // 同步到文本（拖拽只改动选中的元素）
             if (_autoSyncText) {
-                UpdateTextFromSVG();
+                SyncElementToText(_selectedElementIndex);
             }
         }
     }
@@ -764,16 +935,20 @@ namespace VCX::Labs::SVG {
             file.close();
         }
 
-        if (_svgParser.ParseFile(fullPathStr, _svgDocument)) {
+        // 大文件的路径数据按渲染线程数并行解析
+        _svgParser.SetThreadCount(static_cast<unsigned>(_renderThreads));
+        auto parseStart = std::chrono::steady_clock::now();
+        bool parsed = _svgParser.ParseFile(fullPathStr, _svgDocument);
+        _parseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - parseStart).count();
+        if (parsed) {
             _fileLoaded = true;
             _recompute = true;
             
-            // 更新文本编辑器内容
+            // 更新文本编辑器内容；文档来自文件（可能是缓存），第一次编辑时再建立源映射
             if (!_svgTextContent.empty()) {
-                std::size_t n = std::min(_svgTextContent.size(), sizeof(_svgTextBuffer) - 1);
-                std::memcpy(_svgTextBuffer, _svgTextContent.data(), n);
-                _svgTextBuffer[n] = '\0';
+                _svgTextBuffer = _svgTextContent;
             }
+            InvalidateSourceMap();
             
             std::cout << "SVG file loaded successfully: " << fullPathStr << std::endl;
             std::cout << "Elements found: " << _svgDocument.elements.size() << std::endl;
@@ -794,7 +969,7 @@ namespace VCX::Labs::SVG {
         
         std::ofstream file(fullPath, std::ios::out | std::ios::trunc);
         if (file.is_open()) {
-            std::string content = _svgTextBuffer;
+            const std::string& content = _svgTextBuffer;
             file << content;
             file.flush();
             file.close();
@@ -843,6 +1018,8 @@ namespace VCX::Labs::SVG {
             bgElement.rect.height = _svgDocument.height;
             bgElement.rect.style.fillColor = glm::vec4(_backgroundColor.x, _backgroundColor.y, _backgroundColor.z, _backgroundColor.w);
             bgElement.rect.style.strokeWidth = 0.0f;
+            bgElement.MarkModified();
+            bgElement.MarkStyleModified();
         } else {
             SVGElement bgElement(SVGElement::Type::Rect);
             new (&bgElement.rect) SVGRect();
@@ -914,7 +1091,7 @@ namespace VCX::Labs::SVG {
         _svgDocument.elements.push_back(std::move(newElement));
         _selectedElementIndex = _svgDocument.elements.size() - 1;
         
-        UpdateElementBounds();
+        UpdateElementBounds(_selectedElementIndex);
         UpdateTextFromSVG();
         UpdateRender();
         
@@ -935,101 +1112,124 @@ namespace VCX::Labs::SVG {
     }
 
     void CaseSVGRender::UpdateElementBounds() {
-        _elementBounds.clear();
-        
         UpdateViewBoxTransform();
-        
+
+        // 删除/重载会改变下标，整体重建拾取网格
+        _hitGrid.Clear();
+        _elementBounds.assign(_svgDocument.elements.size(), ElementBounds());
         for (size_t i = 0; i < _svgDocument.elements.size(); i++) {
-            const auto& element = _svgDocument.elements[i];
-            ElementBounds bounds;
-            bounds.elementIndex = static_cast<int>(i);
-            bounds.id = element.id;
-            
-            float svgMinX, svgMinY, svgMaxX, svgMaxY;
-            
-            switch (element.type) {
-                case SVGElement::Type::Circle: {
-                    Point2D center = element.circle.transform.TransformPoint(element.circle.center);
-                    float r = element.circle.radius;
-                    svgMinX = center.x - r;
-                    svgMinY = center.y - r;
-                    svgMaxX = center.x + r;
-                    svgMaxY = center.y + r;
-                    bounds.tagName = "circle";
-                    break;
-                }
-                case SVGElement::Type::Rect: {
-                    Point2D pos = element.rect.transform.TransformPoint(element.rect.position);
-                    svgMinX = pos.x;
-                    svgMinY = pos.y;
-                    svgMaxX = pos.x + element.rect.width;
-                    svgMaxY = pos.y + element.rect.height;
-                    bounds.tagName = "rect";
-                    break;
-                }
-                case SVGElement::Type::Line: {
-                    Point2D start = element.line.transform.TransformPoint(element.line.start);
-                    Point2D end = element.line.transform.TransformPoint(element.line.end);
-                    svgMinX = std::min(start.x, end.x);
-                    svgMinY = std::min(start.y, end.y);
-                    svgMaxX = std::max(start.x, end.x);
-                    svgMaxY = std::max(start.y, end.y);
-                    bounds.tagName = "line";
-                    break;
-                }
-                case SVGElement::Type::Path: {
-                    auto vertices = element.path.GetVertices();
-                    if (!vertices.empty()) {
-                        svgMinX = svgMaxX = vertices[0].x;
-                        svgMinY = svgMaxY = vertices[0].y;
-                        for (const auto& v : vertices) {
-                            Point2D transformed = element.transform.TransformPoint(v);
-                            svgMinX = std::min(svgMinX, transformed.x);
-                            svgMinY = std::min(svgMinY, transformed.y);
-                            svgMaxX = std::max(svgMaxX, transformed.x);
-                            svgMaxY = std::max(svgMaxY, transformed.y);
-                        }
-                    } else {
-                        svgMinX = svgMinY = svgMaxX = svgMaxY = 0;
+            UpdateElementBounds(static_cast<int>(i));
+        }
+    }
+
+    // 只更新一个元素的包围盒与拾取网格（拖拽/改属性时调用）
+    void CaseSVGRender::UpdateElementBounds(int index) {
+        if (index < 0 || index >= (int)_svgDocument.elements.size()) return;
+        if (index >= (int)_elementBounds.size()) _elementBounds.resize(_svgDocument.elements.size());
+
+        const auto& element = _svgDocument.elements[index];
+        ElementBounds bounds;
+        bounds.elementIndex = index;
+        bounds.id = element.id;
+        
+        float svgMinX, svgMinY, svgMaxX, svgMaxY;
+        
+        switch (element.type) {
+            case SVGElement::Type::Circle: {
+                Point2D center = element.circle.transform.TransformPoint(element.circle.center);
+                float r = element.circle.radius;
+                svgMinX = center.x - r;
+                svgMinY = center.y - r;
+                svgMaxX = center.x + r;
+                svgMaxY = center.y + r;
+                bounds.tagName = "circle";
+                break;
+            }
+            case SVGElement::Type::Rect: {
+                Point2D pos = element.rect.transform.TransformPoint(element.rect.position);
+                svgMinX = pos.x;
+                svgMinY = pos.y;
+                svgMaxX = pos.x + element.rect.width;
+                svgMaxY = pos.y + element.rect.height;
+                bounds.tagName = "rect";
+                break;
+            }
+            case SVGElement::Type::Line: {
+                Point2D start = element.line.transform.TransformPoint(element.line.start);
+                Point2D end = element.line.transform.TransformPoint(element.line.end);
+                svgMinX = std::min(start.x, end.x);
+                svgMinY = std::min(start.y, end.y);
+                svgMaxX = std::max(start.x, end.x);
+                svgMaxY = std::max(start.y, end.y);
+                bounds.tagName = "line";
+                break;
+            }
+            case SVGElement::Type::Path: {
+                auto vertices = element.path.GetVertices();
+                if (!vertices.empty()) {
+                    svgMinX = svgMaxX = vertices[0].x;
+                    svgMinY = svgMaxY = vertices[0].y;
+                    for (const auto& v : vertices) {
+                        Point2D transformed = element.transform.TransformPoint(v);
+                        svgMinX = std::min(svgMinX, transformed.x);
+                        svgMinY = std::min(svgMinY, transformed.y);
+                        svgMaxX = std::max(svgMaxX, transformed.x);
+                        svgMaxY = std::max(svgMaxY, transformed.y);
                     }
-                    bounds.tagName = "path";
-                    break;
-                }
-                case SVGElement::Type::Ellipse: {
-                    Point2D center = element.ellipse.transform.TransformPoint(element.ellipse.center);
-                    svgMinX = center.x - element.ellipse.rx;
-                    svgMinY = center.y - element.ellipse.ry;
-                    svgMaxX = center.x + element.ellipse.rx;
-                    svgMaxY = center.y + element.ellipse.ry;
-                    bounds.tagName = "ellipse";
-                    break;
+                } else {
+                    svgMinX = svgMinY = svgMaxX = svgMaxY = 0;
                 }
-                case SVGElement::Type::Text: {
-                    Point2D pos = element.text.transform.TransformPoint(element.text.position);
-                    float w = element.text.text.length() * element.text.fontSize * 0.6f;
-                    float h = element.text.fontSize;
-                    svgMinX = pos.x;
-                    svgMinY = pos.y;
-                    svgMaxX = pos.x + w;
-                    svgMaxY = pos.y + h;
-                    bounds.tagName = "text";
-                    break;
-                }
-                default:
-                    continue;
+                bounds.tagName = "path";
+                break;
             }
-            
-            // 将 SVG 坐标转换为屏幕/渲染坐标
-            Point2D screenMin = SVGToScreen(Point2D(svgMinX, svgMinY));
-            Point2D screenMax = SVGToScreen(Point2D(svgMaxX, svgMaxY));
-            
-            bounds.minX = std::min(screenMin.x, screenMax.x);
-            bounds.minY = std::min(screenMin.y, screenMax.y);
-            bounds.maxX = std::max(screenMin.x, screenMax.x);
-            bounds.maxY = std::max(screenMin.y, screenMax.y);
-            
-            _elementBounds.push_back(bounds);
+            case SVGElement::Type::Ellipse: {
+                Point2D center = element.ellipse.transform.TransformPoint(element.ellipse.center);
+                svgMinX = center.x - element.ellipse.rx;
+                svgMinY = center.y - element.ellipse.ry;
+                svgMaxX = center.x + element.ellipse.rx;
+                svgMaxY = center.y + element.ellipse.ry;
+                bounds.tagName = "ellipse";
+                break;
+            }
+            case SVGElement::Type::Text: {
+                Point2D pos = element.text.transform.TransformPoint(element.text.position);
+                float w = element.text.text.length() * element.text.fontSize * 0.6f;
+                float h = element.text.fontSize;
+                svgMinX = pos.x;
+                svgMinY = pos.y;
+                svgMaxX = pos.x + w;
+                svgMaxY = pos.y + h;
+                bounds.tagName = "text";
+                break;
+            }
+            default:
+                // 组不参与拾取，保留空条目使下标与元素对齐
+                bounds.tagName = "g";
+                _elementBounds[index] = bounds;
+                _hitGrid.Remove(static_cast<std::uint32_t>(index));
+                return;
         }
+        
+        // 将 SVG 坐标转换为屏幕/渲染坐标
+        Point2D screenMin = SVGToScreen(Point2D(svgMinX, svgMinY));
+        Point2D screenMax = SVGToScreen(Point2D(svgMaxX, svgMaxY));
+        
+        bounds.minX = std::min(screenMin.x, screenMax.x);
+        bounds.minY = std::min(screenMin.y, screenMax.y);
+        bounds.maxX = std::max(screenMin.x, screenMax.x);
+        bounds.maxY = std::max(screenMin.y, screenMax.y);
+        
+        _elementBounds[index] = bounds;
+
+        // 拾取网格用精确的设备空间包围盒（含描边和容差）
+        _hitGrid.Insert(static_cast<std::uint32_t>(index),
+                        _hitTester.Bounds(element, GetHitTransform(element), c_HitTolerance));
+    }
+
+    // SVG 视图变换 * 元素变换（形状自身的变换由 ShapeHitTester 叠加）
+    Matrix3x3 CaseSVGRender::GetHitTransform(const SVGElement& element) const {
+        return Matrix3x3::Translation(_vbOffsetX, _vbOffsetY) * Matrix3x3::Scale(_vbScaleX, _vbScaleY) *
+               Matrix3x3::FromGlm(element.transform.matrix);
     }
 
     // 更新 viewBox 变换参数
@@ -1068,17 +1268,54 @@ namespace VCX::Labs::SVG {
     }
 
     int CaseSVGRender::FindElementAtPosition(float x, float y) {
-        // 从后往前遍历（后绘制的元素在上层）
-        for (int i = static_cast<int>(_elementBounds.size()) - 1; i >= 0; i--) {
-            const auto& bounds = _elementBounds[i];
-            if (x >= bounds.minX && x <= bounds.maxX && 
-                y >= bounds.minY && y <= bounds.maxY) {
-                return i;
+        // 网格给出包围盒命中的候选，再按绘制顺序从上往下做精确测试
+        Vec2 point(x, y);
+        _hitGrid.QueryPoint(point, _hitCandidates);
+        std::sort(_hitCandidates.begin(), _hitCandidates.end(), std::greater<std::uint32_t>());
+        for (std::uint32_t index : _hitCandidates) {
+            if (index >= _svgDocument.elements.size()) continue;
+            const auto& element = _svgDocument.elements[index];
+            if (_hitTester.Hit(element, GetHitTransform(element), point, c_HitTolerance)) {
+                return static_cast<int>(index);
             }
         }
         return -1;
     }
 
+    void CaseSVGRender::DrawCostHeatmap(Common::ImageRGB& image) {
+        const auto& costs = _svgRendererV2.GetLastStats().elementCosts;
+        double maxMs = 0;
+        for (const auto& cost : costs) maxMs = std::max(maxMs, cost.ms);
+        if (maxMs <= 0) return;
+
+        // 便宜的先画，贵的元素叠在上面保持可见
+        std::vector<const RenderStats::ElementCost*> order;
+        order.reserve(costs.size());
+        for (const auto& cost : costs) {
+            if (!cost.bounds.IsEmpty()) order.push_back(&cost);
+        }
+        std::sort(order.begin(), order.end(), [](auto a, auto b) { return a->ms < b->ms; });
+
+        int width = static_cast<int>(image.GetSizeX());
+        int height = static_cast<int>(image.GetSizeY());
+        for (const auto* cost : order) {
+            float heat = static_cast<float>(cost->ms / maxMs);
+            glm::vec3 color(heat, 0.2f * (1.0f - heat), 1.0f - heat);   // 蓝 -> 红
+            float alpha = 0.15f + 0.45f * heat;
+
+            int x0 = std::max(0, static_cast<int>(std::floor(cost->bounds.min.x)));
+            int y0 = std::max(0, static_cast<int>(std::floor(cost->bounds.min.y)));
+            int x1 = std::min(width - 1, static_cast<int>(std::ceil(cost->bounds.max.x)));
+            int y1 = std::min(height - 1, static_cast<int>(std::ceil(cost->bounds.max.y)));
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    glm::vec3 old = image.At(x, y);
+                    image.At(x, y) = old * (1.0f - alpha) + color * alpha;
+                }
+            }
+        }
+    }
+
     void CaseSVGRender::RenderWithHighlight(int highlightIndex) {
         // Choose renderer based on settings
         if (_useV2Renderer) {
@@ -1087,6 +1324,10 @@ namespace VCX::Labs::SVG {
                                                         _backgroundColor.z, _backgroundColor.w));
             _svgRendererV2.SetAntiAliasing(_enableAntiAliasing);
             _svgRendererV2.SetFlatnessTolerance(_flatnessTolerance);
+            _svgRendererV2.SetThreadCount(static_cast<unsigned>(_renderThreads));
+            // 热力图要的是每个元素的完整代价：关闭几何缓存与增量重绘
+            _svgRendererV2.SetGeometryCacheEnabled(_geometryCache && !_costHeatmap);
+            _svgRendererV2.SetStatsEnabled(_renderStats || _costHeatmap, _renderStats, _costHeatmap);
             
             // Set AA mode
             ScanlineRasterizer::AAMode aaMode = ScanlineRasterizer::AAMode::Coverage4x;
@@ -1096,10 +1337,31 @@ namespace VCX::Labs::SVG {
                 case 2: aaMode = ScanlineRasterizer::AAMode::Coverage8x; break;
                 case 3: aaMode = ScanlineRasterizer::AAMode::Coverage16x; break;
                 case 4: aaMode = ScanlineRasterizer::AAMode::Analytical; break;
+                case 5: aaMode = ScanlineRasterizer::AAMode::AccumulatedArea; break;
             }
             _svgRendererV2.SetAAMode(aaMode);
             
-            _image = _svgRendererV2.RenderSVG(_svgDocument, _renderWidth, _renderHeight);
+            if (_geometryCache && _incrementalRender && !_costHeatmap) {
+                // 增量渲染：只重绘发生变化的元素所覆盖的区域
+                int width = static_cast<int>(_renderWidth);
+                int height = static_cast<int>(_renderHeight);
+                if (_renderTarget.GetWidth() != width || _renderTarget.GetHeight() != height) {
+                    _renderTarget.Resize(width, height);
+                }
+                _lastDamage = _svgRendererV2.RenderIncremental(_svgDocument, _renderTarget);
+                if (_documentImage.GetSizeX() != _renderWidth || _documentImage.GetSizeY() != _renderHeight) {
+                    _documentImage = _renderTarget.ToImageRGB();
+                } else {
+                    _renderTarget.CopyToImageRGB(_documentImage, _lastDamage);
+                }
+                _image = _documentImage;
+            } else {
+                _svgRendererV2.InvalidateIncremental();
+                _image = _svgRendererV2.RenderSVG(_svgDocument, _renderWidth, _renderHeight);
+            }
+            if (_costHeatmap) {
+                DrawCostHeatmap(_image);
+            }
         } else {
             // Use original renderer
             _image = _svgRenderer.RenderSVG(_svgDocument, _renderWidth, _renderHeight);
@@ -1192,11 +1454,23 @@ namespace VCX::Labs::SVG {
 
     void CaseSVGRender::UpdateSVGFromText() {
         // 从文本编辑器更新SVG
-        std::string newContent(_svgTextBuffer);
+        const std::string& newContent = _svgTextBuffer;
         
         if (!newContent.empty()) {
+            // 修改只落在某个元素的标签内时，只重新解析这个元素
+            auto parseStart = std::chrono::steady_clock::now();
+            if (UpdateElementFromText(newContent)) {
+                _parseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - parseStart).count();
+                _svgTextContent = newContent;
+                return;
+            }
+
             SVGDocument newDocument;
-            if (_svgParser.ParseString(newContent, newDocument)) {
+            SVGSourceMap newSourceMap;
+            _svgParser.SetThreadCount(static_cast<unsigned>(_renderThreads));
+            bool parsed = _svgParser.ParseString(newContent, newDocument, newSourceMap);
+            _parseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - parseStart).count();
+            if (parsed) {
                 // 保存新文档的属性（在move之前）
                 float newWidth = newDocument.width;
                 float newHeight = newDocument.height;
@@ -1206,6 +1480,9 @@ namespace VCX::Labs::SVG {
                 // 移动文档数据
                 _svgDocument = std::move(newDocument);
                 _svgTextContent = newContent;
+                _sourceMap = std::move(newSourceMap);
+                _sourceText = newContent;
+                RecordSourceStamps();
                 
                 // 输出解析信息到控制台
                 std::cout << "\n========== SVG Parse Result ==========" << std::endl;
@@ -1322,205 +1599,102 @@ namespace VCX::Labs::SVG {
         }
     }
 
-    void CaseSVGRender::UpdateTextFromSVG() {
-        // 从SVG文档更新文本编辑器
-        std::string svgString = GenerateSVGString();
-        
-        std::size_t n = std::min(svgString.size(), sizeof(_svgTextBuffer) - 1);
-        std::memcpy(_svgTextBuffer, svgString.data(), n);
-        _svgTextBuffer[n] = '\0';
-        _svgTextContent = svgString;
+    bool CaseSVGRender::UpdateElementFromText(const std::string& text) {
+        // 源映射只在文本和文档都没被别处改过时有效
+        if (!SourceMapCurrent()) return false;
+
+        // 修改范围：去掉与上次文本相同的前缀和后缀
+        const std::string& oldText = _sourceText;
+        std::size_t common = std::min(oldText.size(), text.size());
+        std::size_t prefix = std::mismatch(oldText.begin(), oldText.begin() + common, text.begin()).first - oldText.begin();
+        std::size_t suffix = std::mismatch(oldText.rbegin(), oldText.rbegin() + (common - prefix), text.rbegin()).first - oldText.rbegin();
+
+        int index = _sourceMap.FindEnclosing(prefix, oldText.size() - suffix);
+        if (index < 0 || index >= static_cast<int>(_svgDocument.elements.size())) return false;
+
+        const SVGSourceMap::Span& span = _sourceMap.spans[index];
+        std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(text.size()) - static_cast<std::ptrdiff_t>(oldText.size());
+        std::string_view markup = std::string_view(text).substr(span.begin, span.end - span.begin + delta);
+        SVGElement element(SVGElement::Type::Path);
+        if (!_svgParser.ParseElement(markup, _sourceMap.groups[span.group], element)) return false;
+
+        // 沿用原元素的 uid，版本递增：渲染缓存只重建这个元素，增量渲染只重绘它覆盖的区域
+        SVGElement& target = _svgDocument.elements[index];
+        element.uid = target.uid;
+        element.version = target.version + 1;
+        element.styleVersion = target.styleVersion + 1;
+        element.contentOffset = target.contentOffset;
+        target = std::move(element);
+
+        _sourceMap.Resize(index, delta);
+        _sourceText.replace(prefix, oldText.size() - suffix - prefix, text, prefix, text.size() - suffix - prefix);
+        _sourceStamps[index] = ElementStamp(target);
+
+        UpdateElementBounds(index);
+        UpdateControlPoints();
+        return true;
     }
 
-    std::string CaseSVGRender::GenerateSVGString() {
-        std::ostringstream oss;
-        
-        oss << "<svg width=\"" << _svgDocument.width << "\" height=\"" << _svgDocument.height << "\"";
-        if (!_svgDocument.viewBox.empty()) {
-            oss << " viewBox=\"" << _svgDocument.viewBox << "\"";
+    std::uint64_t CaseSVGRender::ElementStamp(const SVGElement& element) {
+        // 编辑器对元素的修改都会改变 uid、version、styleVersion 或 contentOffset
+        std::uint64_t stamp = element.uid;
+        auto mix = [&stamp](std::uint64_t value) {
+            stamp = (stamp ^ value) * 0x100000001b3ull;
+        };
+        mix((std::uint64_t(element.version) << 32) | element.styleVersion);
+        mix(std::bit_cast<std::uint32_t>(element.contentOffset.x));
+        mix(std::bit_cast<std::uint32_t>(element.contentOffset.y));
+        return stamp;
+    }
+
+    bool CaseSVGRender::SourceMapCurrent(int except) const {
+        const auto& elements = _svgDocument.elements;
+        if (_sourceText.empty() || _sourceMap.spans.size() != elements.size() || _sourceStamps.size() != elements.size()) {
+            return false;
         }
-        oss << " xmlns=\"http://www.w3.org/2000/svg\">\n";
-        
-        for (const auto& elem : _svgDocument.elements) {
-            oss << "  ";
-            
-            switch (elem.type) {
-                case SVGElement::Type::Rect: {
-                    oss << "<rect";
-                    if (!elem.rect.id.empty()) oss << " id=\"" << elem.rect.id << "\"";
-                    oss << " x=\"" << elem.rect.position.x << "\"";
-                    oss << " y=\"" << elem.rect.position.y << "\"";
-                    oss << " width=\"" << elem.rect.width << "\"";
-                    oss << " height=\"" << elem.rect.height << "\"";
-                    if (elem.rect.style.fillColor) {
-                        auto c = *elem.rect.style.fillColor;
-                        oss << " fill=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.rect.style.strokeColor) {
-                        auto c = *elem.rect.style.strokeColor;
-                        oss << " stroke=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.rect.style.strokeWidth) {
-                        oss << " stroke-width=\"" << *elem.rect.style.strokeWidth << "\"";
-                    }
-                    oss << "/>\n";
-                    break;
-                }
-                
-                case SVGElement::Type::Circle: {
-                    oss << "<circle";
-                    if (!elem.circle.id.empty()) oss << " id=\"" << elem.circle.id << "\"";
-                    oss << " cx=\"" << elem.circle.center.x << "\"";
-                    oss << " cy=\"" << elem.circle.center.y << "\"";
-                    oss << " r=\"" << elem.circle.radius << "\"";
-                    if (elem.circle.style.fillColor) {
-                        auto c = *elem.circle.style.fillColor;
-                        oss << " fill=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.circle.style.strokeColor) {
-                        auto c = *elem.circle.style.strokeColor;
-                        oss << " stroke=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.circle.style.strokeWidth) {
-                        oss << " stroke-width=\"" << *elem.circle.style.strokeWidth << "\"";
-                    }
-                    oss << "/>\n";
-                    break;
-                }
-                
-                case SVGElement::Type::Line: {
-                    oss << "<line";
-                    if (!elem.line.id.empty()) oss << " id=\"" << elem.line.id << "\"";
-                    oss << " x1=\"" << elem.line.start.x << "\"";
-                    oss << " y1=\"" << elem.line.start.y << "\"";
-                    oss << " x2=\"" << elem.line.end.x << "\"";
-                    oss << " y2=\"" << elem.line.end.y << "\"";
-                    if (elem.line.style.strokeColor) {
-                        auto c = *elem.line.style.strokeColor;
-                        oss << " stroke=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.line.style.strokeWidth) {
-                        oss << " stroke-width=\"" << *elem.line.style.strokeWidth << "\"";
-                    }
-                    oss << "/>\n";
-                    break;
-                }
-                
-                case SVGElement::Type::Path: {
-                    oss << "<path";
-                    if (!elem.path.id.empty()) oss << " id=\"" << elem.path.id << "\"";
-                    oss << " d=\"";
-                    
-                    Point2D currentPos(0, 0);
-                    for (const auto& cmd : elem.path.commands) {
-                        switch (cmd.type) {
-                            case PathCommandType::MoveTo:
-                                oss << "M " << cmd.points[0].x << " " << cmd.points[0].y << " ";
-                                currentPos = cmd.points[0];
-                                break;
-                            case PathCommandType::LineTo:
-                                oss << "L " << cmd.points[0].x << " " << cmd.points[0].y << " ";
-                                currentPos = cmd.points[0];
-                                break;
-                            case PathCommandType::CurveTo:
-                                if (cmd.points.size() >= 3) {
-                                    oss << "C " << cmd.points[0].x << " " << cmd.points[0].y << " ";
-                                    oss << cmd.points[1].x << " " << cmd.points[1].y << " ";
-                                    oss << cmd.points[2].x << " " << cmd.points[2].y << " ";
-                                    currentPos = cmd.points[2];
-                                }
-                                break;
-                            case PathCommandType::QuadCurveTo:
-                                if (cmd.points.size() >= 2) {
-                                    oss << "Q " << cmd.points[0].x << " " << cmd.points[0].y << " ";
-                                    oss << cmd.points[1].x << " " << cmd.points[1].y << " ";
-                                    currentPos = cmd.points[1];
-                                }
-                                break;
-                            case PathCommandType::ClosePath:
-                                oss << "Z ";
-                                break;
-                            default:
-                                break;
-                        }
-                    }
-                    
-                    oss << "\"";
-                    if (elem.path.style.fillNone) {
-                        oss << " fill=\"none\"";
-                    } else if (elem.path.style.fillColor) {
-                        auto c = *elem.path.style.fillColor;
-                        oss << " fill=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.path.style.strokeColor) {
-                        auto c = *elem.path.style.strokeColor;
-                        oss << " stroke=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.path.style.strokeWidth) {
-                        oss << " stroke-width=\"" << *elem.path.style.strokeWidth << "\"";
-                    }
-                    oss << "/>\n";
-                    break;
-                }
-                
-                case SVGElement::Type::Ellipse: {
-                    oss << "<ellipse";
-                    if (!elem.ellipse.id.empty()) oss << " id=\"" << elem.ellipse.id << "\"";
-                    oss << " cx=\"" << elem.ellipse.center.x << "\"";
-                    oss << " cy=\"" << elem.ellipse.center.y << "\"";
-                    oss << " rx=\"" << elem.ellipse.rx << "\"";
-                    oss << " ry=\"" << elem.ellipse.ry << "\"";
-                    if (elem.ellipse.style.fillColor) {
-                        auto c = *elem.ellipse.style.fillColor;
-                        oss << " fill=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.ellipse.style.strokeColor) {
-                        auto c = *elem.ellipse.style.strokeColor;
-                        oss << " stroke=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.ellipse.style.strokeWidth) {
-                        oss << " stroke-width=\"" << *elem.ellipse.style.strokeWidth << "\"";
-                    }
-                    oss << "/>\n";
-                    break;
-                }
-                
-                case SVGElement::Type::Text: {
-                    oss << "<text";
-                    if (!elem.text.id.empty()) oss << " id=\"" << elem.text.id << "\"";
-                    oss << " x=\"" << elem.text.position.x << "\"";
-                    oss << " y=\"" << elem.text.position.y << "\"";
-                    if (elem.text.fontSize > 0) {
-                        oss << " font-size=\"" << elem.text.fontSize << "\"";
-                    }
-                    if (!elem.text.fontFamily.empty()) {
-                        oss << " font-family=\"" << elem.text.fontFamily << "\"";
-                    }
-                    if (elem.text.style.fillColor) {
-                        auto c = *elem.text.style.fillColor;
-                        oss << " fill=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.text.style.strokeColor) {
-                        auto c = *elem.text.style.strokeColor;
-                        oss << " stroke=\"rgb(" << (int)(c.r*255) << "," << (int)(c.g*255) << "," << (int)(c.b*255) << ")\"";
-                    }
-                    if (elem.text.style.strokeWidth) {
-                        oss << " stroke-width=\"" << *elem.text.style.strokeWidth << "\"";
-                    }
-                    oss << ">" << elem.text.text << "</text>\n";
-                    break;
-                }
-                
-                case SVGElement::Type::Group:
-                    break;
-                
-                default:
-                    break;
+        for (size_t i = 0; i < elements.size(); ++i) {
+            if (static_cast<int>(i) != except && _sourceStamps[i] != ElementStamp(elements[i])) return false;
+        }
+        return true;
+    }
+
+    void CaseSVGRender::RecordSourceStamps() {
+        _sourceStamps.resize(_svgDocument.elements.size());
+        for (size_t i = 0; i < _svgDocument.elements.size(); ++i) {
+            _sourceStamps[i] = ElementStamp(_svgDocument.elements[i]);
+        }
+    }
+
+    void CaseSVGRender::InvalidateSourceMap() {
+        _sourceMap.Clear();
+        _sourceText.clear();
+        _sourceStamps.clear();
+    }
+
+    void CaseSVGRender::UpdateTextFromSVG() {
+        // 从SVG文档更新文本编辑器；写出时记下各元素的范围，之后可以只改写单个元素
+        bool mapped = _svgWriter.WriteDocument(_svgDocument, _sourceText, &_sourceMap);
+        _svgTextBuffer = _sourceText;
+        _svgTextContent = _sourceText;
+        if (mapped) RecordSourceStamps();
+        else InvalidateSourceMap();
+    }
+
+    void CaseSVGRender::SyncElementToText(int elementIndex) {
+        // 其他元素也改过、或编辑器里有未应用的修改时，源映射不再对应，整体重写
+        if (elementIndex >= 0 && elementIndex < static_cast<int>(_svgDocument.elements.size()) &&
+            SourceMapCurrent(elementIndex) && _svgTextBuffer == _sourceText) {
+            const SVGElement& element = _svgDocument.elements[elementIndex];
+            const SVGSourceMap::Span span = _sourceMap.spans[elementIndex];
+            if (_svgWriter.SpliceElement(element, elementIndex, _sourceText, _sourceMap)) {
+                std::size_t length = _sourceMap.spans[elementIndex].end - span.begin;
+                _svgTextBuffer.replace(span.begin, span.end - span.begin, _sourceText, span.begin, length);
+                _svgTextContent = _svgTextBuffer;
+                _sourceStamps[elementIndex] = ElementStamp(element);
+                return;
             }
         }
-        
-        oss << "</svg>";
-        return oss.str();
+        UpdateTextFromSVG();
     }
 
     void CaseSVGRender::UpdateControlPoints() {
@@ -1673,6 +1847,24 @@ namespace VCX::Labs::SVG {
         if (elementIndex < 0 || elementIndex >= _svgDocument.elements.size()) return;
         
         auto& elem = _svgDocument.elements[elementIndex];
+
+        // 元素的参考点，移动前后之差即平移量（供渲染器复用缓存的几何）
+        auto anchorOf = [](const SVGElement& e) -> Point2D {
+            switch (e.type) {
+                case SVGElement::Type::Rect:    return e.rect.position;
+                case SVGElement::Type::Circle:  return e.circle.center;
+                case SVGElement::Type::Ellipse: return e.ellipse.center;
+                case SVGElement::Type::Line:    return e.line.start;
+                case SVGElement::Type::Text:    return e.text.position;
+                case SVGElement::Type::Path:
+                    for (const auto& cmd : e.path.commands) {
+                        if (!cmd.points.empty()) return cmd.points[0];
+                    }
+                    return Point2D();
+                default:                        return Point2D();
+            }
+        };
+        Point2D anchorBefore = anchorOf(elem);
         
         switch (elem.type) {
             case SVGElement::Type::Rect:
@@ -1719,8 +1911,25 @@ namespace VCX::Labs::SVG {
             default:
                 break;
         }
+
+        // 相对命令和圆弧半径也被加上了偏移，这类路径不是纯平移
+        bool pureTranslation = true;
+        if (elem.type == SVGElement::Type::Path) {
+            for (const auto& cmd : elem.path.commands) {
+                if (cmd.relative || cmd.type == PathCommandType::ArcTo) {
+                    pureTranslation = false;
+                    break;
+                }
+            }
+        }
+        if (pureTranslation) {
+            Point2D anchorAfter = anchorOf(elem);
+            elem.MarkTranslated(anchorAfter.x - anchorBefore.x, anchorAfter.y - anchorBefore.y);
+        } else {
+            elem.MarkModified();
+        }
         
-        UpdateElementBounds();
+        UpdateElementBounds(elementIndex);
         UpdateControlPoints();
     }
 
@@ -1830,8 +2039,10 @@ namespace VCX::Labs::SVG {
                 elem.line.end.y = _originalPoints[1].y + dy;
             }
         }
+
+        elem.MarkModified();
         
-        UpdateElementBounds();
+        UpdateElementBounds(elementIndex);
         UpdateControlPoints();
     }
 
@@ -1853,8 +2064,10 @@ namespace VCX::Labs::SVG {
             cmd.points[pointIndex].x = x;
             cmd.points[pointIndex].y = y;
         }
+
+        elem.MarkModified();
         
-        UpdateElementBounds();
+        UpdateElementBounds(elementIndex);
         UpdateControlPoints();
     }
 
@@ -10,9 +10,12 @@
 #include "Engine/GL/Texture.hpp"
 #include "SVG.h"
 #include "SVGParser.h"
+#include "Document/SVGWriter.h"
 #include "SVGRenderer.h"
 #include "Renderer/SVGRendererV2.h"
 #include "Rasterizer/ScanlineRasterizer.h"
+#include "Core/SpatialGrid.h"
+#include "Geometry/ShapeHitTest.h"
 
 namespace VCX::Labs::SVG {
 
@@ -78,12 +81,16 @@ namespace VCX::Labs::SVG {
         std::string _projectRoot;  // 项目根目录
         SVGDocument _svgDocument;
         SVGParser _svgParser;
+        SVGWriter _svgWriter;
         SVGRenderer _svgRenderer;
         SVGRendererV2 _svgRendererV2;          // V2 高质量渲染器
         RendererV2Settings _v2Settings;        // V2 渲染器设置
 
         Engine::GL::UniqueTexture2D _texture;
         Common::ImageRGB _image;
+        RenderTarget _renderTarget;            // V2 增量渲染的文档画面（不含选择框等叠加层）
+        Common::ImageRGB _documentImage;       // _renderTarget 的 8 位副本，按脏矩形更新
+        PixelRect _lastDamage;                 // 上一帧重绘的区域
         bool _recompute = true;
         bool _fileLoaded = false;
 
@@ -92,7 +99,11 @@ namespace VCX::Labs::SVG {
 
         // 文本编辑器相关
         std::string _svgTextContent;
-        char _svgTextBuffer[65536];  // 64KB文本缓冲区
+        std::string _svgTextBuffer;  // 编辑器缓冲区，随输入增长
+        // 增量同步：_sourceText 是 _sourceMap 描述的文本，_sourceStamps 是当时各元素的戳
+        SVGSourceMap _sourceMap;
+        std::string _sourceText;
+        std::vector<std::uint64_t> _sourceStamps;
         bool _textEditorVisible = true;
         float _editorWidth = 400.0f;  // 编辑器宽度
 
@@ -101,7 +112,11 @@ namespace VCX::Labs::SVG {
         ToolType _currentTool = ToolType::Select;
         int _selectedElementIndex = -1;
         int _hoveredElementIndex = -1;
-        std::vector<ElementBounds> _elementBounds;
+        std::vector<ElementBounds> _elementBounds;     // 与 elements 按下标对齐
+        SpatialGrid _hitGrid;                           // 元素拾取包围盒（屏幕坐标）
+        ShapeHitTester _hitTester;
+        std::vector<std::uint32_t> _hitCandidates;
+        static constexpr float c_HitTolerance = 3.0f;   // 拾取容差（像素）
         std::vector<ControlPoint> _controlPoints;
         
         // 拖拽状态
@@ -127,14 +142,26 @@ namespace VCX::Labs::SVG {
         // V2渲染器设置
         bool _useV2Renderer = false;       // 是否使用V2渲染器
         bool _enableAntiAliasing = true;   // 启用抗锯齿
-        int _aaMode = 1;                   // AA模式: 0=None, 1=4x, 2=8x, 3=16x, 4=Analytical
+        int _aaMode = 1;                   // AA模式: 0=None, 1=4x, 2=8x, 3=16x, 4=Analytical, 5=AccumulatedArea
         float _flatnessTolerance = 0.5f;   // 曲线细分容差
+        int _renderThreads = 1;            // 渲染线程数: 0=自动, 1=单线程, >1=分块并行
+        bool _geometryCache = true;        // 跨帧复用未变化元素的几何
+        bool _incrementalRender = true;    // 只重绘变化区域（脏矩形）
+        bool _renderStats = false;         // 统计每帧各阶段耗时与计数
+        double _parseMs = 0;               // 最近一次解析耗时（渲染器看不到解析）
+        bool _costHeatmap = false;         // 按渲染耗时给元素着色（整帧冷渲染，不用缓存）
+        int _costTopN = 10;                // 图层面板列出最耗时的元素个数
 
         // 辅助函数
         void LoadSVGFile();
         void SaveSVGFile();
         void UpdateSVGFromText();
         void UpdateTextFromSVG();
+        bool UpdateElementFromText(const std::string& text);  // 只重新解析被修改的元素
+        static std::uint64_t ElementStamp(const SVGElement& element);  // 元素内容的戳，判断源映射是否仍有效
+        bool SourceMapCurrent(int except = -1) const;         // 除 except 外各元素都与 _sourceText 一致
+        void RecordSourceStamps();
+        void InvalidateSourceMap();
         void UpdateRender();
         void ClearCanvas();
         void UpdateBackgroundInSVG();
@@ -191,11 +218,14 @@ namespace VCX::Labs::SVG {
 
     private:
         void UpdateElementBounds();
+        void UpdateElementBounds(int index);
+        Matrix3x3 GetHitTransform(const SVGElement& element) const;
         
         // 查找函数
         
         // 渲染函数
         void RenderWithHighlight(int highlightIndex);
+        void DrawCostHeatmap(Common::ImageRGB& image);
         void RenderControlPoints(Common::ImageRGB& image);
         void DrawControlPoint(Common::ImageRGB& image, const Point2D& pos, 
                              ControlPointType type, bool isHovered);
@@ -205,12 +235,11 @@ namespace VCX::Labs::SVG {
         void UpdateBezierControlPoint(int elementIndex, int commandIndex, 
                                      int pointIndex, float x, float y);
         
-        // SVG同步
+        // SVG同步：只改写这个元素的文本
         void SyncElementToText(int elementIndex);
         
         // 辅助函数
         bool IsPointNearLine(const Point2D& p, const Point2D& a, const Point2D& b, float threshold);
-        std::string GenerateSVGString();
     };
 
 }
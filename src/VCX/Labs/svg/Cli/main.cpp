@@ -0,0 +1,270 @@
+//=============================================================================
+// svgrender-cli - Headless batch renderer
+//
+// Renders SVG files to PNG with SVGRendererV2, without the engine/GL stack.
+// Prints one timing line per file; exits non-zero if any file failed.
+//=============================================================================
+
+#include "Labs/svg/SVGParser.h"
+#include "Labs/svg/Renderer/SVGRendererV2.h"
+
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace VCX::Labs;
+using namespace VCX::Labs::SVG;
+
+namespace {
+
+    struct CliOptions {
+        std::vector<fs::path> inputs;
+        fs::path output;                    // File (single input) or directory
+        int width = 0;                      // 0 = from the document
+        int height = 0;
+        ScanlineRasterizer::AAMode aaMode = ScanlineRasterizer::AAMode::Coverage4x;
+        bool enableAA = true;
+        float flatness = 0.5f;
+        unsigned threads = 1;
+        bool transparent = false;
+        bool documentCache = true;
+        bool quiet = false;
+    };
+
+    void PrintUsage() {
+        std::cout <<
+            "Usage: svgrender-cli [options] <input.svg | directory>...\n"
+            "\n"
+            "Options:\n"
+            "  -o, --output <path>     Output PNG (one input) or directory (default: next to input)\n"
+            "  -W, --width <px>        Output width (default: document width)\n"
+            "  -H, --height <px>       Output height (default: document height, or keep aspect)\n"
+            "  -a, --aa <mode>         none | 4x | 8x | 16x | analytical | area (default: 4x)\n"
+            "  -f, --flatness <tol>    Curve flattening tolerance in pixels (default: 0.5)\n"
+            "  -t, --threads <n>       Parse/render threads: 1 = single-threaded, 0 = one per core (default: 1)\n"
+            "      --transparent       Keep alpha instead of compositing over white\n"
+            "      --no-cache          Always parse; do not read or write <input>.cache\n"
+            "  -q, --quiet             Only print the summary\n"
+            "  -h, --help              Show this help\n";
+    }
+
+    bool ParseAAMode(const std::string& name, CliOptions& options) {
+        options.enableAA = true;
+        if (name == "none")            { options.enableAA = false; options.aaMode = ScanlineRasterizer::AAMode::None; }
+        else if (name == "4x")         options.aaMode = ScanlineRasterizer::AAMode::Coverage4x;
+        else if (name == "8x")         options.aaMode = ScanlineRasterizer::AAMode::Coverage8x;
+        else if (name == "16x")        options.aaMode = ScanlineRasterizer::AAMode::Coverage16x;
+        else if (name == "analytical") options.aaMode = ScanlineRasterizer::AAMode::Analytical;
+        else if (name == "area")       options.aaMode = ScanlineRasterizer::AAMode::AccumulatedArea;
+        else return false;
+        return true;
+    }
+
+    bool ParseArguments(int argc, char** argv, CliOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> const char* {
+                if (i + 1 >= argc) {
+                    std::cerr << "Missing value for " << arg << std::endl;
+                    return nullptr;
+                }
+                return argv[++i];
+            };
+
+            if (arg == "-h" || arg == "--help") {
+                PrintUsage();
+                std::exit(0);
+            } else if (arg == "-o" || arg == "--output") {
+                const char* v = value(); if (!v) return false;
+                options.output = v;
+            } else if (arg == "-W" || arg == "--width") {
+                const char* v = value(); if (!v) return false;
+                options.width = std::atoi(v);
+            } else if (arg == "-H" || arg == "--height") {
+                const char* v = value(); if (!v) return false;
+                options.height = std::atoi(v);
+            } else if (arg == "-a" || arg == "--aa") {
+                const char* v = value(); if (!v) return false;
+                if (!ParseAAMode(v, options)) {
+                    std::cerr << "Unknown AA mode: " << v << std::endl;
+                    return false;
+                }
+            } else if (arg == "-f" || arg == "--flatness") {
+                const char* v = value(); if (!v) return false;
+                options.flatness = static_cast<float>(std::atof(v));
+            } else if (arg == "-t" || arg == "--threads") {
+                const char* v = value(); if (!v) return false;
+                options.threads = static_cast<unsigned>(std::max(0, std::atoi(v)));
+            } else if (arg == "--transparent") {
+                options.transparent = true;
+            } else if (arg == "--no-cache") {
+                options.documentCache = false;
+            } else if (arg == "-q" || arg == "--quiet") {
+                options.quiet = true;
+            } else if (!arg.empty() && arg[0] == '-') {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            } else {
+                options.inputs.push_back(arg);
+            }
+        }
+
+        if (options.inputs.empty()) {
+            PrintUsage();
+            return false;
+        }
+        if (options.width < 0 || options.height < 0 || options.flatness <= 0) {
+            std::cerr << "Width, height and flatness must be positive" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Directories expand to the .svg files they contain (sorted, not recursive)
+    std::vector<fs::path> CollectInputs(const std::vector<fs::path>& inputs) {
+        std::vector<fs::path> files;
+        for (const auto& input : inputs) {
+            std::error_code ec;
+            if (fs::is_directory(input, ec)) {
+                std::vector<fs::path> found;
+                for (const auto& entry : fs::directory_iterator(input, ec)) {
+                    if (entry.is_regular_file() && entry.path().extension() == ".svg") {
+                        found.push_back(entry.path());
+                    }
+                }
+                std::sort(found.begin(), found.end());
+                files.insert(files.end(), found.begin(), found.end());
+            } else {
+                files.push_back(input);
+            }
+        }
+        return files;
+    }
+
+    fs::path OutputPathFor(const fs::path& input, const CliOptions& options, bool singleFile) {
+        fs::path name = input.filename();
+        name.replace_extension(".png");
+        if (options.output.empty()) return input.parent_path() / name;
+        if (singleFile && !fs::is_directory(options.output)) return options.output;
+        return options.output / name;
+    }
+
+    double Milliseconds(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    bool WritePNG(const fs::path& path, int width, int height, int channels, std::span<std::byte const> bytes) {
+        return stbi_write_png(path.string().c_str(), width, height, channels, bytes.data(), width * channels) != 0;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CliOptions options;
+    if (!ParseArguments(argc, argv, options)) return 2;
+
+    std::vector<fs::path> files = CollectInputs(options.inputs);
+    bool singleFile = files.size() == 1;
+    if (!singleFile && !options.output.empty()) {
+        std::error_code ec;
+        fs::create_directories(options.output, ec);
+    }
+
+    SVGRendererV2 renderer;
+    renderer.SetAntiAliasing(options.enableAA);
+    renderer.SetAAMode(options.aaMode);
+    renderer.SetFlatnessTolerance(options.flatness);
+    renderer.SetThreadCount(options.threads);
+    // Documents are rendered once each; nothing to reuse between them
+    renderer.SetGeometryCacheEnabled(false);
+    if (options.transparent) {
+        renderer.SetBackgroundColor(glm::vec4(0));
+    }
+
+    // Large path data is parsed on the same number of threads
+    SVGParser parser;
+    parser.SetThreadCount(options.threads);
+    parser.SetDocumentCacheEnabled(options.documentCache);
+
+    int failures = 0;
+    double totalMs = 0;
+    double totalPixels = 0;
+
+    for (const auto& file : files) {
+        auto t0 = std::chrono::steady_clock::now();
+
+        FlatDocument document;
+        if (!parser.ParseFile(file.string(), document)) {
+            std::cerr << file.string() << ": parse failed" << std::endl;
+            ++failures;
+            continue;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+
+        // Missing dimensions follow the document, keeping its aspect ratio
+        int width = options.width;
+        int height = options.height;
+        float aspect = document.width > 0 ? document.height / document.width : 1.0f;
+        if (width == 0 && height == 0) {
+            width = static_cast<int>(std::lround(document.width));
+            height = static_cast<int>(std::lround(document.height));
+        } else if (width == 0) {
+            width = static_cast<int>(std::lround(height / aspect));
+        } else if (height == 0) {
+            height = static_cast<int>(std::lround(width * aspect));
+        }
+        if (width <= 0 || height <= 0) {
+            std::cerr << file.string() << ": invalid output size " << width << "x" << height << std::endl;
+            ++failures;
+            continue;
+        }
+
+        fs::path outputPath = OutputPathFor(file, options, singleFile);
+        bool written;
+        std::chrono::steady_clock::time_point t2;
+        if (options.transparent) {
+            Common::ImageRGBA image = renderer.RenderSVGRGBA(document, width, height);
+            t2 = std::chrono::steady_clock::now();
+            written = WritePNG(outputPath, width, height, 4, image.GetBytes());
+        } else {
+            Common::ImageRGB image = renderer.RenderSVG(document, width, height);
+            t2 = std::chrono::steady_clock::now();
+            written = WritePNG(outputPath, width, height, 3, image.GetBytes());
+        }
+        auto t3 = std::chrono::steady_clock::now();
+
+        if (!written) {
+            std::cerr << outputPath.string() << ": write failed" << std::endl;
+            ++failures;
+            continue;
+        }
+
+        double fileMs = Milliseconds(t0, t3);
+        totalMs += fileMs;
+        totalPixels += static_cast<double>(width) * height;
+        if (!options.quiet) {
+            std::printf("%s -> %s  %dx%d  %zu elements  parse %.2f ms  render %.2f ms  write %.2f ms  total %.2f ms\n",
+                        file.string().c_str(), outputPath.string().c_str(), width, height,
+                        document.Size(), Milliseconds(t0, t1), Milliseconds(t1, t2),
+                        Milliseconds(t2, t3), fileMs);
+        }
+    }
+
+    int rendered = static_cast<int>(files.size()) - failures;
+    std::printf("%d rendered, %d failed, %.2f ms total", rendered, failures, totalMs);
+    if (totalMs > 0) {
+        std::printf(", %.2f Mpix/s", totalPixels / (totalMs * 1000.0));
+    }
+    std::printf("\n");
+    return failures == 0 ? 0 : 1;
+}
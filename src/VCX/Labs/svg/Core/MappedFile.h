@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// MappedFile - Read-only view of a whole file
+//
+// The file is memory-mapped, so its bytes are paged in on demand and never
+// copied; parsers read it as one string_view. Where mapping fails (pipes,
+// special files) the contents are read into a buffer instead. Empty files
+// open successfully with an empty view.
+//=============================================================================
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    std::string_view View() const { return { _data, _size }; }
+    bool IsMapped() const { return _mapped; }
+
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;
+    std::vector<char> _buffer;      // Fallback copy
+
+    bool ReadAll(const std::string& filename);
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline bool MappedFile::Open(const std::string& filename) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping) {
+        void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);   // The view keeps the mapping alive
+        if (data) {
+            _data = static_cast<const char*>(data);
+            _size = static_cast<size_t>(size.QuadPart);
+            _mapped = true;
+            return true;
+        }
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    if (S_ISREG(info.st_mode) && info.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+    if (S_ISREG(info.st_mode)) {
+        void* data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            // Parsing reads the file front to back once
+            ::madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            ::close(fd);
+            _data = static_cast<const char*>(data);
+            _size = static_cast<size_t>(info.st_size);
+            _mapped = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    return ReadAll(filename);
+}
+
+inline bool MappedFile::ReadAll(const std::string& filename) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file) return false;
+    char chunk[65536];
+    size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        _buffer.insert(_buffer.end(), chunk, chunk + count);
+    }
+    bool ok = !std::ferror(file);
+    std::fclose(file);
+    if (!ok) {
+        _buffer.clear();
+        return false;
+    }
+    _data = _buffer.data();
+    _size = _buffer.size();
+    return true;
+}
+
+inline void MappedFile::Close() {
+    if (_mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+#else
+        ::munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+    _buffer.clear();
+    _buffer.shrink_to_fit();
+}
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Core/Math2D.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// SpatialGrid - Uniform grid over item bounds, for point queries
+//
+// Items are small integer ids (the editor uses element indices). An item is
+// listed in every cell its bounds overlap; items spanning more than
+// c_MaxCellsPerItem cells (backgrounds, huge paths) go to a short list that
+// every query checks instead, as do items whose bounds are infinite or lie
+// beyond c_MaxCell cells from the origin. Insert, update and remove only
+// touch the cells of that item, so a point query costs O(items in one cell).
+//=============================================================================
+class SpatialGrid {
+public:
+    explicit SpatialGrid(float cellSize = 64.0f) : _cellSize(cellSize) {}
+
+    void Clear() {
+        _items.clear();
+        _cells.clear();
+        _large.clear();
+        _count = 0;
+    }
+
+    // Add an item, or move it if already present
+    void Insert(std::uint32_t id, const BBox& bounds);
+    void Remove(std::uint32_t id);
+
+    bool Contains(std::uint32_t id) const { return id < _items.size() && _items[id].present; }
+    size_t Size() const { return _count; }
+
+    // Ids whose bounds contain point, in no particular order
+    void QueryPoint(const Vec2& point, std::vector<std::uint32_t>& result) const;
+
+    static constexpr int c_MaxCellsPerItem = 64;
+    static constexpr int c_MaxCell = 1 << 30;  // Largest cell coordinate magnitude
+
+private:
+    struct Item {
+        BBox bounds;
+        int x0 = 0, y0 = 0, x1 = -1, y1 = -1;  // Cell range (empty when large)
+        bool present = false;
+        bool large = false;
+    };
+
+    float _cellSize;
+    std::vector<Item> _items;                                           // By id
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> _cells;
+    std::vector<std::uint32_t> _large;
+    size_t _count = 0;
+
+    // Cell coordinate of v; false if it is not finite or beyond c_MaxCell
+    bool Cell(float v, int& cell) const {
+        double c = std::floor(static_cast<double>(v) / _cellSize);
+        if (!(std::abs(c) <= c_MaxCell)) return false;
+        cell = static_cast<int>(c);
+        return true;
+    }
+    static std::uint64_t Key(int x, int y) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+    }
+    static void Erase(std::vector<std::uint32_t>& list, std::uint32_t id) {
+        auto it = std::find(list.begin(), list.end(), id);
+        if (it == list.end()) return;
+        *it = list.back();
+        list.pop_back();
+    }
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline void SpatialGrid::Insert(std::uint32_t id, const BBox& bounds) {
+    Remove(id);
+    if (!bounds.IsValid()) return;
+    if (id >= _items.size()) _items.resize(id + 1);
+
+    Item& item = _items[id];
+    item.bounds = bounds;
+    item.present = true;
+    ++_count;
+
+    int x0, y0, x1, y1;
+    bool inGrid = Cell(bounds.min.x, x0) && Cell(bounds.min.y, y0) &&
+                  Cell(bounds.max.x, x1) && Cell(bounds.max.y, y1);
+    if (!inGrid || (static_cast<std::int64_t>(x1) - x0 + 1) * (static_cast<std::int64_t>(y1) - y0 + 1) > c_MaxCellsPerItem) {
+        item.large = true;
+        _large.push_back(id);
+        return;
+    }
+
+    item.large = false;
+    item.x0 = x0; item.y0 = y0; item.x1 = x1; item.y1 = y1;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            _cells[Key(x, y)].push_back(id);
+        }
+    }
+}
+
+inline void SpatialGrid::Remove(std::uint32_t id) {
+    if (!Contains(id)) return;
+    Item& item = _items[id];
+    if (item.large) {
+        Erase(_large, id);
+    } else {
+        for (int y = item.y0; y <= item.y1; ++y) {
+            for (int x = item.x0; x <= item.x1; ++x) {
+                auto it = _cells.find(Key(x, y));
+                if (it == _cells.end()) continue;
+                Erase(it->second, id);
+                if (it->second.empty()) _cells.erase(it);
+            }
+        }
+    }
+    item = Item();
+    --_count;
+}
+
+inline void SpatialGrid::QueryPoint(const Vec2& point, std::vector<std::uint32_t>& result) const {
+    result.clear();
+    auto contains = [&](std::uint32_t id) {
+        const BBox& b = _items[id].bounds;
+        return point.x >= b.min.x && point.x <= b.max.x && point.y >= b.min.y && point.y <= b.max.y;
+    };
+
+    // A point outside the grid can only be inside large items
+    int x, y;
+    if (Cell(point.x, x) && Cell(point.y, y)) {
+        auto it = _cells.find(Key(x, y));
+        if (it != _cells.end()) {
+            for (std::uint32_t id : it->second) {
+                if (contains(id)) result.push_back(id);
+            }
+        }
+    }
+    for (std::uint32_t id : _large) {
+        if (contains(id)) result.push_back(id);
+    }
+}
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// ThreadPool - Persistent workers for data-parallel loops
+//
+// ParallelFor hands out indices through a shared atomic counter, so idle
+// workers keep pulling the next task until the range is drained. The calling
+// thread participates as worker 0.
+//=============================================================================
+class ThreadPool {
+public:
+    // task(index, workerIndex), workerIndex in [0, GetThreadCount())
+    using Task = std::function<void(size_t, unsigned)>;
+
+    // threadCount includes the calling thread; 0 = hardware concurrency
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned GetThreadCount() const { return static_cast<unsigned>(_workers.size()) + 1; }
+
+    // Run task for every index in [0, count) and wait for completion
+    void ParallelFor(size_t count, const Task& task);
+
+private:
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wakeCondition;
+    std::condition_variable _doneCondition;
+
+    const Task* _task = nullptr;
+    size_t _count = 0;
+    std::atomic<size_t> _next{0};
+    size_t _busyWorkers = 0;
+    std::uint64_t _generation = 0;
+    bool _stop = false;
+
+    void WorkerLoop(unsigned workerIndex);
+    void RunTasks(unsigned workerIndex);
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 1; i < threadCount; ++i) {
+        _workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeCondition.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+inline void ThreadPool::ParallelFor(size_t count, const Task& task) {
+    if (count == 0) return;
+
+    // Nothing to share: run inline
+    if (_workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = &task;
+        _count = count;
+        _next.store(0);
+        _busyWorkers = _workers.size();
+        ++_generation;
+    }
+    _wakeCondition.notify_all();
+
+    RunTasks(0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this] { return _busyWorkers == 0; });
+    _task = nullptr;
+}
+
+inline void ThreadPool::WorkerLoop(unsigned workerIndex) {
+    std::uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeCondition.wait(lock, [&] { return _stop || _generation != seenGeneration; });
+            if (_stop) return;
+            seenGeneration = _generation;
+        }
+
+        RunTasks(workerIndex);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_busyWorkers == 0) {
+            _doneCondition.notify_one();
+        }
+    }
+}
+
+inline void ThreadPool::RunTasks(unsigned workerIndex) {
+    size_t index;
+    while ((index = _next.fetch_add(1)) < _count) {
+        (*_task)(index, workerIndex);
+    }
+}
+
+} // namespace VCX::Labs::SVG
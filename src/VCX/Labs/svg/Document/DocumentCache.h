@@ -0,0 +1,371 @@
+#pragma once
+
+#include "Document/FlatDocument.h"
+#include "Core/MappedFile.h"
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// FlatDocumentCache - Parsed FlatDocuments stored as binary files
+//
+// A cache file holds a document's tables as they are in memory, each in its
+// own aligned section, under a header with the size and content hash of
+// the SVG source it was parsed from. Loading maps the file: the path verbs
+// and points are used in place, the much smaller node columns and tables
+// are copied out, and render styles are resolved again from the style
+// table. A cache written by another format version, parser revision,
+// record layout or byte order, or for other source bytes, is not loaded.
+//
+// Files are written to a temporary name and renamed into place, so a
+// reader sees either the old file or the complete new one.
+//=============================================================================
+class FlatDocumentCache {
+public:
+    static constexpr std::uint32_t c_Version = 2;           // File format
+    // What SVGParser makes of a source: bump it with any change to the
+    // FlatDocument it produces, so existing caches are parsed again
+    static constexpr std::uint32_t c_ParserRevision = 1;
+    static constexpr const char* c_Extension = ".cache";
+
+    // Stored next to the source: "drawing.svg" -> "drawing.svg.cache"
+    static std::string PathFor(const std::string& source) { return source + c_Extension; }
+
+    // 64-bit hash of the source bytes; reads 32 bytes per step
+    static std::uint64_t ContentHash(std::string_view bytes);
+
+    // Replaces document with the cached one; false (document unchanged) if
+    // the file is missing, stale or malformed
+    static bool Load(const std::string& path, std::uint64_t sourceSize, std::uint64_t sourceHash,
+                     FlatDocument& document);
+    static bool Save(const std::string& path, std::uint64_t sourceSize, std::uint64_t sourceHash,
+                     const FlatDocument& document);
+
+private:
+    enum Section : std::uint32_t {
+        ViewBox,
+        NodeType,
+        NodeId,
+        NodeStyle,
+        NodeTransform,
+        NodeShapeTransform,
+        NodeData,
+        Transforms,
+        Styles,
+        Dashes,
+        Verbs,
+        Points,
+        Paths,
+        Texts,
+        Params,
+        StringSizes,        // Byte length of each string after the empty one
+        StringBytes,        // The strings back to back
+        SectionCount
+    };
+
+    struct Range {
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t sectionCount;
+        std::uint8_t layout[8];     // Layout()
+        std::uint64_t sourceSize;
+        std::uint64_t sourceHash;
+        std::uint32_t parserRevision;
+        float width;
+        float height;
+        Range sections[SectionCount];
+    };
+
+    static constexpr char c_Magic[8] = { 'V', 'C', 'X', 'F', 'L', 'A', 'T', '\0' };
+    static constexpr std::uint64_t c_Alignment = 16;
+
+    // Byte order and the sizes of the records stored as raw bytes
+    static constexpr std::uint8_t c_Layout[8] = {
+        std::endian::native == std::endian::little ? 1 : 2,
+        sizeof(Point2D),
+        sizeof(glm::mat3),
+        sizeof(FlatStyle),
+        sizeof(FlatDocument::PathRange),
+        sizeof(FlatDocument::TextRun),
+        0,
+        0
+    };
+
+    static std::uint64_t Align(std::uint64_t offset) { return (offset + c_Alignment - 1) & ~(c_Alignment - 1); }
+
+    template <typename T>
+    static std::span<const std::byte> Bytes(const std::vector<T>& v) { return std::as_bytes(std::span<const T>(v)); }
+    template <typename T>
+    static std::span<const std::byte> Bytes(std::span<const T> v) { return std::as_bytes(v); }
+
+    // A section in place; empty if its size is not a whole number of records
+    template <typename T>
+    static std::span<const T> View(std::string_view file, const Range& range) {
+        if (range.size % sizeof(T) != 0) return {};
+        return { reinterpret_cast<const T*>(file.data() + range.offset), range.size / sizeof(T) };
+    }
+    template <typename T>
+    static bool Copy(std::string_view file, const Range& range, std::vector<T>& out) {
+        if (range.size % sizeof(T) != 0) return false;
+        std::span<const T> items = View<T>(file, range);
+        out.assign(items.begin(), items.end());
+        return true;
+    }
+
+    // Every index stored in the document points into its table
+    static bool Validate(const FlatDocument& document);
+
+    static std::uint64_t Mix(std::uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline std::uint64_t FlatDocumentCache::ContentHash(std::string_view bytes) {
+    constexpr std::uint64_t k = 0x9E3779B97F4A7C15ull;
+    const char* data = bytes.data();
+    size_t size = bytes.size();
+
+    // Four independent lanes so the multiplies overlap
+    std::uint64_t lanes[4] = { k, k + 1, k + 2, k + 3 };
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int lane = 0; lane < 4; ++lane) {
+            std::uint64_t word;
+            std::memcpy(&word, data + i + lane * 8, 8);
+            lanes[lane] = std::rotl((lanes[lane] ^ word) * k, 31);
+        }
+    }
+
+    std::uint64_t hash = Mix(size * k);
+    for (std::uint64_t lane : lanes) hash = Mix(hash ^ lane);
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = Mix(hash ^ word);
+    }
+    if (i < size) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data + i, size - i);
+        hash = Mix(hash ^ word);
+    }
+    return hash;
+}
+
+inline bool FlatDocumentCache::Save(const std::string& path, std::uint64_t sourceSize, std::uint64_t sourceHash,
+                                    const FlatDocument& document) {
+    std::vector<std::uint32_t> stringSizes;
+    std::string stringBytes;
+    stringSizes.reserve(document.strings.Size());
+    for (std::uint32_t i = 1; i < document.strings.Size(); ++i) {
+        std::string_view text = document.strings.Get(i);
+        stringSizes.push_back(static_cast<std::uint32_t>(text.size()));
+        stringBytes += text;
+    }
+
+    const FlatDocument::NodeTable& nodes = document.nodes;
+    std::span<const std::byte> payload[SectionCount] = {
+        Bytes(std::span<const char>(document.viewBox)),
+        Bytes(nodes.type),
+        Bytes(nodes.id),
+        Bytes(nodes.style),
+        Bytes(nodes.transform),
+        Bytes(nodes.shapeTransform),
+        Bytes(nodes.data),
+        Bytes(document.transforms),
+        Bytes(document.styles),
+        Bytes(document.dashes),
+        Bytes(document.VerbPool()),
+        Bytes(document.PointPool()),
+        Bytes(document.paths),
+        Bytes(document.texts),
+        Bytes(document.params),
+        Bytes(stringSizes),
+        Bytes(std::span<const char>(stringBytes)),
+    };
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));    // Padding included, so files are reproducible
+    std::memcpy(header.magic, c_Magic, sizeof(c_Magic));
+    header.version = c_Version;
+    header.sectionCount = SectionCount;
+    std::memcpy(header.layout, c_Layout, sizeof(c_Layout));
+    header.sourceSize = sourceSize;
+    header.sourceHash = sourceHash;
+    header.parserRevision = c_ParserRevision;
+    header.width = document.width;
+    header.height = document.height;
+    std::uint64_t offset = Align(sizeof(Header));
+    for (std::uint32_t s = 0; s < SectionCount; ++s) {
+        header.sections[s] = { offset, payload[s].size() };
+        offset = Align(offset + payload[s].size());
+    }
+
+    std::string temp = path + ".tmp";
+    std::FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) return false;
+    static constexpr char c_Padding[c_Alignment] = {};
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    std::uint64_t written = sizeof(header);
+    for (std::uint32_t s = 0; s < SectionCount && ok; ++s) {
+        std::uint64_t padding = header.sections[s].offset - written;
+        if (padding > 0) ok = std::fwrite(c_Padding, 1, padding, file) == padding;
+        if (ok && !payload[s].empty()) {
+            ok = std::fwrite(payload[s].data(), 1, payload[s].size(), file) == payload[s].size();
+        }
+        written = header.sections[s].offset + header.sections[s].size;
+    }
+    ok = std::fclose(file) == 0 && ok;
+
+    if (ok) {
+        std::error_code error;
+        std::filesystem::rename(temp, path, error);
+        ok = !error;
+    }
+    if (!ok) std::remove(temp.c_str());
+    return ok;
+}
+
+inline bool FlatDocumentCache::Load(const std::string& path, std::uint64_t sourceSize, std::uint64_t sourceHash,
+                                    FlatDocument& document) {
+    auto mapping = std::make_shared<MappedFile>();
+    if (!mapping->Open(path)) return false;
+    std::string_view file = mapping->View();
+
+    Header header;
+    if (file.size() < sizeof(header)) return false;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, c_Magic, sizeof(c_Magic)) != 0 || header.version != c_Version ||
+        header.sectionCount != SectionCount || std::memcmp(header.layout, c_Layout, sizeof(c_Layout)) != 0 ||
+        header.parserRevision != c_ParserRevision || header.sourceSize != sourceSize ||
+        header.sourceHash != sourceHash) {
+        return false;
+    }
+    for (const Range& range : header.sections) {
+        if (range.offset % c_Alignment != 0 || range.offset > file.size() || range.size > file.size() - range.offset) {
+            return false;
+        }
+    }
+    const Range* sections = header.sections;
+
+    FlatDocument loaded;
+    loaded.width = header.width;
+    loaded.height = header.height;
+    loaded.viewBox.assign(file.data() + sections[ViewBox].offset, sections[ViewBox].size);
+    FlatDocument::NodeTable& nodes = loaded.nodes;
+    std::vector<std::uint32_t> stringSizes;
+    bool ok = Copy(file, sections[NodeType], nodes.type) && Copy(file, sections[NodeId], nodes.id) &&
+              Copy(file, sections[NodeStyle], nodes.style) &&
+              Copy(file, sections[NodeTransform], nodes.transform) &&
+              Copy(file, sections[NodeShapeTransform], nodes.shapeTransform) &&
+              Copy(file, sections[NodeData], nodes.data) && Copy(file, sections[Transforms], loaded.transforms) &&
+              Copy(file, sections[Styles], loaded.styles) && Copy(file, sections[Dashes], loaded.dashes) &&
+              Copy(file, sections[Paths], loaded.paths) && Copy(file, sections[Texts], loaded.texts) &&
+              Copy(file, sections[Params], loaded.params) && Copy(file, sections[StringSizes], stringSizes);
+    if (!ok || sections[Points].size % sizeof(Point2D) != 0) return false;
+
+    // Interning the strings in their stored order gives them their indices back
+    std::string_view stringBytes = file.substr(sections[StringBytes].offset, sections[StringBytes].size);
+    size_t position = 0;
+    for (std::uint32_t size : stringSizes) {
+        if (size == 0 || size > stringBytes.size() - position) return false;
+        std::uint32_t index = loaded.strings.Intern(stringBytes.substr(position, size));
+        if (index != loaded.strings.Size() - 1) return false;
+        position += size;
+    }
+
+    loaded.MapPathPools(mapping, View<std::uint8_t>(file, sections[Verbs]), View<Point2D>(file, sections[Points]));
+    if (!Validate(loaded)) return false;
+
+    loaded.paints.reserve(loaded.styles.size());
+    for (std::uint32_t i = 0; i < loaded.styles.size(); ++i) {
+        loaded.paints.push_back(RenderStyle::Resolve(loaded.GetStyle(i)));
+    }
+    loaded.Finish();
+    document = std::move(loaded);
+    return true;
+}
+
+inline bool FlatDocumentCache::Validate(const FlatDocument& document) {
+    const FlatDocument::NodeTable& nodes = document.nodes;
+    size_t count = nodes.Size();
+    if (nodes.id.size() != count || nodes.style.size() != count || nodes.transform.size() != count ||
+        nodes.shapeTransform.size() != count || nodes.data.size() != count || document.transforms.empty()) {
+        return false;
+    }
+
+    for (const FlatStyle& style : document.styles) {
+        if (style.dashStart > document.dashes.size() || style.dashCount > document.dashes.size() - style.dashStart) {
+            return false;
+        }
+    }
+    // A path's verbs decide how many points it reads, so they are walked
+    // once: a file truncated or damaged after its header still matches the
+    // source hash
+    std::span<const std::uint8_t> verbs = document.VerbPool();
+    size_t pointCount = document.PointPool().size();
+    for (const FlatDocument::PathRange& path : document.paths) {
+        if (path.firstVerb > verbs.size() || path.verbCount > verbs.size() - path.firstVerb ||
+            path.firstPoint > pointCount) {
+            return false;
+        }
+        size_t points = 0;
+        for (std::uint8_t verb : verbs.subspan(path.firstVerb, path.verbCount)) {
+            points += PathView::PointCount(PathView::TypeOf(verb));
+        }
+        if (points > pointCount - path.firstPoint) return false;
+    }
+    for (const FlatDocument::TextRun& text : document.texts) {
+        if (text.text >= document.strings.Size() || text.fontFamily >= document.strings.Size()) return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (nodes.id[i] >= document.strings.Size() || nodes.style[i] >= document.styles.size() ||
+            nodes.transform[i] >= document.transforms.size() ||
+            nodes.shapeTransform[i] >= document.transforms.size()) {
+            return false;
+        }
+        std::uint32_t data = nodes.data[i];
+        size_t params = 0;
+        switch (static_cast<SVGElement::Type>(nodes.type[i])) {
+            case SVGElement::Type::Path:
+                if (data >= document.paths.size()) return false;
+                continue;
+            case SVGElement::Type::Text:
+                if (data >= document.texts.size()) return false;
+                continue;
+            case SVGElement::Type::Circle:  params = 3; break;
+            case SVGElement::Type::Ellipse: params = 4; break;
+            case SVGElement::Type::Rect:    params = 6; break;
+            case SVGElement::Type::Line:    params = 4; break;
+            default:                        return false;
+        }
+        if (data > document.params.size() || params > document.params.size() - data) return false;
+    }
+    return true;
+}
+
+} // namespace VCX::Labs::SVG
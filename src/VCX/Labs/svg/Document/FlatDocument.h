@@ -0,0 +1,493 @@
+#pragma once
+
+#include "SVG.h"
+#include "Core/MappedFile.h"
+#include "Geometry/ShapeView.h"
+#include "Renderer/RenderStyle.h"
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// StringPool - Interned strings in a few large blocks
+//
+// Index 0 is the empty string. Views stay valid until Clear (blocks never
+// move), so the pool can be moved with its document.
+//=============================================================================
+class StringPool {
+public:
+    StringPool() { Clear(); }
+
+    std::uint32_t Intern(std::string_view text);
+    std::string_view Get(std::uint32_t index) const { return _strings[index]; }
+    size_t Size() const { return _strings.size(); }
+    size_t MemoryBytes() const;
+
+    void Clear() {
+        _blocks.clear();
+        _blockSizes.clear();
+        _blockUsed = c_BlockSize;
+        _strings.assign(1, std::string_view());
+        _index.clear();
+    }
+
+    static constexpr size_t c_BlockSize = 64 * 1024;
+
+private:
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    std::vector<size_t> _blockSizes;
+    size_t _blockUsed = c_BlockSize;
+    std::vector<std::string_view> _strings;
+    std::unordered_map<std::string_view, std::uint32_t> _index;
+};
+
+//=============================================================================
+// FlatStyle - One entry of the style table
+//
+// The SVGStyle fields as plain values; flags say which optional ones are
+// set. Keywords (fill-rule, line cap/join) hold their enum values. Trivially
+// copyable and free of padding, so entries are compared and hashed as bytes.
+//=============================================================================
+struct FlatStyle {
+    enum Flag : std::uint32_t {
+        HasFill          = 1 << 0,
+        HasStroke        = 1 << 1,
+        HasStrokeWidth   = 1 << 2,
+        HasOpacity       = 1 << 3,
+        HasFillOpacity   = 1 << 4,
+        HasStrokeOpacity = 1 << 5,
+        HasFillRule      = 1 << 6,
+        HasLineCap       = 1 << 7,
+        HasLineJoin      = 1 << 8,
+        HasMiterLimit    = 1 << 9,
+        HasDashArray     = 1 << 10,
+        HasDashOffset    = 1 << 11,
+        FillNone         = 1 << 12,
+        StrokeNone       = 1 << 13
+    };
+
+    glm::vec4 fillColor = glm::vec4(0);
+    glm::vec4 strokeColor = glm::vec4(0);
+    float strokeWidth = 0;
+    float opacity = 0;
+    float fillOpacity = 0;
+    float strokeOpacity = 0;
+    float miterLimit = 0;
+    float dashOffset = 0;
+    std::uint32_t fillRule = 0;     // SVGFillRule
+    std::uint32_t lineCap = 0;      // SVGLineCap
+    std::uint32_t lineJoin = 0;     // SVGLineJoin
+    std::uint32_t dashStart = 0;    // Into FlatDocument::dashes
+    std::uint32_t dashCount = 0;
+    std::uint32_t flags = 0;
+
+    bool Has(Flag flag) const { return (flags & flag) != 0; }
+};
+
+//=============================================================================
+// FlatDocument - Compact, read-only form of a parsed SVG for load and render
+//
+// Shapes in paint order as structure-of-arrays columns (one entry per shape
+// in each), over shared pools: the verbs and points of all paths, the
+// parameters of the other shapes, deduplicated transform and style tables,
+// and interned ids and text. Groups are flattened as in SVGDocument, their
+// composed transform becoming the node's transform. A node costs a few
+// dozen bytes against the kilobyte or so of an SVGElement with its two
+// SVGStyles, and nothing is allocated per node.
+//
+// Built by SVGParser and drawn by SVGRendererV2 as is. Documents that are
+// edited element by element stay SVGDocuments. A document loaded from a
+// FlatDocumentCache file reads its path pools in place from the mapping.
+//=============================================================================
+class FlatDocument {
+public:
+    float width = 800.0f;
+    float height = 600.0f;
+    std::string viewBox;
+
+    // Node columns
+    struct NodeTable {
+        std::vector<std::uint8_t> type;             // SVGElement::Type
+        std::vector<std::uint32_t> id;              // Into strings (0 = none)
+        std::vector<std::uint32_t> style;           // Into styles
+        std::vector<std::uint32_t> transform;       // Group transform, into transforms (0 = identity)
+        std::vector<std::uint32_t> shapeTransform;  // The shape's own transform
+        std::vector<std::uint32_t> data;            // Path: into paths, text: into texts, others: into params
+
+        size_t Size() const { return type.size(); }
+    };
+
+    struct PathRange {
+        std::uint32_t firstVerb;
+        std::uint32_t verbCount;
+        std::uint32_t firstPoint;
+    };
+
+    struct TextRun {
+        std::uint32_t text;         // Into strings
+        std::uint32_t fontFamily;
+        Point2D position;
+        float fontSize;
+    };
+
+    NodeTable nodes;
+    std::vector<glm::mat3> transforms;      // [0] = identity
+    std::vector<FlatStyle> styles;
+    std::vector<RenderStyle> paints;        // styles[i] resolved for drawing
+    std::vector<float> dashes;
+    std::vector<std::uint8_t> verbs;        // PathView packing; empty when mapped
+    std::vector<Point2D> points;
+    std::vector<PathRange> paths;
+    std::vector<TextRun> texts;
+    std::vector<float> params;              // Circle: cx cy r, ellipse: cx cy rx ry,
+                                            // rect: x y w h rx ry, line: x1 y1 x2 y2
+    StringPool strings;
+
+    FlatDocument() { Clear(); }
+    FlatDocument(FlatDocument&&) = default;
+    FlatDocument& operator=(FlatDocument&&) = default;
+
+    void Clear();
+
+    size_t Size() const { return nodes.Size(); }
+    bool IsEmpty() const { return nodes.type.empty(); }
+
+    // Node i renders with the uid _uidBase + i (geometry cache, element costs)
+    std::uint64_t Uid(std::uint32_t node) const { return _uidBase + node; }
+    SVGElement::Type Type(std::uint32_t node) const { return static_cast<SVGElement::Type>(nodes.type[node]); }
+    std::string_view Id(std::uint32_t node) const { return strings.Get(nodes.id[node]); }
+    ShapeView Shape(std::uint32_t node) const;
+
+    // The path pools: verbs/points, or the mapped file's arrays
+    std::span<const std::uint8_t> VerbPool() const {
+        return _mapping ? _mappedVerbs : std::span<const std::uint8_t>(verbs);
+    }
+    std::span<const Point2D> PointPool() const {
+        return _mapping ? _mappedPoints : std::span<const Point2D>(points);
+    }
+
+    // Table entries as the element structures hold them
+    SVGStyle GetStyle(std::uint32_t style) const;
+
+    bool ParseViewBox(float& x, float& y, float& w, float& h) const {
+        return SVGDocument::ParseViewBox(viewBox, x, y, w, h);
+    }
+
+    // Building (SVGParser): intern tables, then append nodes in paint order;
+    // Finish reserves the uids once all nodes are in
+    std::uint32_t AddTransform(const glm::mat3& matrix);
+    std::uint32_t AddStyle(const SVGStyle& style);
+    std::uint32_t AddShape(SVGElement::Type type, std::uint32_t id, std::uint32_t style,
+                           std::uint32_t transform, std::uint32_t shapeTransform,
+                           const float* values, std::uint32_t count);
+    // A path's verbs and points are appended to the pools first (e.g. by
+    // PathDataParser); the node takes everything from firstVerb/firstPoint on
+    std::uint32_t AddPath(std::uint32_t id, std::uint32_t style, std::uint32_t transform,
+                          std::uint32_t shapeTransform, std::uint32_t firstVerb, std::uint32_t firstPoint);
+    std::uint32_t AddText(std::uint32_t id, std::uint32_t style, std::uint32_t transform,
+                          std::uint32_t shapeTransform, const TextRun& text);
+    void Finish();
+
+    // Loading (FlatDocumentCache): path pools read in place from a file,
+    // which stays mapped until Clear
+    void MapPathPools(std::shared_ptr<const MappedFile> file, std::span<const std::uint8_t> verbPool,
+                      std::span<const Point2D> pointPool);
+
+    // Heap bytes held by the tables and pools (a mapping is not counted)
+    size_t MemoryBytes() const;
+
+private:
+    std::uint64_t _uidBase = 0;
+    std::shared_ptr<const MappedFile> _mapping;
+    std::span<const std::uint8_t> _mappedVerbs;
+    std::span<const Point2D> _mappedPoints;
+    std::unordered_multimap<std::uint64_t, std::uint32_t> _transformIndex;    // Hash -> entry
+    std::unordered_multimap<std::uint64_t, std::uint32_t> _styleIndex;
+
+    std::uint32_t AddNode(SVGElement::Type type, std::uint32_t id, std::uint32_t style,
+                          std::uint32_t transform, std::uint32_t shapeTransform, std::uint32_t data);
+
+    // FNV-1a
+    static std::uint64_t Hash(const void* data, size_t size, std::uint64_t hash = 14695981039346656037ull) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    static size_t Capacity(const std::vector<T>& v) { return v.capacity() * sizeof(T); }
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline std::uint32_t StringPool::Intern(std::string_view text) {
+    if (text.empty()) return 0;
+    auto it = _index.find(text);
+    if (it != _index.end()) return it->second;
+
+    char* storage;
+    if (text.size() > c_BlockSize / 4) {
+        // Long strings get a block of their own; the next short one opens a new block
+        _blocks.push_back(std::make_unique<char[]>(text.size()));
+        _blockSizes.push_back(text.size());
+        storage = _blocks.back().get();
+        _blockUsed = c_BlockSize;
+    } else {
+        if (_blockUsed + text.size() > c_BlockSize) {
+            _blocks.push_back(std::make_unique<char[]>(c_BlockSize));
+            _blockSizes.push_back(c_BlockSize);
+            _blockUsed = 0;
+        }
+        storage = _blocks.back().get() + _blockUsed;
+        _blockUsed += text.size();
+    }
+    std::memcpy(storage, text.data(), text.size());
+
+    std::uint32_t index = static_cast<std::uint32_t>(_strings.size());
+    std::string_view view(storage, text.size());
+    _strings.push_back(view);
+    _index.emplace(view, index);
+    return index;
+}
+
+inline size_t StringPool::MemoryBytes() const {
+    size_t bytes = _strings.capacity() * sizeof(std::string_view);
+    bytes += _index.size() * (sizeof(std::string_view) + sizeof(std::uint32_t) + 2 * sizeof(void*));
+    bytes += _index.bucket_count() * sizeof(void*);
+    for (size_t size : _blockSizes) bytes += size;
+    return bytes;
+}
+
+inline void FlatDocument::Clear() {
+    width = 800.0f;
+    height = 600.0f;
+    viewBox.clear();
+    nodes = NodeTable();
+    transforms.assign(1, glm::mat3(1.0f));
+    styles.clear();
+    paints.clear();
+    dashes.clear();
+    verbs.clear();
+    points.clear();
+    paths.clear();
+    texts.clear();
+    params.clear();
+    strings.Clear();
+    _uidBase = 0;
+    _mapping.reset();
+    _mappedVerbs = {};
+    _mappedPoints = {};
+    _transformIndex.clear();
+    _styleIndex.clear();
+}
+
+inline ShapeView FlatDocument::Shape(std::uint32_t node) const {
+    ShapeView shape;
+    shape.type = Type(node);
+    std::uint32_t data = nodes.data[node];
+    const float* p = params.data() + data;
+    switch (shape.type) {
+        case SVGElement::Type::Path: {
+            const PathRange& path = paths[data];
+            shape.verbs = PathView(VerbPool().data() + path.firstVerb, path.verbCount,
+                                   PointPool().data() + path.firstPoint);
+            break;
+        }
+        case SVGElement::Type::Circle:
+            shape.point = Point2D(p[0], p[1]);
+            shape.rx = shape.ry = p[2];
+            break;
+        case SVGElement::Type::Ellipse:
+            shape.point = Point2D(p[0], p[1]);
+            shape.rx = p[2];
+            shape.ry = p[3];
+            break;
+        case SVGElement::Type::Rect:
+            shape.point = Point2D(p[0], p[1]);
+            shape.width = p[2];
+            shape.height = p[3];
+            shape.rx = p[4];
+            shape.ry = p[5];
+            break;
+        case SVGElement::Type::Line:
+            shape.point = Point2D(p[0], p[1]);
+            shape.point2 = Point2D(p[2], p[3]);
+            break;
+        case SVGElement::Type::Text:
+            shape.point = texts[data].position;
+            break;
+        default:
+            break;
+    }
+    return shape;
+}
+
+inline SVGStyle FlatDocument::GetStyle(std::uint32_t index) const {
+    const FlatStyle& flat = styles[index];
+    SVGStyle style;
+    if (flat.Has(FlatStyle::HasFill)) style.fillColor = flat.fillColor;
+    if (flat.Has(FlatStyle::HasStroke)) style.strokeColor = flat.strokeColor;
+    if (flat.Has(FlatStyle::HasStrokeWidth)) style.strokeWidth = flat.strokeWidth;
+    if (flat.Has(FlatStyle::HasOpacity)) style.opacity = flat.opacity;
+    if (flat.Has(FlatStyle::HasFillOpacity)) style.fillOpacity = flat.fillOpacity;
+    if (flat.Has(FlatStyle::HasStrokeOpacity)) style.strokeOpacity = flat.strokeOpacity;
+    if (flat.Has(FlatStyle::HasFillRule)) style.fillRule = static_cast<SVGFillRule>(flat.fillRule);
+    if (flat.Has(FlatStyle::HasLineCap)) style.strokeLineCap = static_cast<SVGLineCap>(flat.lineCap);
+    if (flat.Has(FlatStyle::HasLineJoin)) style.strokeLineJoin = static_cast<SVGLineJoin>(flat.lineJoin);
+    if (flat.Has(FlatStyle::HasMiterLimit)) style.strokeMiterLimit = flat.miterLimit;
+    if (flat.Has(FlatStyle::HasDashArray)) {
+        style.strokeDashArray = std::vector<float>(dashes.begin() + flat.dashStart,
+                                                   dashes.begin() + flat.dashStart + flat.dashCount);
+    }
+    if (flat.Has(FlatStyle::HasDashOffset)) style.strokeDashOffset = flat.dashOffset;
+    style.fillNone = flat.Has(FlatStyle::FillNone);
+    style.strokeNone = flat.Has(FlatStyle::StrokeNone);
+    return style;
+}
+
+inline std::uint32_t FlatDocument::AddTransform(const glm::mat3& matrix) {
+    if (matrix == transforms[0]) return 0;
+    std::uint64_t hash = Hash(&matrix, sizeof(matrix));
+    auto [first, last] = _transformIndex.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        if (std::memcmp(&transforms[it->second], &matrix, sizeof(matrix)) == 0) return it->second;
+    }
+    std::uint32_t index = static_cast<std::uint32_t>(transforms.size());
+    transforms.push_back(matrix);
+    _transformIndex.emplace(hash, index);
+    return index;
+}
+
+inline std::uint32_t FlatDocument::AddStyle(const SVGStyle& style) {
+    FlatStyle flat;
+    auto set = [&](FlatStyle::Flag flag, bool on) { if (on) flat.flags |= flag; };
+    set(FlatStyle::HasFill, style.fillColor.has_value());
+    set(FlatStyle::HasStroke, style.strokeColor.has_value());
+    set(FlatStyle::HasStrokeWidth, style.strokeWidth.has_value());
+    set(FlatStyle::HasOpacity, style.opacity.has_value());
+    set(FlatStyle::HasFillOpacity, style.fillOpacity.has_value());
+    set(FlatStyle::HasStrokeOpacity, style.strokeOpacity.has_value());
+    set(FlatStyle::HasFillRule, style.fillRule.has_value());
+    set(FlatStyle::HasLineCap, style.strokeLineCap.has_value());
+    set(FlatStyle::HasLineJoin, style.strokeLineJoin.has_value());
+    set(FlatStyle::HasMiterLimit, style.strokeMiterLimit.has_value());
+    set(FlatStyle::HasDashArray, style.strokeDashArray.has_value());
+    set(FlatStyle::HasDashOffset, style.strokeDashOffset.has_value());
+    set(FlatStyle::FillNone, style.fillNone);
+    set(FlatStyle::StrokeNone, style.strokeNone);
+    flat.fillColor = style.fillColor.value_or(glm::vec4(0));
+    flat.strokeColor = style.strokeColor.value_or(glm::vec4(0));
+    flat.strokeWidth = style.strokeWidth.value_or(0.0f);
+    flat.opacity = style.opacity.value_or(0.0f);
+    flat.fillOpacity = style.fillOpacity.value_or(0.0f);
+    flat.strokeOpacity = style.strokeOpacity.value_or(0.0f);
+    flat.miterLimit = style.strokeMiterLimit.value_or(0.0f);
+    flat.dashOffset = style.strokeDashOffset.value_or(0.0f);
+    if (style.fillRule) flat.fillRule = static_cast<std::uint32_t>(*style.fillRule);
+    if (style.strokeLineCap) flat.lineCap = static_cast<std::uint32_t>(*style.strokeLineCap);
+    if (style.strokeLineJoin) flat.lineJoin = static_cast<std::uint32_t>(*style.strokeLineJoin);
+
+    // Dash values are part of the key; dashStart is left 0 until stored
+    const std::vector<float>* dash = style.strokeDashArray ? &*style.strokeDashArray : nullptr;
+    if (dash) flat.dashCount = static_cast<std::uint32_t>(dash->size());
+    std::uint64_t hash = Hash(&flat, sizeof(flat));
+    if (dash) hash = Hash(dash->data(), dash->size() * sizeof(float), hash);
+
+    auto [first, last] = _styleIndex.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        FlatStyle candidate = styles[it->second];
+        std::uint32_t start = candidate.dashStart;
+        candidate.dashStart = 0;
+        if (std::memcmp(&candidate, &flat, sizeof(flat)) != 0) continue;
+        if (dash && std::memcmp(dashes.data() + start, dash->data(), dash->size() * sizeof(float)) != 0) continue;
+        return it->second;
+    }
+
+    if (dash) {
+        flat.dashStart = static_cast<std::uint32_t>(dashes.size());
+        dashes.insert(dashes.end(), dash->begin(), dash->end());
+    }
+    std::uint32_t index = static_cast<std::uint32_t>(styles.size());
+    styles.push_back(flat);
+    paints.push_back(RenderStyle::Resolve(style));
+    _styleIndex.emplace(hash, index);
+    return index;
+}
+
+inline std::uint32_t FlatDocument::AddNode(SVGElement::Type type, std::uint32_t id, std::uint32_t style,
+                                           std::uint32_t transform, std::uint32_t shapeTransform,
+                                           std::uint32_t data) {
+    std::uint32_t node = static_cast<std::uint32_t>(nodes.Size());
+    nodes.type.push_back(static_cast<std::uint8_t>(type));
+    nodes.id.push_back(id);
+    nodes.style.push_back(style);
+    nodes.transform.push_back(transform);
+    nodes.shapeTransform.push_back(shapeTransform);
+    nodes.data.push_back(data);
+    return node;
+}
+
+inline std::uint32_t FlatDocument::AddShape(SVGElement::Type type, std::uint32_t id, std::uint32_t style,
+                                            std::uint32_t transform, std::uint32_t shapeTransform,
+                                            const float* values, std::uint32_t count) {
+    std::uint32_t data = static_cast<std::uint32_t>(params.size());
+    params.insert(params.end(), values, values + count);
+    return AddNode(type, id, style, transform, shapeTransform, data);
+}
+
+inline std::uint32_t FlatDocument::AddPath(std::uint32_t id, std::uint32_t style, std::uint32_t transform,
+                                           std::uint32_t shapeTransform,
+                                           std::uint32_t firstVerb, std::uint32_t firstPoint) {
+    PathRange range;
+    range.firstVerb = firstVerb;
+    range.verbCount = static_cast<std::uint32_t>(verbs.size()) - firstVerb;
+    range.firstPoint = firstPoint;
+    std::uint32_t data = static_cast<std::uint32_t>(paths.size());
+    paths.push_back(range);
+    return AddNode(SVGElement::Type::Path, id, style, transform, shapeTransform, data);
+}
+
+inline std::uint32_t FlatDocument::AddText(std::uint32_t id, std::uint32_t style, std::uint32_t transform,
+                                           std::uint32_t shapeTransform, const TextRun& text) {
+    std::uint32_t data = static_cast<std::uint32_t>(texts.size());
+    texts.push_back(text);
+    return AddNode(SVGElement::Type::Text, id, style, transform, shapeTransform, data);
+}
+
+inline void FlatDocument::Finish() {
+    _uidBase = nodes.Size() > 0 ? SVGElement::NextUid(nodes.Size()) : 0;
+    // The build indexes are not needed for rendering
+    _transformIndex = {};
+    _styleIndex = {};
+}
+
+inline void FlatDocument::MapPathPools(std::shared_ptr<const MappedFile> file,
+                                       std::span<const std::uint8_t> verbPool,
+                                       std::span<const Point2D> pointPool) {
+    verbs = {};
+    points = {};
+    _mapping = std::move(file);
+    _mappedVerbs = verbPool;
+    _mappedPoints = pointPool;
+}
+
+inline size_t FlatDocument::MemoryBytes() const {
+    size_t bytes = Capacity(nodes.type) + Capacity(nodes.id) + Capacity(nodes.style) +
+                   Capacity(nodes.transform) + Capacity(nodes.shapeTransform) + Capacity(nodes.data);
+    bytes += Capacity(transforms) + Capacity(styles) + Capacity(paints) + Capacity(dashes) + Capacity(verbs) +
+             Capacity(points) + Capacity(paths) + Capacity(texts) + Capacity(params);
+    return bytes + strings.MemoryBytes() + viewBox.capacity();
+}
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,312 @@
+#pragma once
+
+#include "SVG.h"
+#include "SVGParser.h"
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// SVGWriter - SVGDocument back to SVG text for the code editor
+//
+// Elements are appended straight into a caller-owned string, so a buffer
+// kept across calls is rewritten without reallocating. Numbers are
+// formatted with std::to_chars, which gives the shortest text that parses
+// back to the same float.
+//
+// The written document can come with an SVGSourceMap: one root group and
+// each element's span. With it, an element that changed is rewritten in
+// place (SpliceElement) instead of writing the whole document again, and
+// the editor can parse single-element text edits against the same map.
+//
+// Only the attributes the editor changes are written: geometry, id, fill,
+// stroke and stroke width. Group elements have no markup. Strings are
+// escaped, as XmlReader decodes entities when parsing them back.
+//=============================================================================
+class SVGWriter {
+public:
+    // out is replaced by the document. Returns false if an element has no
+    // markup; the source map is then left empty, as its spans could not
+    // line up with the elements
+    bool WriteDocument(const SVGDocument& document, std::string& out, SVGSourceMap* sourceMap = nullptr);
+
+    // Appends the markup of one element, from '<' to the closing '>';
+    // false, with nothing appended, for elements that have none
+    static bool WriteElement(const SVGElement& element, std::string& out);
+
+    // Rewrites the span of element index in text with element's markup and
+    // moves the spans after it. False if the map has no such span or the
+    // element has no markup; text is then unchanged
+    bool SpliceElement(const SVGElement& element, size_t index, std::string& text, SVGSourceMap& sourceMap);
+
+private:
+    std::string _markup;    // SpliceElement's new markup, kept for its capacity
+
+    static void AppendNumber(std::string& out, float value);
+    static void AppendInt(std::string& out, int value);
+    // Escapes & < and, in attribute values, > and '"'
+    static void AppendEscaped(std::string& out, std::string_view text, bool attribute);
+    // name="value" with a leading space
+    static void AppendAttribute(std::string& out, std::string_view name, float value);
+    static void AppendAttribute(std::string& out, std::string_view name, std::string_view value);
+    // name="rgb(r,g,b)", channels truncated to 0-255 as the editor has always written them
+    static void AppendColor(std::string& out, std::string_view name, const glm::vec4& color);
+    static void AppendStyle(std::string& out, const SVGStyle& style);
+    static void AppendPathData(std::string& out, const std::vector<PathCommand>& commands);
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline void SVGWriter::AppendNumber(std::string& out, float value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+inline void SVGWriter::AppendInt(std::string& out, int value) {
+    char buffer[16];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+inline void SVGWriter::AppendEscaped(std::string& out, std::string_view text, bool attribute) {
+    size_t run = 0;     // Start of the characters not yet appended
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char* entity;
+        switch (text[i]) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': if (!attribute) continue; entity = "&gt;"; break;
+            case '"': if (!attribute) continue; entity = "&quot;"; break;
+            default: continue;
+        }
+        out.append(text.data() + run, i - run);
+        out += entity;
+        run = i + 1;
+    }
+    out.append(text.data() + run, text.size() - run);
+}
+
+inline void SVGWriter::AppendAttribute(std::string& out, std::string_view name, float value) {
+    out += ' ';
+    out += name;
+    out += "=\"";
+    AppendNumber(out, value);
+    out += '"';
+}
+
+inline void SVGWriter::AppendAttribute(std::string& out, std::string_view name, std::string_view value) {
+    out += ' ';
+    out += name;
+    out += "=\"";
+    AppendEscaped(out, value, true);
+    out += '"';
+}
+
+inline void SVGWriter::AppendColor(std::string& out, std::string_view name, const glm::vec4& color) {
+    out += ' ';
+    out += name;
+    out += "=\"rgb(";
+    AppendInt(out, static_cast<int>(color.r * 255));
+    out += ',';
+    AppendInt(out, static_cast<int>(color.g * 255));
+    out += ',';
+    AppendInt(out, static_cast<int>(color.b * 255));
+    out += ")\"";
+}
+
+inline void SVGWriter::AppendStyle(std::string& out, const SVGStyle& style) {
+    if (style.fillColor) AppendColor(out, "fill", *style.fillColor);
+    if (style.strokeColor) AppendColor(out, "stroke", *style.strokeColor);
+    if (style.strokeWidth) AppendAttribute(out, "stroke-width", *style.strokeWidth);
+}
+
+inline void SVGWriter::AppendPathData(std::string& out, const std::vector<PathCommand>& commands) {
+    auto point = [&out](const Point2D& p) {
+        AppendNumber(out, p.x);
+        out += ' ';
+        AppendNumber(out, p.y);
+        out += ' ';
+    };
+    for (const auto& cmd : commands) {
+        switch (cmd.type) {
+            case PathCommandType::MoveTo:
+                out += "M ";
+                point(cmd.points[0]);
+                break;
+            case PathCommandType::LineTo:
+                out += "L ";
+                point(cmd.points[0]);
+                break;
+            case PathCommandType::CurveTo:
+                if (cmd.points.size() >= 3) {
+                    out += "C ";
+                    point(cmd.points[0]);
+                    point(cmd.points[1]);
+                    point(cmd.points[2]);
+                }
+                break;
+            case PathCommandType::QuadCurveTo:
+                if (cmd.points.size() >= 2) {
+                    out += "Q ";
+                    point(cmd.points[0]);
+                    point(cmd.points[1]);
+                }
+                break;
+            case PathCommandType::ClosePath:
+                out += "Z ";
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+inline bool SVGWriter::WriteElement(const SVGElement& element, std::string& out) {
+    switch (element.type) {
+        case SVGElement::Type::Rect: {
+            const SVGRect& rect = element.rect;
+            out += "<rect";
+            if (!rect.id.empty()) AppendAttribute(out, "id", rect.id);
+            AppendAttribute(out, "x", rect.position.x);
+            AppendAttribute(out, "y", rect.position.y);
+            AppendAttribute(out, "width", rect.width);
+            AppendAttribute(out, "height", rect.height);
+            AppendStyle(out, rect.style);
+            out += "/>";
+            return true;
+        }
+
+        case SVGElement::Type::Circle: {
+            const SVGCircle& circle = element.circle;
+            out += "<circle";
+            if (!circle.id.empty()) AppendAttribute(out, "id", circle.id);
+            AppendAttribute(out, "cx", circle.center.x);
+            AppendAttribute(out, "cy", circle.center.y);
+            AppendAttribute(out, "r", circle.radius);
+            AppendStyle(out, circle.style);
+            out += "/>";
+            return true;
+        }
+
+        case SVGElement::Type::Line: {
+            const SVGLine& line = element.line;
+            out += "<line";
+            if (!line.id.empty()) AppendAttribute(out, "id", line.id);
+            AppendAttribute(out, "x1", line.start.x);
+            AppendAttribute(out, "y1", line.start.y);
+            AppendAttribute(out, "x2", line.end.x);
+            AppendAttribute(out, "y2", line.end.y);
+            // Lines have no fill
+            if (line.style.strokeColor) AppendColor(out, "stroke", *line.style.strokeColor);
+            if (line.style.strokeWidth) AppendAttribute(out, "stroke-width", *line.style.strokeWidth);
+            out += "/>";
+            return true;
+        }
+
+        case SVGElement::Type::Path: {
+            const SVGPath& path = element.path;
+            out += "<path";
+            if (!path.id.empty()) AppendAttribute(out, "id", path.id);
+            out += " d=\"";
+            AppendPathData(out, path.commands);
+            out += '"';
+            if (path.style.fillNone) {
+                out += " fill=\"none\"";
+            } else if (path.style.fillColor) {
+                AppendColor(out, "fill", *path.style.fillColor);
+            }
+            if (path.style.strokeColor) AppendColor(out, "stroke", *path.style.strokeColor);
+            if (path.style.strokeWidth) AppendAttribute(out, "stroke-width", *path.style.strokeWidth);
+            out += "/>";
+            return true;
+        }
+
+        case SVGElement::Type::Ellipse: {
+            const SVGEllipse& ellipse = element.ellipse;
+            out += "<ellipse";
+            if (!ellipse.id.empty()) AppendAttribute(out, "id", ellipse.id);
+            AppendAttribute(out, "cx", ellipse.center.x);
+            AppendAttribute(out, "cy", ellipse.center.y);
+            AppendAttribute(out, "rx", ellipse.rx);
+            AppendAttribute(out, "ry", ellipse.ry);
+            AppendStyle(out, ellipse.style);
+            out += "/>";
+            return true;
+        }
+
+        case SVGElement::Type::Text: {
+            const SVGText& text = element.text;
+            out += "<text";
+            if (!text.id.empty()) AppendAttribute(out, "id", text.id);
+            AppendAttribute(out, "x", text.position.x);
+            AppendAttribute(out, "y", text.position.y);
+            if (text.fontSize > 0) AppendAttribute(out, "font-size", text.fontSize);
+            if (!text.fontFamily.empty()) AppendAttribute(out, "font-family", text.fontFamily);
+            AppendStyle(out, text.style);
+            out += '>';
+            AppendEscaped(out, text.text, false);
+            out += "</text>";
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+inline bool SVGWriter::WriteDocument(const SVGDocument& document, std::string& out, SVGSourceMap* sourceMap) {
+    out.clear();
+    out += "<svg";
+    AppendAttribute(out, "width", document.width);
+    AppendAttribute(out, "height", document.height);
+    if (!document.viewBox.empty()) AppendAttribute(out, "viewBox", document.viewBox);
+    out += " xmlns=\"http://www.w3.org/2000/svg\">\n";
+
+    if (sourceMap) {
+        // Nothing is inherited: elements sit directly in the root
+        sourceMap->Clear();
+        sourceMap->groups.emplace_back();
+        sourceMap->spans.reserve(document.elements.size());
+    }
+
+    bool complete = true;
+    for (const auto& element : document.elements) {
+        out += "  ";
+        size_t begin = out.size();
+        if (WriteElement(element, out)) {
+            if (sourceMap) sourceMap->spans.push_back({ begin, out.size(), 0 });
+        } else {
+            out.resize(begin - 2);
+            complete = false;
+            continue;
+        }
+        out += '\n';
+    }
+    out += "</svg>";
+
+    if (!complete && sourceMap) sourceMap->Clear();
+    return complete;
+}
+
+inline bool SVGWriter::SpliceElement(const SVGElement& element, size_t index, std::string& text,
+                                     SVGSourceMap& sourceMap) {
+    if (index >= sourceMap.spans.size()) return false;
+    const SVGSourceMap::Span& span = sourceMap.spans[index];
+    if (span.end > text.size()) return false;
+
+    _markup.clear();
+    if (!WriteElement(element, _markup)) return false;
+
+    size_t length = span.end - span.begin;
+    text.replace(span.begin, length, _markup);
+    sourceMap.Resize(index, static_cast<std::ptrdiff_t>(_markup.size()) - static_cast<std::ptrdiff_t>(length));
+    return true;
+}
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Core/Math2D.h"
+#include <cstdint>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// FlattenedPath - Polylines of a flattened path
+//
+// All contours share one point buffer; contours index into it. Clear() keeps
+// the capacity so the same object can be refilled without allocating.
+//=============================================================================
+struct FlattenedContour {
+    std::uint32_t start;    // First point in FlattenedPath::points
+    std::uint32_t count;    // Number of points (>= 2)
+    bool closed;            // Ended with ClosePath
+};
+
+struct FlattenedPath {
+    std::vector<Vec2> points;
+    std::vector<FlattenedContour> contours;
+
+    void Clear() {
+        points.clear();
+        contours.clear();
+    }
+
+    bool IsEmpty() const { return contours.empty(); }
+
+    const Vec2* ContourPoints(const FlattenedContour& contour) const {
+        return points.data() + contour.start;
+    }
+
+    // Append a contour (fewer than 2 points is ignored)
+    void AddContour(const std::vector<Vec2>& contour, bool closed) {
+        if (contour.size() < 2) return;
+        contours.push_back({static_cast<std::uint32_t>(points.size()),
+                            static_cast<std::uint32_t>(contour.size()), closed});
+        points.insert(points.end(), contour.begin(), contour.end());
+    }
+
+    void Translate(const Vec2& offset) {
+        for (auto& p : points) p += offset;
+    }
+};
+
+} // namespace VCX::Labs::SVG
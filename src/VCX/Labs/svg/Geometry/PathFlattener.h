@@ -0,0 +1,176 @@
+#pragma once
+
+#include "SVG.h"
+#include "Core/Math2D.h"
+#include "Core/Bezier.h"
+#include "Geometry/FlattenedPath.h"
+#include "Geometry/ShapeView.h"
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// PathFlattener - SVG path commands to device-space polylines
+//
+// Single pass over the commands: relative coordinates are resolved, curves
+// and arcs are tessellated straight into the output buffer and transformed in
+// place. Curves are flattened in user space with the given tolerance.
+//=============================================================================
+class PathFlattener {
+public:
+    // Replace output with the flattened path (output capacity is reused)
+    void Flatten(const SVGPath& path, const Matrix3x3& transform,
+                 float tolerance, FlattenedPath& output);
+    void Flatten(const PathView& path, const Matrix3x3& transform,
+                 float tolerance, FlattenedPath& output);
+
+private:
+    std::vector<Vec2> _arcControls;     // Scratch for arc-to-cubic conversion
+
+    // Either command form: PathCommand vector or PathView
+    template <typename Commands>
+    void FlattenCommands(const Commands& commands, const Matrix3x3& transform,
+                         float tolerance, FlattenedPath& output);
+
+    static void TransformTail(FlattenedPath& output, size_t from, const Matrix3x3& transform);
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline void PathFlattener::TransformTail(FlattenedPath& output, size_t from, const Matrix3x3& transform) {
+    for (size_t i = from; i < output.points.size(); ++i) {
+        output.points[i] = transform.TransformPoint(output.points[i]);
+    }
+}
+
+inline void PathFlattener::Flatten(const SVGPath& path, const Matrix3x3& transform,
+                                   float tolerance, FlattenedPath& output) {
+    FlattenCommands(path.commands, transform, tolerance, output);
+}
+
+inline void PathFlattener::Flatten(const PathView& path, const Matrix3x3& transform,
+                                   float tolerance, FlattenedPath& output) {
+    FlattenCommands(path, transform, tolerance, output);
+}
+
+template <typename Commands>
+inline void PathFlattener::FlattenCommands(const Commands& commands, const Matrix3x3& transform,
+                                           float tolerance, FlattenedPath& output) {
+    output.Clear();
+
+    size_t contourStart = 0;
+    bool closed = false;
+    Vec2 currentPos(0, 0);
+    Vec2 startPos(0, 0);
+
+    // Contours with fewer than 2 points are dropped
+    auto endContour = [&]() {
+        size_t count = output.points.size() - contourStart;
+        if (count >= 2) {
+            output.contours.push_back({static_cast<std::uint32_t>(contourStart),
+                                       static_cast<std::uint32_t>(count), closed});
+        } else {
+            output.points.resize(contourStart);
+        }
+        contourStart = output.points.size();
+        closed = false;
+    };
+
+    for (const auto& cmd : commands) {
+        auto resolve = [&](size_t i) {
+            Vec2 p(cmd.points[i].x, cmd.points[i].y);
+            return cmd.relative ? currentPos + p : p;
+        };
+
+        switch (cmd.type) {
+            case PathCommandType::MoveTo: {
+                endContour();
+                if (!cmd.points.empty()) {
+                    Vec2 target = resolve(0);
+                    currentPos = target;
+                    startPos = target;
+                    output.points.push_back(transform.TransformPoint(target));
+                }
+                break;
+            }
+
+            case PathCommandType::LineTo: {
+                if (!cmd.points.empty()) {
+                    Vec2 target = resolve(0);
+                    currentPos = target;
+                    output.points.push_back(transform.TransformPoint(target));
+                }
+                break;
+            }
+
+            case PathCommandType::CurveTo: {
+                if (cmd.points.size() >= 3) {
+                    Vec2 p1 = resolve(0);
+                    Vec2 p2 = resolve(1);
+                    Vec2 p3 = resolve(2);
+
+                    size_t from = output.points.size();
+                    Bezier::TessellateCubicAdaptive(currentPos, p1, p2, p3, tolerance, output.points);
+                    TransformTail(output, from, transform);
+                    currentPos = p3;
+                }
+                break;
+            }
+
+            case PathCommandType::QuadCurveTo: {
+                if (cmd.points.size() >= 2) {
+                    Vec2 p1 = resolve(0);
+                    Vec2 p2 = resolve(1);
+
+                    size_t from = output.points.size();
+                    Bezier::TessellateQuadraticAdaptive(currentPos, p1, p2, tolerance, output.points);
+                    TransformTail(output, from, transform);
+                    currentPos = p2;
+                }
+                break;
+            }
+
+            case PathCommandType::ArcTo: {
+                if (cmd.points.size() >= 2) {
+                    Vec2 target = resolve(1);
+                    float rx = std::abs(cmd.points[0].x);
+                    float ry = std::abs(cmd.points[0].y);
+
+                    size_t from = output.points.size();
+                    if (rx > 0 && ry > 0) {
+                        _arcControls.clear();
+                        Bezier::ArcToCubics(currentPos, rx, ry, 0, false, true, target, _arcControls);
+
+                        Vec2 cp0 = currentPos;
+                        for (size_t i = 0; i + 2 < _arcControls.size(); i += 3) {
+                            Bezier::TessellateCubicAdaptive(cp0, _arcControls[i], _arcControls[i + 1],
+                                                            _arcControls[i + 2], tolerance, output.points);
+                            cp0 = _arcControls[i + 2];
+                        }
+                    }
+                    output.points.push_back(target);
+                    TransformTail(output, from, transform);
+                    currentPos = target;
+                }
+                break;
+            }
+
+            case PathCommandType::ClosePath: {
+                currentPos = startPos;
+                closed = true;
+                Vec2 start = transform.TransformPoint(startPos);
+                if (output.points.size() > contourStart &&
+                    DistanceSquared(output.points.back(), start) > 1e-4f) {
+                    output.points.push_back(start);
+                }
+                break;
+            }
+        }
+    }
+
+    endContour();
+}
+
+} // namespace VCX::Labs::SVG
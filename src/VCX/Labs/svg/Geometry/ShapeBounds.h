@@ -0,0 +1,155 @@
+#pragma once
+
+#include "SVG.h"
+#include "Core/Math2D.h"
+#include "Geometry/ShapeView.h"
+#include "Geometry/StrokeExpander.h"
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// ExpandPathHull - Add the control points of path commands to a box
+//
+// Commands are PathCommands or a PathView. Curves lie inside the hull of
+// their control points; arcs add a box around their endpoints that contains
+// the ellipse.
+//=============================================================================
+template <typename Commands>
+inline void ExpandPathHull(const Commands& commands, BBox& local) {
+    Vec2 currentPos(0, 0);
+    Vec2 startPos(0, 0);
+    for (const auto& cmd : commands) {
+        auto resolve = [&](size_t i) {
+            Vec2 p(cmd.points[i].x, cmd.points[i].y);
+            return cmd.relative ? currentPos + p : p;
+        };
+        switch (cmd.type) {
+            case PathCommandType::MoveTo:
+            case PathCommandType::LineTo:
+                if (!cmd.points.empty()) {
+                    currentPos = resolve(0);
+                    if (cmd.type == PathCommandType::MoveTo) startPos = currentPos;
+                    local.Expand(currentPos);
+                }
+                break;
+            case PathCommandType::CurveTo:
+            case PathCommandType::QuadCurveTo: {
+                size_t count = cmd.type == PathCommandType::CurveTo ? 3 : 2;
+                if (cmd.points.size() >= count) {
+                    Vec2 end = resolve(count - 1);
+                    for (size_t i = 0; i < count; ++i) local.Expand(resolve(i));
+                    currentPos = end;
+                }
+                break;
+            }
+            case PathCommandType::ArcTo: {
+                if (cmd.points.size() >= 2) {
+                    Vec2 target = resolve(1);
+                    float rx = std::abs(cmd.points[0].x);
+                    float ry = std::abs(cmd.points[0].y);
+                    // Radii too small for the chord are scaled up (SVG F.6.6);
+                    // no point of the ellipse is farther than 2r from an endpoint
+                    Vec2 half = (currentPos - target) * 0.5f;
+                    if (rx > 0 && ry > 0) {
+                        float lambda = half.x * half.x / (rx * rx) + half.y * half.y / (ry * ry);
+                        float radius = std::max(rx, ry) * std::max(1.0f, std::sqrt(lambda));
+                        BBox arc;
+                        arc.Expand(currentPos);
+                        arc.Expand(target);
+                        arc.Expand(2.0f * radius);
+                        local.Expand(arc);
+                    }
+                    local.Expand(target);
+                    currentPos = target;
+                }
+                break;
+            }
+            case PathCommandType::ClosePath:
+                currentPos = startPos;
+                break;
+        }
+    }
+}
+
+//=============================================================================
+// EstimateShapeBounds - Conservative device-space bounds of a shape
+//
+// Computed from control points (curves lie inside their hull), radii and the
+// stroke width, without flattening anything; matches how SVGRendererV2 builds
+// the geometry. Used for view culling and as hit-test bounds.
+//=============================================================================
+inline BBox EstimateShapeBounds(const ShapeView& shape, const Matrix3x3& transform,
+                                const StrokeStyle* strokeStyle) {
+    BBox local;     // Transformed by its corners (exact for the hull under an affine map)
+    BBox device;    // Already in device space
+    float scale = transform.GetScaleFactor();
+
+    switch (shape.type) {
+        case SVGElement::Type::Path:
+            if (shape.path) {
+                ExpandPathHull(shape.path->commands, local);
+            } else {
+                ExpandPathHull(shape.verbs, local);
+            }
+            break;
+
+        case SVGElement::Type::Circle: {
+            // Drawn as a device-space circle of radius r * scale
+            Vec2 center = transform.TransformPoint(Vec2(shape.point.x, shape.point.y));
+            device.Expand(center);
+            device.Expand(shape.rx * scale);
+            break;
+        }
+
+        case SVGElement::Type::Ellipse: {
+            Vec2 center = transform.TransformPoint(Vec2(shape.point.x, shape.point.y));
+            device.Expand(center - Vec2(shape.rx, shape.ry) * scale);
+            device.Expand(center + Vec2(shape.rx, shape.ry) * scale);
+            break;
+        }
+
+        case SVGElement::Type::Rect: {
+            local.Expand(Vec2(shape.point.x, shape.point.y));
+            local.Expand(Vec2(shape.point.x + shape.width, shape.point.y + shape.height));
+            break;
+        }
+
+        case SVGElement::Type::Line:
+            local.Expand(Vec2(shape.point.x, shape.point.y));
+            local.Expand(Vec2(shape.point2.x, shape.point2.y));
+            break;
+
+        case SVGElement::Type::Text: {
+            // Placeholder marker of BuildGeometry
+            device.Expand(transform.TransformPoint(Vec2(shape.point.x, shape.point.y)));
+            device.Expand(3.0f);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    if (local.IsValid()) {
+        device.Expand(transform.TransformPoint(local.min));
+        device.Expand(transform.TransformPoint(Vec2(local.max.x, local.min.y)));
+        device.Expand(transform.TransformPoint(local.max));
+        device.Expand(transform.TransformPoint(Vec2(local.min.x, local.max.y)));
+    }
+
+    if (strokeStyle && device.IsValid()) {
+        // Miter joins reach miterLimit half-widths out, square caps sqrt(2)
+        float reach = strokeStyle->lineJoin == LineJoin::Miter ? std::max(strokeStyle->miterLimit, 1.5f) : 1.5f;
+        device.Expand(strokeStyle->HalfWidth() * reach);
+    }
+    return device;
+}
+
+inline BBox EstimateShapeBounds(const SVGElement& element, const Matrix3x3& transform,
+                                const StrokeStyle* strokeStyle) {
+    return EstimateShapeBounds(ShapeView::Of(element), transform, strokeStyle);
+}
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "SVG.h"
+#include "Core/Math2D.h"
+#include "Geometry/FlattenedPath.h"
+#include "Geometry/PathFlattener.h"
+#include "Geometry/ShapeBounds.h"
+#include "Geometry/StrokeExpander.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// ShapeHitTester - Precise point-in-shape test on flattened geometry
+//
+// The shape is flattened the way SVGRendererV2 draws it. A point hits when it
+// is inside the fill (by the fill rule; open contours are closed, as for
+// filling) or within half the stroke width of the outline, both widened by a
+// tolerance in device pixels so thin shapes stay easy to pick. Text has no
+// geometry yet and is hit by its estimated box.
+//=============================================================================
+class ShapeHitTester {
+public:
+    // parent: element to device space (view * element.transform); the
+    // shape's own transform and style are taken from the element
+    bool Hit(const SVGElement& element, const Matrix3x3& parent, const Vec2& point, float tolerance);
+
+    // Device bounds that contain every point Hit can accept (invalid for groups)
+    BBox Bounds(const SVGElement& element, const Matrix3x3& parent, float tolerance) const;
+
+private:
+    PathFlattener _flattener;
+    FlattenedPath _path;
+    std::vector<Vec2> _contour;
+
+    // Shape style and full device transform, false for non-shapes
+    static bool Resolve(const SVGElement& element, const Matrix3x3& parent,
+                        const SVGStyle*& style, Matrix3x3& transform);
+    // Stroke half width in device units, 0 if not stroked
+    static float StrokeHalfWidth(const SVGElement& element, const SVGStyle& style, const Matrix3x3& transform);
+    void BuildOutline(const SVGElement& element, const Matrix3x3& transform);
+    static void TextBox(const SVGElement& element, const Matrix3x3& transform, Vec2 corners[4]);
+    static bool Inside(const FlattenedPath& path, const Vec2& point, bool evenOdd);
+    static float DistanceToOutline(const FlattenedPath& path, const Vec2& point);
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline bool ShapeHitTester::Resolve(const SVGElement& element, const Matrix3x3& parent,
+                                     const SVGStyle*& style, Matrix3x3& transform) {
+    const Transform2D* shapeTransform;
+    switch (element.type) {
+        case SVGElement::Type::Path:    style = &element.path.style;    shapeTransform = &element.path.transform;    break;
+        case SVGElement::Type::Circle:  style = &element.circle.style;  shapeTransform = &element.circle.transform;  break;
+        case SVGElement::Type::Ellipse: style = &element.ellipse.style; shapeTransform = &element.ellipse.transform; break;
+        case SVGElement::Type::Rect:    style = &element.rect.style;    shapeTransform = &element.rect.transform;    break;
+        case SVGElement::Type::Line:    style = &element.line.style;    shapeTransform = &element.line.transform;    break;
+        case SVGElement::Type::Text:    style = &element.text.style;    shapeTransform = &element.text.transform;    break;
+        default: return false;
+    }
+    transform = parent * Matrix3x3::FromGlm(shapeTransform->matrix);
+    return true;
+}
+
+inline float ShapeHitTester::StrokeHalfWidth(const SVGElement& element, const SVGStyle& style,
+                                             const Matrix3x3& transform) {
+    if (!style.strokeColor || style.strokeNone || element.type == SVGElement::Type::Text) return 0;
+    float width = style.strokeWidth.value_or(1.0f);
+    // As in the renderer: path stroke widths are used as is, others are scaled
+    if (element.type != SVGElement::Type::Path) width *= transform.GetScaleFactor();
+    return width * 0.5f;
+}
+
+inline void ShapeHitTester::TextBox(const SVGElement& element, const Matrix3x3& transform, Vec2 corners[4]) {
+    // Same estimate as the editor's selection box
+    const SVGText& text = element.text;
+    float w = text.text.length() * text.fontSize * 0.6f;
+    float h = text.fontSize;
+    Vec2 pos(text.position.x, text.position.y);
+    corners[0] = transform.TransformPoint(pos);
+    corners[1] = transform.TransformPoint(pos + Vec2(w, 0));
+    corners[2] = transform.TransformPoint(pos + Vec2(w, h));
+    corners[3] = transform.TransformPoint(pos + Vec2(0, h));
+}
+
+inline BBox ShapeHitTester::Bounds(const SVGElement& element, const Matrix3x3& parent, float tolerance) const {
+    BBox bounds;
+    const SVGStyle* style;
+    Matrix3x3 transform;
+    if (!Resolve(element, parent, style, transform)) return bounds;
+
+    if (element.type == SVGElement::Type::Text) {
+        Vec2 corners[4];
+        TextBox(element, transform, corners);
+        for (const auto& c : corners) bounds.Expand(c);
+    } else {
+        StrokeStyle stroke;
+        stroke.width = 2.0f * StrokeHalfWidth(element, *style, transform);
+        bounds = EstimateShapeBounds(element, transform, stroke.width > 0 ? &stroke : nullptr);
+    }
+    if (bounds.IsValid()) bounds.Expand(tolerance);
+    return bounds;
+}
+
+inline void ShapeHitTester::BuildOutline(const SVGElement& element, const Matrix3x3& transform) {
+    constexpr float c_Pi = 3.14159265359f;
+    float scale = transform.GetScaleFactor();
+    _path.Clear();
+    _contour.clear();
+
+    auto ellipse = [&](const Vec2& center, float rx, float ry) {
+        for (int i = 0; i < 64; ++i) {
+            float angle = 2.0f * c_Pi * i / 64;
+            _contour.push_back(center + Vec2(std::cos(angle) * rx, std::sin(angle) * ry));
+        }
+        _path.AddContour(_contour, true);
+    };
+
+    switch (element.type) {
+        case SVGElement::Type::Path:
+            _flattener.Flatten(element.path, transform, 0.5f, _path);
+            break;
+
+        case SVGElement::Type::Circle: {
+            Vec2 center = transform.TransformPoint(Vec2(element.circle.center.x, element.circle.center.y));
+            ellipse(center, element.circle.radius * scale, element.circle.radius * scale);
+            break;
+        }
+
+        case SVGElement::Type::Ellipse: {
+            Vec2 center = transform.TransformPoint(Vec2(element.ellipse.center.x, element.ellipse.center.y));
+            ellipse(center, element.ellipse.rx * scale, element.ellipse.ry * scale);
+            break;
+        }
+
+        case SVGElement::Type::Rect: {
+            const SVGRect& rect = element.rect;
+            float rx = std::min(rect.rx > 0 ? rect.rx : rect.ry, rect.width * 0.5f);
+            float ry = std::min(rect.ry > 0 ? rect.ry : rect.rx, rect.height * 0.5f);
+            if (rx > 0 && ry > 0) {
+                // Quarter arcs around the four corner centers
+                const Vec2 centers[4] = {
+                    Vec2(rect.position.x + rect.width - rx, rect.position.y + ry),
+                    Vec2(rect.position.x + rect.width - rx, rect.position.y + rect.height - ry),
+                    Vec2(rect.position.x + rx, rect.position.y + rect.height - ry),
+                    Vec2(rect.position.x + rx, rect.position.y + ry)
+                };
+                for (int corner = 0; corner < 4; ++corner) {
+                    for (int i = 0; i <= 8; ++i) {
+                        float angle = c_Pi * 0.5f * (corner - 1) + c_Pi * 0.5f * i / 8;
+                        Vec2 p = centers[corner] + Vec2(std::cos(angle) * rx, std::sin(angle) * ry);
+                        _contour.push_back(transform.TransformPoint(p));
+                    }
+                }
+            } else {
+                _contour.push_back(transform.TransformPoint(Vec2(rect.position.x, rect.position.y)));
+                _contour.push_back(transform.TransformPoint(Vec2(rect.position.x + rect.width, rect.position.y)));
+                _contour.push_back(transform.TransformPoint(Vec2(rect.position.x + rect.width, rect.position.y + rect.height)));
+                _contour.push_back(transform.TransformPoint(Vec2(rect.position.x, rect.position.y + rect.height)));
+            }
+            _path.AddContour(_contour, true);
+            break;
+        }
+
+        case SVGElement::Type::Line:
+            _contour.push_back(transform.TransformPoint(Vec2(element.line.start.x, element.line.start.y)));
+            _contour.push_back(transform.TransformPoint(Vec2(element.line.end.x, element.line.end.y)));
+            _path.AddContour(_contour, false);
+            break;
+
+        case SVGElement::Type::Text: {
+            Vec2 corners[4];
+            TextBox(element, transform, corners);
+            _contour.assign(corners, corners + 4);
+            _path.AddContour(_contour, true);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+inline bool ShapeHitTester::Inside(const FlattenedPath& path, const Vec2& point, bool evenOdd) {
+    int winding = 0;
+    for (const auto& contour : path.contours) {
+        const Vec2* points = path.ContourPoints(contour);
+        for (std::uint32_t i = 0; i < contour.count; ++i) {
+            const Vec2& a = points[i];
+            const Vec2& b = points[(i + 1) % contour.count];     // Always closed for filling
+            if (a.y <= point.y) {
+                if (b.y > point.y && Cross(b - a, point - a) > 0) ++winding;
+            } else {
+                if (b.y <= point.y && Cross(b - a, point - a) < 0) --winding;
+            }
+        }
+    }
+    return evenOdd ? (winding & 1) != 0 : winding != 0;
+}
+
+inline float ShapeHitTester::DistanceToOutline(const FlattenedPath& path, const Vec2& point) {
+    float best = std::numeric_limits<float>::max();
+    for (const auto& contour : path.contours) {
+        const Vec2* points = path.ContourPoints(contour);
+        std::uint32_t segments = contour.closed ? contour.count : contour.count - 1;
+        for (std::uint32_t i = 0; i < segments; ++i) {
+            const Vec2& a = points[i];
+            const Vec2& b = points[(i + 1) % contour.count];
+            Vec2 ab = b - a;
+            float lengthSq = Dot(ab, ab);
+            float t = lengthSq > 0 ? std::clamp(Dot(point - a, ab) / lengthSq, 0.0f, 1.0f) : 0.0f;
+            best = std::min(best, Distance(point, a + ab * t));
+        }
+    }
+    return best;
+}
+
+inline bool ShapeHitTester::Hit(const SVGElement& element, const Matrix3x3& parent,
+                                const Vec2& point, float tolerance) {
+    const SVGStyle* style;
+    Matrix3x3 transform;
+    if (!Resolve(element, parent, style, transform)) return false;
+
+    BuildOutline(element, transform);
+    if (_path.IsEmpty()) return false;
+
+    // Text and lines have no fill area of their own
+    bool filled = element.type == SVGElement::Type::Text ||
+                  (!style->fillNone && element.type != SVGElement::Type::Line);
+    bool evenOdd = element.type == SVGElement::Type::Path && style->fillRule == SVGFillRule::EvenOdd;
+    if (filled && Inside(_path, point, evenOdd)) return true;
+
+    // Near the outline: the stroke, or a thin/unfilled shape within tolerance
+    return DistanceToOutline(_path, point) <= StrokeHalfWidth(element, *style, transform) + tolerance;
+}
+
+} // namespace VCX::Labs::SVG
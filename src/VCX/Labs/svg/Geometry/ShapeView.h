@@ -0,0 +1,141 @@
+#pragma once
+
+#include "SVG.h"
+#include <cstdint>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// PathView - Path commands packed as one verb byte each over a point pool
+//
+// A verb is a PathCommandType, with c_RelativeBit set for relative commands.
+// Its points follow those of the previous verb, in the layout of
+// PathCommand::points: one for MoveTo/LineTo, three for CurveTo, two for
+// QuadCurveTo and ArcTo (radii, end point), none for ClosePath. Iterating
+// yields commands with the same members as PathCommand, so geometry code can
+// take either form.
+//=============================================================================
+class PathView {
+public:
+    static constexpr std::uint8_t c_RelativeBit = 0x80;
+
+    static std::uint8_t Pack(PathCommandType type, bool relative) {
+        return static_cast<std::uint8_t>(type) | (relative ? c_RelativeBit : 0);
+    }
+    static PathCommandType TypeOf(std::uint8_t verb) {
+        return static_cast<PathCommandType>(verb & ~c_RelativeBit);
+    }
+    static std::uint32_t PointCount(PathCommandType type) {
+        switch (type) {
+            case PathCommandType::MoveTo:
+            case PathCommandType::LineTo:      return 1;
+            case PathCommandType::CurveTo:     return 3;
+            case PathCommandType::QuadCurveTo:
+            case PathCommandType::ArcTo:       return 2;
+            default:                           return 0;
+        }
+    }
+
+    struct Points {
+        const Point2D* data = nullptr;
+        std::uint32_t count = 0;
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const Point2D& operator[](size_t i) const { return data[i]; }
+    };
+
+    struct Command {
+        PathCommandType type;
+        bool relative;
+        Points points;
+    };
+
+    class Iterator {
+    public:
+        Iterator(const std::uint8_t* verb, const Point2D* points) : _verb(verb), _points(points) {}
+
+        Command operator*() const {
+            PathCommandType type = TypeOf(*_verb);
+            return { type, (*_verb & c_RelativeBit) != 0, { _points, PointCount(type) } };
+        }
+        Iterator& operator++() {
+            _points += PointCount(TypeOf(*_verb));
+            ++_verb;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return _verb != other._verb; }
+
+    private:
+        const std::uint8_t* _verb;
+        const Point2D* _points;
+    };
+
+    PathView() = default;
+    PathView(const std::uint8_t* verbs, std::uint32_t count, const Point2D* points)
+        : _verbs(verbs), _count(count), _points(points) {}
+
+    Iterator begin() const { return Iterator(_verbs, _points); }
+    Iterator end() const { return Iterator(_verbs + _count, nullptr); }
+    size_t size() const { return _count; }
+    bool empty() const { return _count == 0; }
+
+private:
+    const std::uint8_t* _verbs = nullptr;
+    std::uint32_t _count = 0;
+    const Point2D* _points = nullptr;
+};
+
+//=============================================================================
+// ShapeView - Geometry of one shape, whatever document holds it
+//
+// What BuildGeometry and EstimateShapeBounds read: paths refer to their
+// commands (SVGPath or packed), the other shapes carry their few parameters.
+//=============================================================================
+struct ShapeView {
+    SVGElement::Type type = SVGElement::Type::Group;
+    const SVGPath* path = nullptr;  // Path of an SVGElement...
+    PathView verbs;                 // ...or packed (FlatDocument)
+    Point2D point;                  // Circle/ellipse center, rect/text position, line start
+    Point2D point2;                 // Line end
+    float rx = 0, ry = 0;           // Circle radius (both), ellipse radii, rect corner radii
+    float width = 0, height = 0;    // Rect size
+
+    static ShapeView Of(const SVGElement& element) {
+        ShapeView shape;
+        shape.type = element.type;
+        switch (element.type) {
+            case SVGElement::Type::Path:
+                shape.path = &element.path;
+                break;
+            case SVGElement::Type::Circle:
+                shape.point = element.circle.center;
+                shape.rx = shape.ry = element.circle.radius;
+                break;
+            case SVGElement::Type::Ellipse:
+                shape.point = element.ellipse.center;
+                shape.rx = element.ellipse.rx;
+                shape.ry = element.ellipse.ry;
+                break;
+            case SVGElement::Type::Rect:
+                shape.point = element.rect.position;
+                shape.width = element.rect.width;
+                shape.height = element.rect.height;
+                shape.rx = element.rect.rx;
+                shape.ry = element.rect.ry;
+                break;
+            case SVGElement::Type::Line:
+                shape.point = element.line.start;
+                shape.point2 = element.line.end;
+                break;
+            case SVGElement::Type::Text:
+                shape.point = element.text.position;
+                break;
+            default:
+                break;
+        }
+        return shape;
+    }
+};
+
+} // namespace VCX::Labs::SVG
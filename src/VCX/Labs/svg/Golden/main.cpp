@@ -0,0 +1,377 @@
+//=============================================================================
+// svg-golden - Golden-image regression check for SVGRendererV2
+//
+// Renders every input with each AA mode and with the paths' fill rule forced
+// to nonzero and to evenodd, and compares the 8-bit result with a stored
+// reference PNG (max channel error and PSNR). Failing cases get the actual
+// image and an amplified diff image written next to each other.
+// --update (re)writes the references instead of comparing.
+//=============================================================================
+
+#include "Labs/svg/SVGParser.h"
+#include "Labs/svg/Renderer/SVGRendererV2.h"
+
+#include <stb_image.h>
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace VCX::Labs;
+using namespace VCX::Labs::SVG;
+
+namespace {
+
+    struct GoldenOptions {
+        std::vector<fs::path> inputs;           // Default: assets, assets/golden
+        fs::path reference = "assets/golden/reference";
+        fs::path diff = "golden-diff";
+        bool update = false;
+        int maxError = 2;                       // Largest allowed channel difference (0-255)
+        double minPSNR = 50.0;                  // dB, over all channels
+        unsigned threads = 1;
+        bool forceSimd = false;
+        SimdLevel simd = SimdLevel::Scalar;
+        bool quiet = false;
+    };
+
+    struct AAVariant {
+        const char* name;
+        bool enabled;
+        ScanlineRasterizer::AAMode mode;
+    };
+
+    const AAVariant c_AAVariants[] = {
+        { "none",       false, ScanlineRasterizer::AAMode::None },
+        { "4x",         true,  ScanlineRasterizer::AAMode::Coverage4x },
+        { "8x",         true,  ScanlineRasterizer::AAMode::Coverage8x },
+        { "16x",        true,  ScanlineRasterizer::AAMode::Coverage16x },
+        { "analytical", true,  ScanlineRasterizer::AAMode::Analytical },
+        { "area",       true,  ScanlineRasterizer::AAMode::AccumulatedArea },
+    };
+
+    struct FillRuleVariant {
+        const char* name;
+        SVGFillRule rule;
+    };
+
+    const FillRuleVariant c_FillRules[] = {
+        { "nonzero", SVGFillRule::NonZero },
+        { "evenodd", SVGFillRule::EvenOdd },
+    };
+
+    void PrintUsage() {
+        std::cout <<
+            "Usage: svg-golden [options] [input.svg | directory]...\n"
+            "\n"
+            "Inputs default to assets/ and assets/golden/.\n"
+            "\n"
+            "Options:\n"
+            "  -r, --reference <dir>   Reference PNG directory (default: assets/golden/reference)\n"
+            "  -d, --diff <dir>        Where failing cases are written (default: golden-diff)\n"
+            "  -u, --update            Write the references instead of comparing\n"
+            "      --max-error <n>     Largest allowed channel difference, 0-255 (default: 2)\n"
+            "      --min-psnr <dB>     Smallest allowed PSNR (default: 50)\n"
+            "  -t, --threads <n>       Parse/render threads: 1 = single-threaded, 0 = one per core (default: 1)\n"
+            "      --simd <level>      scalar | sse41 | avx2 | neon (default: detected)\n"
+            "  -q, --quiet             Only print failures and the summary\n"
+            "  -h, --help              Show this help\n";
+    }
+
+    bool ParseSimdLevel(const std::string& name, SimdLevel& level) {
+        if (name == "scalar")     level = SimdLevel::Scalar;
+        else if (name == "sse41") level = SimdLevel::SSE41;
+        else if (name == "avx2")  level = SimdLevel::AVX2;
+        else if (name == "neon")  level = SimdLevel::NEON;
+        else return false;
+        return true;
+    }
+
+    bool ParseArguments(int argc, char** argv, GoldenOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> const char* {
+                if (i + 1 >= argc) {
+                    std::cerr << "Missing value for " << arg << std::endl;
+                    return nullptr;
+                }
+                return argv[++i];
+            };
+
+            if (arg == "-h" || arg == "--help") {
+                PrintUsage();
+                std::exit(0);
+            } else if (arg == "-r" || arg == "--reference") {
+                const char* v = value(); if (!v) return false;
+                options.reference = v;
+            } else if (arg == "-d" || arg == "--diff") {
+                const char* v = value(); if (!v) return false;
+                options.diff = v;
+            } else if (arg == "-u" || arg == "--update") {
+                options.update = true;
+            } else if (arg == "--max-error") {
+                const char* v = value(); if (!v) return false;
+                options.maxError = std::atoi(v);
+            } else if (arg == "--min-psnr") {
+                const char* v = value(); if (!v) return false;
+                options.minPSNR = std::atof(v);
+            } else if (arg == "-t" || arg == "--threads") {
+                const char* v = value(); if (!v) return false;
+                options.threads = static_cast<unsigned>(std::max(0, std::atoi(v)));
+            } else if (arg == "--simd") {
+                const char* v = value(); if (!v) return false;
+                if (!ParseSimdLevel(v, options.simd)) {
+                    std::cerr << "Unknown SIMD level: " << v << std::endl;
+                    return false;
+                }
+                options.forceSimd = true;
+            } else if (arg == "-q" || arg == "--quiet") {
+                options.quiet = true;
+            } else if (!arg.empty() && arg[0] == '-') {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            } else {
+                options.inputs.push_back(arg);
+            }
+        }
+
+        if (options.inputs.empty()) {
+            options.inputs = { "assets", "assets/golden" };
+        }
+        if (options.maxError < 0) {
+            std::cerr << "max-error must not be negative" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Directories expand to the .svg files they contain (sorted, not recursive)
+    std::vector<fs::path> CollectInputs(const std::vector<fs::path>& inputs) {
+        std::vector<fs::path> files;
+        for (const auto& input : inputs) {
+            std::error_code ec;
+            if (fs::is_directory(input, ec)) {
+                std::vector<fs::path> found;
+                for (const auto& entry : fs::directory_iterator(input, ec)) {
+                    if (entry.is_regular_file() && entry.path().extension() == ".svg") {
+                        found.push_back(entry.path());
+                    }
+                }
+                std::sort(found.begin(), found.end());
+                files.insert(files.end(), found.begin(), found.end());
+            } else {
+                files.push_back(input);
+            }
+        }
+        return files;
+    }
+
+    void ForceFillRule(std::vector<SVGElement>& elements, SVGFillRule rule) {
+        for (auto& element : elements) {
+            if (element.type == SVGElement::Type::Path) {
+                element.path.style.fillRule = rule;
+                element.MarkStyleModified();
+            }
+            ForceFillRule(element.children, rule);
+        }
+    }
+
+    //=========================================================================
+    // Image comparison
+    //=========================================================================
+
+    struct RGBImage {
+        int width = 0;
+        int height = 0;
+        std::vector<std::uint8_t> pixels;       // Tightly packed RGB
+    };
+
+    bool LoadPNG(const fs::path& path, RGBImage& image) {
+        int w, h, channels;
+        stbi_uc* data = stbi_load(path.string().c_str(), &w, &h, &channels, 3);
+        if (!data) return false;
+        image.width = w;
+        image.height = h;
+        image.pixels.assign(data, data + static_cast<size_t>(w) * h * 3);
+        stbi_image_free(data);
+        return true;
+    }
+
+    bool WritePNG(const fs::path& path, const RGBImage& image) {
+        return stbi_write_png(path.string().c_str(), image.width, image.height, 3,
+                              image.pixels.data(), image.width * 3) != 0;
+    }
+
+    RGBImage FromImage(const Common::ImageRGB& source, int width, int height) {
+        RGBImage image;
+        image.width = width;
+        image.height = height;
+        std::span<std::byte const> bytes = source.GetBytes();
+        image.pixels.resize(bytes.size());
+        std::transform(bytes.begin(), bytes.end(), image.pixels.begin(),
+                       [](std::byte b) { return static_cast<std::uint8_t>(b); });
+        return image;
+    }
+
+    struct Comparison {
+        int maxError = 0;
+        double psnr = INFINITY;
+        std::int64_t differingPixels = 0;
+    };
+
+    // Images must have the same size. The diff shows the reference dimmed to
+    // 25% gray, with differing pixels in red scaled by 16x their error.
+    Comparison Compare(const RGBImage& actual, const RGBImage& reference, RGBImage& diff) {
+        Comparison result;
+        diff.width = actual.width;
+        diff.height = actual.height;
+        diff.pixels.assign(actual.pixels.size(), 0);
+
+        double squaredError = 0;
+        size_t pixelCount = static_cast<size_t>(actual.width) * actual.height;
+        for (size_t i = 0; i < pixelCount; ++i) {
+            const std::uint8_t* a = &actual.pixels[i * 3];
+            const std::uint8_t* b = &reference.pixels[i * 3];
+            int pixelError = 0;
+            for (int c = 0; c < 3; ++c) {
+                int d = std::abs(static_cast<int>(a[c]) - static_cast<int>(b[c]));
+                pixelError = std::max(pixelError, d);
+                squaredError += static_cast<double>(d) * d;
+            }
+            result.maxError = std::max(result.maxError, pixelError);
+
+            std::uint8_t* out = &diff.pixels[i * 3];
+            if (pixelError > 0) {
+                ++result.differingPixels;
+                out[0] = static_cast<std::uint8_t>(std::min(255, 64 + pixelError * 16));
+                out[1] = out[2] = 0;
+            } else {
+                std::uint8_t gray = static_cast<std::uint8_t>((b[0] * 77 + b[1] * 150 + b[2] * 29) >> 10);
+                out[0] = out[1] = out[2] = gray;
+            }
+        }
+
+        if (squaredError > 0) {
+            double mse = squaredError / (static_cast<double>(pixelCount) * 3);
+            result.psnr = 10.0 * std::log10(255.0 * 255.0 / mse);
+        }
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    GoldenOptions options;
+    if (!ParseArguments(argc, argv, options)) return 2;
+
+    std::vector<fs::path> files = CollectInputs(options.inputs);
+    if (files.empty()) {
+        std::cerr << "No input files" << std::endl;
+        return 2;
+    }
+
+    std::error_code ec;
+    fs::create_directories(options.update ? options.reference : options.diff, ec);
+
+    SVGRendererV2 renderer;
+    renderer.SetThreadCount(options.threads);
+    renderer.SetGeometryCacheEnabled(false);
+    if (options.forceSimd) {
+        renderer.SetSimdLevel(options.simd);
+    }
+
+    // Parsing on several threads must give the same documents as well
+    SVGParser parser;
+    parser.SetThreadCount(options.threads);
+
+    int passed = 0, failed = 0, missing = 0, written = 0;
+
+    for (const auto& file : files) {
+        SVGDocument document;
+        if (!parser.ParseFile(file.string(), document)) {
+            std::cerr << file.string() << ": parse failed" << std::endl;
+            ++failed;
+            continue;
+        }
+        int width = static_cast<int>(std::lround(document.width));
+        int height = static_cast<int>(std::lround(document.height));
+        if (width <= 0 || height <= 0) {
+            std::cerr << file.string() << ": invalid document size" << std::endl;
+            ++failed;
+            continue;
+        }
+
+        for (const FillRuleVariant& rule : c_FillRules) {
+            ForceFillRule(document.elements, rule.rule);
+
+            for (const AAVariant& aa : c_AAVariants) {
+                renderer.SetAntiAliasing(aa.enabled);
+                renderer.SetAAMode(aa.mode);
+                RGBImage actual = FromImage(renderer.RenderSVG(document, width, height), width, height);
+
+                std::string name = file.stem().string() + "." + aa.name + "." + rule.name;
+                fs::path referencePath = options.reference / (name + ".png");
+
+                if (options.update) {
+                    if (!WritePNG(referencePath, actual)) {
+                        std::cerr << referencePath.string() << ": write failed" << std::endl;
+                        ++failed;
+                        continue;
+                    }
+                    ++written;
+                    continue;
+                }
+
+                RGBImage reference;
+                if (!LoadPNG(referencePath, reference)) {
+                    std::printf("MISSING %s (run with --update to create it)\n", name.c_str());
+                    ++missing;
+                    continue;
+                }
+                if (reference.width != width || reference.height != height) {
+                    std::printf("FAIL    %s  size %dx%d, reference %dx%d\n",
+                                name.c_str(), width, height, reference.width, reference.height);
+                    WritePNG(options.diff / (name + ".actual.png"), actual);
+                    ++failed;
+                    continue;
+                }
+
+                RGBImage diff;
+                Comparison result = Compare(actual, reference, diff);
+                bool ok = result.maxError <= options.maxError && result.psnr >= options.minPSNR;
+                if (ok) {
+                    ++passed;
+                } else {
+                    ++failed;
+                    WritePNG(options.diff / (name + ".actual.png"), actual);
+                    WritePNG(options.diff / (name + ".diff.png"), diff);
+                }
+                if (!ok || !options.quiet) {
+                    std::printf("%s %s  max error %d  PSNR %.2f dB  %lld pixels differ\n",
+                                ok ? "PASS   " : "FAIL   ", name.c_str(), result.maxError, result.psnr,
+                                static_cast<long long>(result.differingPixels));
+                }
+            }
+        }
+    }
+
+    if (options.update) {
+        std::printf("%d references written to %s, %d failed\n", written, options.reference.string().c_str(), failed);
+        return failed == 0 ? 0 : 1;
+    }
+    std::printf("%d passed, %d failed, %d missing", passed, failed, missing);
+    if (failed > 0) {
+        std::printf(" (actual and diff images in %s)", options.diff.string().c_str());
+    }
+    std::printf("\n");
+    return failed == 0 && missing == 0 ? 0 : 1;
+}
@@ -0,0 +1,333 @@
+#pragma once
+
+#include "SVG.h"
+#include "Geometry/ShapeView.h"
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// PathDataParser - SVG path data ("d") into packed verbs and points
+//
+// Commands are appended to caller-owned arrays in the PathView packing, one
+// verb byte each with its points after the previous command's, so parsing
+// allocates nothing per command and a FlatDocument's pools can be the
+// target. Numbers are scanned in place and converted with std::from_chars.
+//
+// Output matches the PathCommand form the editor works on: H/V become
+// LineTo, S/T become CurveTo/QuadCurveTo with the reflected control point
+// made explicit, arcs keep their radii and end point. Parsing stops at
+// numbers that cannot continue a command (none yet, or after Z); other
+// malformed commands are skipped up to the next letter.
+//=============================================================================
+class PathDataParser {
+public:
+    // Returns the number of commands appended
+    static size_t Parse(std::string_view data, std::vector<std::uint8_t>& verbs, std::vector<Point2D>& points);
+
+    // Whether Parse would append any command, found without parsing numbers
+    // (lets a parser keep or drop a path before its data is parsed)
+    static bool HasCommand(std::string_view data);
+
+    // Number at data[i] after whitespace: sign, digits with one '.', then an
+    // exponent. i moves past the scanned characters; 0 if they form no number
+    static float ParseNumber(std::string_view data, size_t& i);
+
+    // [first, last) as a float, a leading '+' allowed; false if it is not a
+    // number or out of range
+    static bool ToFloat(const char* first, const char* last, float& value);
+
+private:
+    // The C locale's isspace/isalpha, without the locale lookup
+    static bool IsSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+    static bool IsAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+    static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+    static bool IsCommand(char c) {
+        switch (c | 0x20) {     // Lower case
+            case 'm': case 'l': case 'c': case 'q': case 'h': case 'v': case 's': case 't': case 'a': case 'z':
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Whitespace, then at most one comma
+    static void SkipSeparator(std::string_view data, size_t& i) {
+        while (i < data.size() && IsSpace(data[i])) ++i;
+        if (i < data.size() && data[i] == ',') ++i;
+    }
+    // Coordinate pair with its trailing separator
+    static Point2D ParsePoint(std::string_view data, size_t& i) {
+        float x = ParseNumber(data, i);
+        SkipSeparator(data, i);
+        float y = ParseNumber(data, i);
+        SkipSeparator(data, i);
+        return Point2D(x, y);
+    }
+    // Arc flags are single digits and may be written without separators
+    static void SkipFlag(std::string_view data, size_t& i) {
+        while (i < data.size() && IsSpace(data[i])) ++i;
+        if (i < data.size() && (data[i] == '0' || data[i] == '1')) ++i;
+        else ParseNumber(data, i);
+        SkipSeparator(data, i);
+    }
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline bool PathDataParser::ToFloat(const char* first, const char* last, float& value) {
+    if (first < last && *first == '+') ++first;     // from_chars takes '-' only
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc();
+}
+
+inline float PathDataParser::ParseNumber(std::string_view data, size_t& i) {
+    while (i < data.size() && IsSpace(data[i])) ++i;
+    size_t start = i;
+
+    if (i < data.size() && (data[i] == '-' || data[i] == '+')) ++i;
+    bool hasDot = false;
+    while (i < data.size()) {
+        char c = data[i];
+        if (IsDigit(c)) {
+            ++i;
+        } else if (c == '.' && !hasDot) {
+            hasDot = true;
+            ++i;
+        } else if (c == 'e' || c == 'E') {
+            ++i;
+            if (i < data.size() && (data[i] == '-' || data[i] == '+')) ++i;
+            while (i < data.size() && IsDigit(data[i])) ++i;
+            break;
+        } else {
+            break;
+        }
+    }
+
+    // A malformed exponent converts as its mantissa, as strtof would
+    float value;
+    return ToFloat(data.data() + start, data.data() + i, value) ? value : 0.0f;
+}
+
+inline bool PathDataParser::HasCommand(std::string_view data) {
+    // Parse's scan up to its first command: numbers before one end it,
+    // unknown commands skip to the letter after their next character
+    size_t i = 0;
+    while (i < data.size()) {
+        char c = data[i];
+        if (IsSpace(c) || c == ',') {
+            ++i;
+        } else if (IsDigit(c) || c == '-' || c == '+' || c == '.') {
+            return false;
+        } else if (IsCommand(c)) {
+            return true;
+        } else {
+            i += 2;
+            while (i < data.size() && !IsAlpha(data[i])) ++i;
+        }
+    }
+    return false;
+}
+
+inline size_t PathDataParser::Parse(std::string_view data, std::vector<std::uint8_t>& verbs,
+                                    std::vector<Point2D>& points) {
+    size_t count = 0;
+    size_t i = 0;
+    Point2D currentPos(0, 0);
+    Point2D startPos(0, 0);
+    Point2D lastControlPoint(0, 0);     // Reflected by S/T
+    char lastCommand = '\0';            // Letter repeated by bare numbers
+    char lastUpperCommand = '\0';       // Previous command, for S/T
+
+    auto emit = [&](PathCommandType type, bool relative) {
+        verbs.push_back(PathView::Pack(type, relative));
+        ++count;
+    };
+
+    while (i < data.size()) {
+        while (i < data.size() && IsSpace(data[i])) ++i;
+        if (i >= data.size()) break;
+        if (data[i] == ',') {
+            ++i;
+            continue;
+        }
+
+        char cmd = data[i];
+        if (IsDigit(cmd) || cmd == '-' || cmd == '+' || cmd == '.') {
+            // Implicit repetition of the previous command
+            if (lastCommand == '\0' || lastCommand == 'Z' || lastCommand == 'z') break;
+            cmd = lastCommand;
+        } else {
+            ++i;
+            lastCommand = cmd;
+        }
+        bool relative = cmd >= 'a' && cmd <= 'z';
+        char upperCmd = relative ? static_cast<char>(cmd - 'a' + 'A') : cmd;
+
+        switch (upperCmd) {
+            case 'M': {
+                Point2D p = ParsePoint(data, i);
+                currentPos = relative ? currentPos + p : p;
+                startPos = currentPos;
+                lastControlPoint = currentPos;
+                // Further coordinate pairs are LineTo
+                lastCommand = relative ? 'l' : 'L';
+                emit(PathCommandType::MoveTo, relative);
+                points.push_back(p);
+                break;
+            }
+
+            case 'L': {
+                Point2D p = ParsePoint(data, i);
+                currentPos = relative ? currentPos + p : p;
+                lastControlPoint = currentPos;
+                emit(PathCommandType::LineTo, relative);
+                points.push_back(p);
+                break;
+            }
+
+            case 'C': {
+                Point2D p0 = ParsePoint(data, i);
+                Point2D p1 = ParsePoint(data, i);
+                Point2D p2 = ParsePoint(data, i);
+                lastControlPoint = relative ? currentPos + p1 : p1;
+                currentPos = relative ? currentPos + p2 : p2;
+                emit(PathCommandType::CurveTo, relative);
+                points.push_back(p0);
+                points.push_back(p1);
+                points.push_back(p2);
+                break;
+            }
+
+            case 'Q': {
+                Point2D p0 = ParsePoint(data, i);
+                Point2D p1 = ParsePoint(data, i);
+                lastControlPoint = relative ? currentPos + p0 : p0;
+                currentPos = relative ? currentPos + p1 : p1;
+                emit(PathCommandType::QuadCurveTo, relative);
+                points.push_back(p0);
+                points.push_back(p1);
+                break;
+            }
+
+            case 'H': {
+                float x = ParseNumber(data, i);
+                emit(PathCommandType::LineTo, relative);
+                if (relative) {
+                    points.push_back(Point2D(x, 0));
+                    currentPos.x += x;
+                } else {
+                    points.push_back(Point2D(x, currentPos.y));
+                    currentPos.x = x;
+                }
+                lastControlPoint = currentPos;
+                break;
+            }
+
+            case 'V': {
+                float y = ParseNumber(data, i);
+                emit(PathCommandType::LineTo, relative);
+                if (relative) {
+                    points.push_back(Point2D(0, y));
+                    currentPos.y += y;
+                } else {
+                    points.push_back(Point2D(currentPos.x, y));
+                    currentPos.y = y;
+                }
+                lastControlPoint = currentPos;
+                break;
+            }
+
+            case 'S': {
+                Point2D p0 = ParsePoint(data, i);
+                Point2D p1 = ParsePoint(data, i);
+                Point2D cp2 = relative ? currentPos + p0 : p0;
+                Point2D endPoint = relative ? currentPos + p1 : p1;
+                // First control point: reflection of the previous C/S one
+                Point2D cp1 = currentPos;
+                if (lastUpperCommand == 'C' || lastUpperCommand == 'S') {
+                    cp1 = Point2D(2 * currentPos.x - lastControlPoint.x,
+                                  2 * currentPos.y - lastControlPoint.y);
+                }
+                emit(PathCommandType::CurveTo, relative);
+                if (relative) {
+                    points.push_back(cp1 - currentPos);
+                    points.push_back(p0);
+                    points.push_back(p1);
+                } else {
+                    points.push_back(cp1);
+                    points.push_back(cp2);
+                    points.push_back(endPoint);
+                }
+                lastControlPoint = cp2;
+                currentPos = endPoint;
+                break;
+            }
+
+            case 'T': {
+                Point2D p0 = ParsePoint(data, i);
+                Point2D endPoint = relative ? currentPos + p0 : p0;
+                // Control point: reflection of the previous Q/T one
+                Point2D cp = currentPos;
+                if (lastUpperCommand == 'Q' || lastUpperCommand == 'T') {
+                    cp = Point2D(2 * currentPos.x - lastControlPoint.x,
+                                 2 * currentPos.y - lastControlPoint.y);
+                }
+                emit(PathCommandType::QuadCurveTo, relative);
+                if (relative) {
+                    points.push_back(cp - currentPos);
+                    points.push_back(p0);
+                } else {
+                    points.push_back(cp);
+                    points.push_back(endPoint);
+                }
+                lastControlPoint = cp;
+                currentPos = endPoint;
+                break;
+            }
+
+            case 'A': {
+                // rx ry x-axis-rotation large-arc-flag sweep-flag x y; only the
+                // radii and end point are kept
+                float rx = ParseNumber(data, i);
+                SkipSeparator(data, i);
+                float ry = ParseNumber(data, i);
+                SkipSeparator(data, i);
+                ParseNumber(data, i);
+                SkipSeparator(data, i);
+                SkipFlag(data, i);
+                SkipFlag(data, i);
+                Point2D end = ParsePoint(data, i);
+                emit(PathCommandType::ArcTo, relative);
+                points.push_back(Point2D(rx, ry));
+                points.push_back(end);
+                currentPos = relative ? currentPos + end : end;
+                break;
+            }
+
+            case 'Z':
+                emit(PathCommandType::ClosePath, relative);
+                currentPos = startPos;
+                lastControlPoint = currentPos;
+                break;
+
+            default:
+                // Unknown command: skip it and its parameters
+                ++i;
+                while (i < data.size() && !IsAlpha(data[i])) ++i;
+                continue;
+        }
+
+        lastUpperCommand = upperCmd;
+    }
+
+    return count;
+}
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// XmlAttributes - Attributes of one start tag
+//
+// Names and values are views into the source, or into the reader's scratch
+// when a value had entities or carriage returns to decode; either way they
+// are only valid during the StartElement callback.
+//=============================================================================
+struct XmlAttribute {
+    std::string_view name;
+    std::string_view value;
+};
+
+class XmlAttributes {
+public:
+    // Value of the attribute, nullptr if absent
+    const std::string_view* Find(std::string_view name) const {
+        for (const auto& attribute : _items) {
+            if (attribute.name == name) return &attribute.value;
+        }
+        return nullptr;
+    }
+
+    size_t Size() const { return _items.size(); }
+    std::vector<XmlAttribute>::const_iterator begin() const { return _items.begin(); }
+    std::vector<XmlAttribute>::const_iterator end() const { return _items.end(); }
+
+private:
+    friend class XmlReader;
+    std::vector<XmlAttribute> _items;
+};
+
+//=============================================================================
+// XmlReader - Streaming (SAX-style) XML reader over an in-memory buffer
+//
+// Parse walks the source once and calls the handler as it goes, building no
+// tree:
+//   void StartElement(std::string_view name, const XmlAttributes& attributes);
+//   void EndElement(std::string_view name);
+//   void Text(std::string_view text);     // Character data and CDATA
+//   void OtherNode();                     // Comment or processing instruction
+// Self-closing tags produce a start and an end. Text follows tinyxml2: runs of
+// only whitespace between markup are dropped, other runs are passed whole
+// (leading whitespace included). Text and OtherNode are only reported inside
+// elements; as in tinyxml2 there may be several top-level elements. The
+// predefined and numeric entities are decoded and line ends normalized to
+// '\n'; other entities are passed through as written. Only as much as the SVG
+// loader needs is checked: tags must nest and close, quotes and markup must
+// be terminated. The DOCTYPE is skipped, internal subset included.
+//=============================================================================
+class XmlReader {
+public:
+    template <typename Handler>
+    bool Parse(std::string_view source, Handler& handler);
+
+    // "line N: message" after a failed Parse
+    const std::string& Error() const { return _error; }
+
+    // During StartElement/EndElement: the tag's source range, from its '<'
+    // to past its '>' (the same for both calls of a self-closing tag)
+    size_t TagBegin() const { return _tagBegin; }
+    size_t TagEnd() const { return _tagEnd; }
+
+private:
+    XmlAttributes _attributes;
+    size_t _tagBegin = 0;
+    size_t _tagEnd = 0;
+    std::vector<std::string_view> _open;    // Names of the unclosed elements
+    std::string _decoded;                   // Decoded attribute values of one tag
+    std::string _text;                      // Decoded text of one run
+    std::string _error;
+
+    static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+    static bool IsNameEnd(char c) { return IsSpace(c) || c == '/' || c == '>' || c == '=' || c == '<'; }
+    static bool NeedsDecoding(std::string_view raw) {
+        return raw.find('&') != std::string_view::npos || raw.find('\r') != std::string_view::npos;
+    }
+    // Append raw to out with entities decoded and line ends normalized; the
+    // result is never longer than raw
+    static void Decode(std::string_view raw, std::string& out);
+    static void AppendUtf8(std::uint32_t code, std::string& out);
+
+    bool Fail(std::string_view source, size_t offset, std::string_view message);
+    // Start tag from just past '<'; returns the offset past '>', or npos
+    size_t ReadAttributes(std::string_view source, size_t pos, bool& selfClosing);
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline bool XmlReader::Fail(std::string_view source, size_t offset, std::string_view message) {
+    size_t line = 1;
+    for (size_t i = 0; i < offset && i < source.size(); ++i) {
+        if (source[i] == '\n') ++line;
+    }
+    _error = "line " + std::to_string(line) + ": " + std::string(message);
+    return false;
+}
+
+inline void XmlReader::AppendUtf8(std::uint32_t code, std::string& out) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+inline void XmlReader::Decode(std::string_view raw, std::string& out) {
+    for (size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c == '\r') {
+            out += '\n';
+            if (i + 1 < raw.size() && raw[i + 1] == '\n') ++i;
+            continue;
+        }
+        if (c != '&') {
+            out += c;
+            continue;
+        }
+
+        size_t semicolon = raw.find(';', i + 1);
+        if (semicolon == std::string_view::npos) {
+            out += c;
+            continue;
+        }
+        std::string_view entity = raw.substr(i + 1, semicolon - i - 1);
+        if (entity == "lt")        out += '<';
+        else if (entity == "gt")   out += '>';
+        else if (entity == "amp")  out += '&';
+        else if (entity == "quot") out += '"';
+        else if (entity == "apos") out += '\'';
+        else if (entity.size() > 1 && entity[0] == '#') {
+            bool hex = entity[1] == 'x' || entity[1] == 'X';
+            std::uint32_t code = 0;
+            bool valid = entity.size() > (hex ? 2u : 1u);
+            for (size_t k = hex ? 2 : 1; k < entity.size() && valid; ++k) {
+                char d = entity[k];
+                std::uint32_t digit;
+                if (d >= '0' && d <= '9') digit = d - '0';
+                else if (hex && d >= 'a' && d <= 'f') digit = d - 'a' + 10;
+                else if (hex && d >= 'A' && d <= 'F') digit = d - 'A' + 10;
+                else { valid = false; break; }
+                code = code * (hex ? 16 : 10) + digit;
+                if (code > 0x10FFFF) valid = false;
+            }
+            if (!valid) {
+                out += c;
+                continue;
+            }
+            AppendUtf8(code, out);
+        } else {
+            // Unknown entity: keep as written
+            out += c;
+            continue;
+        }
+        i = semicolon;
+    }
+}
+
+inline size_t XmlReader::ReadAttributes(std::string_view source, size_t pos, bool& selfClosing) {
+    auto& items = _attributes._items;
+    items.clear();
+    size_t decodedBytes = 0;
+    selfClosing = false;
+
+    while (true) {
+        size_t start = pos;
+        while (pos < source.size() && IsSpace(source[pos])) ++pos;
+        if (pos >= source.size()) {
+            Fail(source, pos, "unterminated start tag");
+            return std::string_view::npos;
+        }
+        if (source[pos] == '>') {
+            ++pos;
+            break;
+        }
+        if (source[pos] == '/') {
+            if (pos + 1 >= source.size() || source[pos + 1] != '>') {
+                Fail(source, pos, "expected '>' after '/'");
+                return std::string_view::npos;
+            }
+            selfClosing = true;
+            pos += 2;
+            break;
+        }
+        if (pos == start) {
+            Fail(source, pos, "expected whitespace before attribute");
+            return std::string_view::npos;
+        }
+
+        size_t nameStart = pos;
+        while (pos < source.size() && !IsNameEnd(source[pos])) ++pos;
+        if (pos == nameStart) {
+            Fail(source, pos, "invalid attribute name");
+            return std::string_view::npos;
+        }
+        std::string_view name = source.substr(nameStart, pos - nameStart);
+
+        while (pos < source.size() && IsSpace(source[pos])) ++pos;
+        if (pos >= source.size() || source[pos] != '=') {
+            Fail(source, pos, "expected '=' after attribute name");
+            return std::string_view::npos;
+        }
+        ++pos;
+        while (pos < source.size() && IsSpace(source[pos])) ++pos;
+        if (pos >= source.size() || (source[pos] != '"' && source[pos] != '\'')) {
+            Fail(source, pos, "expected quoted attribute value");
+            return std::string_view::npos;
+        }
+        char quote = source[pos++];
+        size_t close = source.find(quote, pos);
+        if (close == std::string_view::npos) {
+            Fail(source, pos, "unterminated attribute value");
+            return std::string_view::npos;
+        }
+        std::string_view value = source.substr(pos, close - pos);
+        if (NeedsDecoding(value)) decodedBytes += value.size();
+        items.push_back({ name, value });
+        pos = close + 1;
+    }
+
+    // Decode in a second pass into storage reserved up front, so earlier
+    // decoded views are not invalidated by later ones
+    if (decodedBytes > 0) {
+        _decoded.clear();
+        _decoded.reserve(decodedBytes);
+        for (auto& attribute : items) {
+            if (!NeedsDecoding(attribute.value)) continue;
+            size_t offset = _decoded.size();
+            Decode(attribute.value, _decoded);
+            attribute.value = std::string_view(_decoded).substr(offset);
+        }
+    }
+    return pos;
+}
+
+template <typename Handler>
+bool XmlReader::Parse(std::string_view source, Handler& handler) {
+    _open.clear();
+    _error.clear();
+
+    size_t pos = 0;
+    if (source.substr(0, 3) == "\xEF\xBB\xBF") pos = 3;     // UTF-8 BOM
+    bool found = false;     // Any element at all
+
+    while (pos < source.size()) {
+        // Character data up to the next markup
+        if (source[pos] != '<') {
+            size_t end = source.find('<', pos);
+            if (end == std::string_view::npos) end = source.size();
+            std::string_view run = source.substr(pos, end - pos);
+            size_t content = 0;
+            while (content < run.size() && IsSpace(run[content])) ++content;
+            if (content < run.size() && !_open.empty()) {
+                if (NeedsDecoding(run)) {
+                    _text.clear();
+                    Decode(run, _text);
+                    handler.Text(std::string_view(_text));
+                } else {
+                    handler.Text(run);
+                }
+            }
+            pos = end;
+            continue;
+        }
+
+        std::string_view rest = source.substr(pos);
+        if (rest.substr(0, 4) == "<!--") {
+            size_t end = source.find("-->", pos + 4);
+            if (end == std::string_view::npos) return Fail(source, pos, "unterminated comment");
+            if (!_open.empty()) handler.OtherNode();
+            pos = end + 3;
+        } else if (rest.substr(0, 9) == "<![CDATA[") {
+            size_t end = source.find("]]>", pos + 9);
+            if (end == std::string_view::npos) return Fail(source, pos, "unterminated CDATA section");
+            std::string_view data = source.substr(pos + 9, end - pos - 9);
+            if (data.find('\r') != std::string_view::npos) {
+                // Line ends only: CDATA has no entities
+                _text.clear();
+                for (size_t i = 0; i < data.size(); ++i) {
+                    if (data[i] != '\r') _text += data[i];
+                    else if (i + 1 >= data.size() || data[i + 1] != '\n') _text += '\n';
+                }
+                if (!_open.empty()) handler.Text(std::string_view(_text));
+            } else if (!_open.empty()) {
+                handler.Text(data);
+            }
+            pos = end + 3;
+        } else if (rest.substr(0, 2) == "<?") {
+            size_t end = source.find("?>", pos + 2);
+            if (end == std::string_view::npos) return Fail(source, pos, "unterminated processing instruction");
+            if (!_open.empty()) handler.OtherNode();
+            pos = end + 2;
+        } else if (rest.substr(0, 2) == "<!") {
+            // DOCTYPE and other declarations, up to the '>' outside quotes and
+            // the internal subset
+            size_t i = pos + 2;
+            int depth = 0;
+            char quote = 0;
+            for (; i < source.size(); ++i) {
+                char c = source[i];
+                if (quote) {
+                    if (c == quote) quote = 0;
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (c == '[') {
+                    ++depth;
+                } else if (c == ']') {
+                    --depth;
+                } else if (c == '>' && depth <= 0) {
+                    break;
+                }
+            }
+            if (i >= source.size()) return Fail(source, pos, "unterminated declaration");
+            if (!_open.empty()) handler.OtherNode();
+            pos = i + 1;
+        } else if (rest.substr(0, 2) == "</") {
+            size_t nameStart = pos + 2;
+            size_t i = nameStart;
+            while (i < source.size() && !IsNameEnd(source[i])) ++i;
+            std::string_view name = source.substr(nameStart, i - nameStart);
+            while (i < source.size() && IsSpace(source[i])) ++i;
+            if (i >= source.size() || source[i] != '>') return Fail(source, pos, "malformed end tag");
+            if (_open.empty() || _open.back() != name) {
+                return Fail(source, pos, "mismatched end tag </" + std::string(name) + ">");
+            }
+            _open.pop_back();
+            _tagBegin = pos;
+            _tagEnd = i + 1;
+            handler.EndElement(name);
+            pos = i + 1;
+        } else {
+            size_t nameStart = pos + 1;
+            size_t i = nameStart;
+            while (i < source.size() && !IsNameEnd(source[i])) ++i;
+            if (i == nameStart) return Fail(source, pos, "invalid element name");
+            std::string_view name = source.substr(nameStart, i - nameStart);
+
+            bool selfClosing;
+            size_t end = ReadAttributes(source, i, selfClosing);
+            if (end == std::string_view::npos) return false;
+
+            found = true;
+            _tagBegin = pos;
+            _tagEnd = end;
+            handler.StartElement(name, _attributes);
+            if (selfClosing) {
+                handler.EndElement(name);
+            } else {
+                _open.push_back(name);
+            }
+            pos = end;
+        }
+    }
+
+    if (!_open.empty()) return Fail(source, source.size(), "unclosed element <" + std::string(_open.back()) + ">");
+    if (!found) return Fail(source, source.size(), "no root element");
+    return true;
+}
+
+} // namespace VCX::Labs::SVG
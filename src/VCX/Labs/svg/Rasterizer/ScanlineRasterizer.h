@@ -1,9 +1,14 @@
 #pragma once
 
 #include "Core/Math2D.h"
+#include "Geometry/FlattenedPath.h"
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
 
 namespace VCX::Labs::SVG {
 
@@ -78,6 +83,60 @@ struct ActiveEdge {
     }
 };
 
+//=============================================================================
+// Coverage span (rasterizer output)
+//
+// A horizontal run [x0, x1] on row y. Interior runs carry one constant alpha
+// (coverage == nullptr); edge runs point at per-pixel alpha, coverage[i]
+// belonging to pixel x0 + i. The pointer is only valid during the callback.
+//=============================================================================
+struct CoverageSpan {
+    int y;
+    int x0;
+    int x1;                     // Inclusive
+    float alpha;                // Used when coverage == nullptr
+    const float* coverage;      // Per-pixel alpha, or nullptr
+
+    float At(int x) const { return coverage ? coverage[x - x0] : alpha; }
+};
+
+using SpanSink = std::function<void(const CoverageSpan&)>;
+
+//=============================================================================
+// Edge list prepared for rasterization
+//
+// Sorted edge table plus the shape's pixel bounds on the canvas. It can be
+// rasterized several times under different clip rects (e.g. once per tile);
+// the coverage of a pixel never depends on the clip rect.
+//=============================================================================
+struct EdgeList {
+    std::vector<Edge> edges;    // Sorted by yMin
+    int xMin = 0;
+    int xMax = -1;
+    int yMin = 0;
+    int yMax = -1;
+
+    bool IsEmpty() const { return edges.empty() || xMin > xMax || yMin > yMax; }
+};
+
+//=============================================================================
+// Edges of an EdgeList that reach one tile (see TileBinner)
+//
+// The edges left of the tile are not listed; what they add is carried in
+// instead, as a winding per sample row (scanline modes) or as the cover at
+// the tile's first accumulation block per pixel row (AccumulatedArea).
+// Carries start at the tile grid row's top, rowTop; nullptr means zero.
+//=============================================================================
+struct TileEdges {
+    const std::uint32_t* edges = nullptr;   // Indices into EdgeList::edges, ascending
+    size_t edgeCount = 0;
+    int rowTop = 0;
+    const int* winding = nullptr;           // [(y - rowTop) * sample rows + sample row]
+    const float* cover = nullptr;           // [y - rowTop]
+
+    bool IsEmpty() const { return edgeCount == 0 && !winding && !cover; }
+};
+
 //=============================================================================
 // Scanline Rasterizer with Anti-Aliasing
 //=============================================================================
@@ -89,14 +148,26 @@ public:
         Coverage4x,     // 4x MSAA-style coverage
         Coverage8x,     // 8x MSAA-style coverage
         Coverage16x,    // 16x MSAA-style coverage
-        Analytical      // Analytical edge coverage
+        Analytical,     // Analytical edge coverage
+        AccumulatedArea // Exact signed-area accumulation (font-rs style)
     };
 
+    // AccumulatedArea resolves rows in canvas-aligned blocks of this many
+    // columns; clip rects aligned to it reproduce unclipped coverage exactly
+    static constexpr int c_AccumulationBlock = 64;
+
     ScanlineRasterizer() : _aaMode(AAMode::Coverage4x), _fillRule(FillRule::NonZero) {}
 
     void SetAAMode(AAMode mode) { _aaMode = mode; }
     void SetFillRule(FillRule rule) { _fillRule = rule; }
 
+    // Bytes held by the reusable scanline/coverage scratch buffers
+    size_t GetBufferBytes() const {
+        return _activeEdges.capacity() * sizeof(ActiveEdge) +
+               _crossings.capacity() * sizeof(std::pair<float, int>) +
+               (_rowCoverage.capacity() + _accumulation.capacity() + _cover.capacity()) * sizeof(float);
+    }
+
     // Rasterize a polygon to coverage values
     // Returns: for each pixel, a coverage value 0.0 - 1.0
     void Rasterize(const std::vector<Vec2>& polygon,
@@ -114,48 +185,148 @@ public:
                           int width, int height,
                           std::vector<float>& coverage);
 
+    // Span output: coverage is streamed row by row to the sink, only over
+    // the covered part of the canvas (no width*height buffer)
+    void Rasterize(const std::vector<Vec2>& polygon,
+                   int width, int height,
+                   const SpanSink& sink);
+    void RasterizeSubPaths(const std::vector<std::vector<Vec2>>& subPaths,
+                           int width, int height,
+                           const SpanSink& sink);
+    void RasterizeClipped(const std::vector<Vec2>& polygon,
+                          const BBox& clipRect,
+                          int width, int height,
+                          const SpanSink& sink);
+
+    // Build a sorted edge table and the canvas-clipped pixel bounds once
+    EdgeList PrepareEdges(const std::vector<Vec2>& polygon, int width, int height);
+    EdgeList PrepareEdges(const std::vector<std::vector<Vec2>>& subPaths, int width, int height);
+    // Contours with fewer than 3 points enclose nothing and are skipped
+    EdgeList PrepareEdges(const FlattenedPath& path, int width, int height);
+
+    // Rasterize a prepared edge list, optionally restricted to the inclusive
+    // pixel rect [clipX0, clipX1] x [clipY0, clipY1]
+    void Rasterize(const EdgeList& edgeList, const SpanSink& sink);
+    void RasterizeClipped(const EdgeList& edgeList,
+                          int clipX0, int clipY0, int clipX1, int clipY1,
+                          const SpanSink& sink);
+    // Rasterize one tile of a TileBinner, given the edges binned there; same
+    // coverage as RasterizeClipped with the tile's rect
+    void RasterizeTile(const EdgeList& edgeList, const TileEdges& tile,
+                       int clipX0, int clipY0, int clipX1, int clipY1,
+                       const SpanSink& sink);
+
 private:
+    friend class TileBinner;
+
     AAMode _aaMode;
     FillRule _fillRule;
 
+    // Sub-scanlines per pixel row of the Analytical mode
+    static constexpr int c_AnalyticalRows = 8;
+
     // Build edge table from polygon
     std::vector<Edge> BuildEdgeTable(const std::vector<Vec2>& polygon);
     
     // Build edge table from multiple sub-paths
     std::vector<Edge> BuildEdgeTableFromSubPaths(const std::vector<std::vector<Vec2>>& subPaths);
 
+    // Append the edges of one closed contour
+    static void AppendContourEdges(const Vec2* points, size_t n, std::vector<Edge>& edges);
+
     // Check if point is inside using fill rule
     bool IsInside(int windingNumber) const;
 
-    // Coverage calculation methods
-    float ComputePixelCoverage(int px, int py, const std::vector<Edge>& edges);
-    float ComputeAnalyticalCoverage(int px, int py, const std::vector<Edge>& edges);
+    // Sort edge table by yMin so edges can be activated incrementally
+    static void SortEdgeTable(std::vector<Edge>& edges);
+
+    // Pixel bounds of a float bbox, clipped to the canvas
+    static void ComputePixelBounds(EdgeList& edgeList, float minX, float minY,
+                                   float maxX, float maxY, int width, int height);
+
+    // Active edge table scan of the edge list, clipped to the given rect;
+    // with tile, only over its edges and carries
+    void ScanEdges(const EdgeList& edgeList, const TileEdges* tile,
+                   int clipX0, int clipY0, int clipX1, int clipY1,
+                   const SpanSink& sink);
+
+    // Split _rowCoverage into constant / per-pixel spans
+    void EmitRowSpans(int y, int xMin, int xMax, const SpanSink& sink);
+
+    // Sink writing spans into a width*height coverage buffer
+    static SpanSink BufferSink(std::vector<float>& coverage, int width);
+
+    // Rows sampled per pixel row by the scanline modes, and their y
+    static int SampleRows(AAMode mode);
+    static float SampleRowY(AAMode mode, int py, int sampleRow);
+
+    // Sorted (x, direction) crossings of the active edges at sampleY. With
+    // a carry (tiles only), the carried-in winding adds a crossing left of
+    // xMin and a closing one goes right of xMax
+    void CollectCrossings(const std::vector<Edge>& edges, int py, float sampleY,
+                          const int* carry, int xMin, int xMax);
+
+    // Per-scanline coverage into _rowCoverage; carry is the row's carried-in
+    // winding per sample row for tiles, nullptr otherwise
+    void ScanlineSampled(const std::vector<Edge>& edges, const int* carry, int py, int xMin, int xMax);
+    void ScanlineAnalytical(const std::vector<Edge>& edges, const int* carry, int py, int xMin, int xMax);
+
+    // Signed-area accumulation of the visible rect [xMin, xMax] x [yMin, yMax]
+    void AccumulateEdges(const EdgeList& edgeList, const TileEdges* tile,
+                         int xMin, int xMax, int yMin, int yMax,
+                         const SpanSink& sink);
+    // piece(block, ya, yb, left, right) for the part [ya, yb] of edge inside
+    // each block of [firstBlock, lastBlock]; with withLeft, also
+    // piece(firstBlock - 1, ...) for the part left of firstBlock
+    template <typename Piece>
+    static void ForEachEdgePiece(const EdgeList& edgeList, const Edge& edge,
+                                 int firstBlock, int lastBlock, bool withLeft, Piece&& piece);
+    // y range of the part of edge with left <= x < right; false if empty
+    static bool EdgePiece(const Edge& edge, float left, float right, float& ya, float& yb);
+    // Adds the cover of the edge part [y0, y1] to rows [yMin, yMax] of cover
+    static void AccumulateCover(float y0, float y1, int direction, int yMin, int yMax, float* cover);
+    // Deposits the edge part [ya, yb], inside [left, right], into a block's columns
+    void AccumulatePiece(const Edge& edge, float ya, float yb, float left, float right,
+                         float* block, int blockX0, int yMin, int yMax);
+    void AccumulateSegment(float x0, float y0, float x1, float y1, int direction,
+                           float* block, int xMin, int yMin, int yMax);
+    float ResolveAccumulated(float winding) const;
     
     // Sample points for MSAA
     static const std::vector<Vec2>& GetSamplePattern(AAMode mode);
+
+    // Scratch buffers reused across scanlines and calls
+    std::vector<ActiveEdge> _activeEdges;
+    std::vector<std::pair<float, int>> _crossings;
+    std::vector<float> _rowCoverage;
+    std::vector<float> _accumulation;   // Rows of blocks, c_AccumulationBlock + 2 columns each
+    int _accumulationStride = 0;
+    std::vector<float> _cover;          // Carry columns: left of the first block, then per block
 };
 
 //=============================================================================
 // Implementation
 //=============================================================================
 
-inline std::vector<Edge> ScanlineRasterizer::BuildEdgeTable(const std::vector<Vec2>& polygon) {
-    std::vector<Edge> edges;
-    size_t n = polygon.size();
-    if (n < 2) return edges;
+inline void ScanlineRasterizer::AppendContourEdges(const Vec2* points, size_t n, std::vector<Edge>& edges) {
+    if (n < 2) return;
 
-    edges.reserve(n);
     for (size_t i = 0; i < n; ++i) {
         size_t j = (i + 1) % n;
-        const Vec2& p0 = polygon[i];
-        const Vec2& p1 = polygon[j];
+        const Vec2& p0 = points[i];
+        const Vec2& p1 = points[j];
         
         // Skip horizontal edges
         if (std::abs(p0.y - p1.y) > 1e-6f) {
             edges.emplace_back(p0, p1);
         }
     }
+}
 
+inline std::vector<Edge> ScanlineRasterizer::BuildEdgeTable(const std::vector<Vec2>& polygon) {
+    std::vector<Edge> edges;
+    edges.reserve(polygon.size());
+    AppendContourEdges(polygon.data(), polygon.size(), edges);
     return edges;
 }
 
@@ -208,211 +379,499 @@ inline const std::vector<Vec2>& ScanlineRasterizer::GetSamplePattern(AAMode mode
     }
 }
 
-inline float ScanlineRasterizer::ComputePixelCoverage(int px, int py, const std::vector<Edge>& edges) {
-    if (_aaMode == AAMode::None) {
-        // Single sample at center
-        float x = px + 0.5f;
-        float y = py + 0.5f;
-        int winding = 0;
-        for (const auto& edge : edges) {
-            if (edge.IntersectsScanline(y)) {
-                float ex = edge.XAt(y);
-                if (ex > x) {
-                    winding += edge.direction;
-                }
-            }
-        }
-        return IsInside(winding) ? 1.0f : 0.0f;
-    }
+inline int ScanlineRasterizer::SampleRows(AAMode mode) {
+    if (mode == AAMode::Analytical) return c_AnalyticalRows;
+    return static_cast<int>(GetSamplePattern(mode).size());
+}
+
+inline float ScanlineRasterizer::SampleRowY(AAMode mode, int py, int sampleRow) {
+    if (mode == AAMode::Analytical) return py + (sampleRow + 0.5f) / c_AnalyticalRows;
+    return py + GetSamplePattern(mode)[sampleRow].y;
+}
+
+inline void ScanlineRasterizer::SortEdgeTable(std::vector<Edge>& edges) {
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return a.yMin < b.yMin;
+    });
+}
+
+inline void ScanlineRasterizer::ComputePixelBounds(EdgeList& edgeList, float minX, float minY,
+                                                   float maxX, float maxY, int width, int height) {
+    edgeList.yMin = std::max(0, static_cast<int>(std::floor(minY)));
+    edgeList.yMax = std::min(height - 1, static_cast<int>(std::ceil(maxY)));
+    edgeList.xMin = std::max(0, static_cast<int>(std::floor(minX)));
+    edgeList.xMax = std::min(width - 1, static_cast<int>(std::ceil(maxX)));
+}
 
-    if (_aaMode == AAMode::Analytical) {
-        return ComputeAnalyticalCoverage(px, py, edges);
+inline void ScanlineRasterizer::ScanEdges(const EdgeList& edgeList, const TileEdges* tile,
+                                          int clipX0, int clipY0, int clipX1, int clipY1,
+                                          const SpanSink& sink) {
+    int xMin = std::max(edgeList.xMin, clipX0);
+    int xMax = std::min(edgeList.xMax, clipX1);
+    int yMin = std::max(edgeList.yMin, clipY0);
+    int yMax = std::min(edgeList.yMax, clipY1);
+    if (edgeList.edges.empty() || xMin > xMax || yMin > yMax) return;
+
+    if (_aaMode == AAMode::AccumulatedArea) {
+        AccumulateEdges(edgeList, tile, xMin, xMax, yMin, yMax, sink);
+        return;
     }
 
-    // Multi-sample coverage
-    const auto& samples = GetSamplePattern(_aaMode);
-    int hitCount = 0;
+    // A tile activates from its own edge list, whose order (by yMin) is the
+    // edge table's
+    const std::vector<Edge>& edges = edgeList.edges;
+    const std::uint32_t* order = tile ? tile->edges : nullptr;
+    const size_t edgeCount = tile ? tile->edgeCount : edges.size();
+    const int* carry = tile ? tile->winding : nullptr;
+    const int sampleRows = SampleRows(_aaMode);
+    static const int noCarry[16] = {};  // Up to the 16x pattern
+    _activeEdges.clear();
+    size_t nextEdge = 0;
 
-    for (const auto& sample : samples) {
-        float x = px + sample.x;
-        float y = py + sample.y;
-        
-        int winding = 0;
-        for (const auto& edge : edges) {
-            if (edge.IntersectsScanline(y)) {
-                float ex = edge.XAt(y);
-                if (ex > x) {
-                    winding += edge.direction;
-                }
+    for (int y = yMin; y <= yMax; ++y) {
+        float rowTop = static_cast<float>(y);
+        float rowBottom = rowTop + 1.0f;
+
+        // Retire edges that ended above this scanline
+        _activeEdges.erase(
+            std::remove_if(_activeEdges.begin(), _activeEdges.end(),
+                           [rowTop](const ActiveEdge& ae) { return ae.yMax <= rowTop; }),
+            _activeEdges.end());
+
+        // Activate edges that start before the bottom of this scanline
+        while (nextEdge < edgeCount) {
+            size_t index = order ? order[nextEdge] : nextEdge;
+            const Edge& edge = edges[index];
+            if (edge.yMin >= rowBottom) break;
+            if (edge.yMax > rowTop) {
+                ActiveEdge ae;
+                ae.dxPerY = edge.dxPerY;
+                ae.yMax = edge.yMax;
+                ae.direction = edge.direction;
+                ae.index = static_cast<int>(index);
+                _activeEdges.push_back(ae);
             }
+            ++nextEdge;
         }
-        
-        if (IsInside(winding)) {
-            hitCount++;
+
+        const int* rowCarry = !tile ? nullptr : carry ? carry + (y - tile->rowTop) * sampleRows : noCarry;
+        if (_activeEdges.empty()) {
+            if (!carry) {
+                if (nextEdge >= edgeCount) break;
+                continue;
+            }
+            // Only the carry reaches this row: each sample row inside adds
+            // its weight to every pixel, as the scanline functions would
+            const float weight = 1.0f / sampleRows;
+            float coverage = 0.0f;
+            for (int s = 0; s < sampleRows; ++s) {
+                if (IsInside(rowCarry[s])) coverage += weight;
+            }
+            if (coverage > 0.0f) {
+                _rowCoverage.assign(xMax - xMin + 1, coverage);
+                EmitRowSpans(y, xMin, xMax, sink);
+            }
+            continue;
+        }
+
+        // x is evaluated per scanline instead of stepped, so coverage does
+        // not depend on the first row scanned (clipped / tiled rasterization)
+        for (auto& ae : _activeEdges) {
+            ae.x = edges[ae.index].XAt(rowTop);
+        }
+
+        if (_aaMode == AAMode::Analytical) {
+            ScanlineAnalytical(edges, rowCarry, y, xMin, xMax);
+        } else {
+            ScanlineSampled(edges, rowCarry, y, xMin, xMax);
         }
+
+        EmitRowSpans(y, xMin, xMax, sink);
     }
+}
+
+inline void ScanlineRasterizer::EmitRowSpans(int y, int xMin, int xMax, const SpanSink& sink) {
+    float* row = _rowCoverage.data();
+    int count = xMax - xMin + 1;
+    int i = 0;
+    while (i < count) {
+        float cov = row[i];
+        if (cov <= 1e-6f) {
+            ++i;
+            continue;
+        }
 
-    return static_cast<float>(hitCount) / samples.size();
+        int start = i;
+        CoverageSpan span;
+        span.y = y;
+        span.x0 = xMin + start;
+        if (cov >= 1.0f - 1e-6f) {
+            // Solid interior run
+            while (i < count && row[i] >= 1.0f - 1e-6f) ++i;
+            span.alpha = 1.0f;
+            span.coverage = nullptr;
+        } else {
+            // Partial run (edge pixels)
+            while (i < count && row[i] > 1e-6f && row[i] < 1.0f - 1e-6f) ++i;
+            span.alpha = 0.0f;
+            span.coverage = row + start;
+        }
+        span.x1 = xMin + i - 1;
+        sink(span);
+    }
 }
 
-inline float ScanlineRasterizer::ComputeAnalyticalCoverage(int px, int py, const std::vector<Edge>& edges) {
-    // Analytical coverage: compute exact intersection area
-    // This is a simplified version that works well for most cases
-    
-    float left = static_cast<float>(px);
-    float right = static_cast<float>(px + 1);
-    float top = static_cast<float>(py);
-    float bottom = static_cast<float>(py + 1);
-    
-    // For each edge that intersects this pixel, compute contribution
-    float coverage = 0.0f;
-    bool anyInside = false;
-    
-    // Sample at multiple y levels within the pixel
-    const int ySteps = 8;
-    for (int yi = 0; yi < ySteps; ++yi) {
-        float y = top + (yi + 0.5f) / ySteps;
-        
-        std::vector<std::pair<float, int>> intersections;
-        
-        for (const auto& edge : edges) {
-            if (edge.IntersectsScanline(y)) {
-                float x = edge.XAt(y);
-                if (x >= left - 0.5f && x <= right + 0.5f) {
-                    intersections.push_back({x, edge.direction});
-                }
-            }
+inline SpanSink ScanlineRasterizer::BufferSink(std::vector<float>& coverage, int width) {
+    return [&coverage, width](const CoverageSpan& span) {
+        float* row = coverage.data() + static_cast<size_t>(span.y) * width;
+        for (int x = span.x0; x <= span.x1; ++x) {
+            row[x] = span.At(x);
         }
-        
-        // Sort intersections by x
-        std::sort(intersections.begin(), intersections.end());
-        
-        // Calculate coverage for this scanline within pixel
+    };
+}
+
+inline void ScanlineRasterizer::CollectCrossings(const std::vector<Edge>& edges, int py, float sampleY,
+                                                 const int* carry, int xMin, int xMax) {
+    _crossings.clear();
+    float dy = sampleY - static_cast<float>(py);
+    for (const auto& ae : _activeEdges) {
+        if (sampleY >= edges[ae.index].yMin && sampleY < ae.yMax) {
+            _crossings.push_back({ae.x + dy * ae.dxPerY, ae.direction});
+        }
+    }
+    if (carry) {
+        // The edges left of the tile only ever add their winding to the
+        // intervals reaching it, and those right of it only close the last
+        // interval; neither touches a pixel. Binning keeps a pixel of slack
+        // on both sides, so these stand-ins give the same coverage.
+        if (*carry != 0) _crossings.push_back({static_cast<float>(xMin) - 1.0f, *carry});
+        if (!_crossings.empty()) _crossings.push_back({static_cast<float>(xMax) + 2.0f, 0});
+    }
+    std::sort(_crossings.begin(), _crossings.end());
+}
+
+inline void ScanlineRasterizer::ScanlineSampled(const std::vector<Edge>& edges, const int* carry,
+                                                int py, int xMin, int xMax) {
+    const auto& samples = GetSamplePattern(_aaMode);
+    float weight = 1.0f / samples.size();
+
+    _rowCoverage.assign(xMax - xMin + 1, 0.0f);
+
+    for (size_t s = 0; s < samples.size(); ++s) {
+        const Vec2& sample = samples[s];
+        CollectCrossings(edges, py, SampleRowY(_aaMode, py, static_cast<int>(s)),
+                         carry ? carry + s : nullptr, xMin, xMax);
+
+        // Walk the sorted crossings; the winding number is constant between two of them
         int winding = 0;
-        float lastX = left;
-        float rowCoverage = 0.0f;
-        
-        for (const auto& [x, dir] : intersections) {
-            float clampedX = std::clamp(x, left, right);
-            
-            if (IsInside(winding)) {
-                rowCoverage += clampedX - lastX;
-                anyInside = true;
+        for (size_t i = 0; i + 1 < _crossings.size(); ++i) {
+            winding += _crossings[i].second;
+            if (!IsInside(winding)) continue;
+
+            // Pixels whose sample x falls in [x0, x1)
+            int px0 = static_cast<int>(std::ceil(_crossings[i].first - sample.x));
+            int px1 = static_cast<int>(std::ceil(_crossings[i + 1].first - sample.x)) - 1;
+            px0 = std::max(px0, xMin);
+            px1 = std::min(px1, xMax);
+            for (int px = px0; px <= px1; ++px) {
+                _rowCoverage[px - xMin] += weight;
             }
-            
-            winding += dir;
-            lastX = clampedX;
         }
-        
-        // Handle remaining span
-        if (IsInside(winding)) {
-            rowCoverage += right - lastX;
-            anyInside = true;
-        }
-        
-        coverage += rowCoverage;
     }
-    
-    // If no edges intersect but we might be fully inside, check center
-    if (!anyInside) {
-        float cx = px + 0.5f;
-        float cy = py + 0.5f;
+}
+
+inline void ScanlineRasterizer::ScanlineAnalytical(const std::vector<Edge>& edges, const int* carry,
+                                                   int py, int xMin, int xMax) {
+    // Exact horizontal coverage on 8 sub-scanlines per pixel row
+    const int ySteps = c_AnalyticalRows;
+    const float weight = 1.0f / ySteps;
+    const float left = static_cast<float>(xMin);
+    const float right = static_cast<float>(xMax + 1);
+
+    _rowCoverage.assign(xMax - xMin + 1, 0.0f);
+
+    for (int yi = 0; yi < ySteps; ++yi) {
+        CollectCrossings(edges, py, SampleRowY(AAMode::Analytical, py, yi),
+                         carry ? carry + yi : nullptr, xMin, xMax);
+
         int winding = 0;
-        for (const auto& edge : edges) {
-            if (edge.IntersectsScanline(cy)) {
-                float ex = edge.XAt(cy);
-                if (ex > cx) {
-                    winding += edge.direction;
-                }
+        for (size_t i = 0; i + 1 < _crossings.size(); ++i) {
+            winding += _crossings[i].second;
+            if (!IsInside(winding)) continue;
+
+            float x0 = std::clamp(_crossings[i].first, left, right);
+            float x1 = std::clamp(_crossings[i + 1].first, left, right);
+            if (x1 <= x0) continue;
+
+            int ix0 = static_cast<int>(std::floor(x0));
+            int ix1 = static_cast<int>(std::floor(x1));
+            if (ix0 == ix1) {
+                _rowCoverage[ix0 - xMin] += (x1 - x0) * weight;
+                continue;
+            }
+            _rowCoverage[ix0 - xMin] += (ix0 + 1 - x0) * weight;
+            for (int px = ix0 + 1; px < ix1; ++px) {
+                _rowCoverage[px - xMin] += weight;
+            }
+            if (ix1 <= xMax) {
+                _rowCoverage[ix1 - xMin] += (x1 - ix1) * weight;
             }
         }
-        return IsInside(winding) ? 1.0f : 0.0f;
     }
-    
-    // Normalize by pixel area and number of samples
-    return std::clamp(coverage / ySteps, 0.0f, 1.0f);
 }
 
-inline void ScanlineRasterizer::Rasterize(const std::vector<Vec2>& polygon,
-                                           int width, int height,
-                                           std::vector<float>& coverage) {
-    coverage.resize(width * height, 0.0f);
-    
-    if (polygon.size() < 3) return;
-    
-    // Build edge table
-    std::vector<Edge> edges = BuildEdgeTable(polygon);
-    if (edges.empty()) return;
-    
-    // Compute bounding box
-    BBox bbox = Geometry::ComputeBBox(polygon);
-    
-    int yMin = std::max(0, static_cast<int>(std::floor(bbox.min.y)));
-    int yMax = std::min(height - 1, static_cast<int>(std::ceil(bbox.max.y)));
-    int xMin = std::max(0, static_cast<int>(std::floor(bbox.min.x)));
-    int xMax = std::min(width - 1, static_cast<int>(std::ceil(bbox.max.x)));
-    
-    // Process each scanline
+//=============================================================================
+// Signed-area accumulation (AccumulatedArea)
+//
+// Every edge deposits, per pixel it crosses, the signed area it covers to its
+// right into _accumulation; a prefix sum along each row then gives the exact
+// winding-weighted coverage. The buffer only spans the visible blocks.
+//=============================================================================
+
+inline void ScanlineRasterizer::AccumulateEdges(const EdgeList& edgeList, const TileEdges* tile,
+                                                int xMin, int xMax, int yMin, int yMax,
+                                                const SpanSink& sink) {
+    // The row prefix sum restarts at every canvas-aligned block, from the
+    // cover of everything left of the block: its carry. Each edge is split at
+    // the block sides and deposited once; the cover of its piece in a block
+    // goes to that block's carry column too, and the carries are chained
+    // from the shape's first block on. Block extents and carries only depend
+    // on the shape, never on the clip rect. A tile starts the chain at its
+    // first block, from the cover TileBinner carried in.
+    const int blockSize = c_AccumulationBlock;
+    const int firstBlock = xMin / blockSize;
+    const int lastBlock = xMax / blockSize;
+    const int originBlock = tile ? firstBlock : edgeList.xMin / blockSize;
+    const int rows = yMax - yMin + 1;
+
+    // Two spare columns per block: one for pieces on its right side, one for
+    // the spill of its last column
+    const int blockStride = blockSize + 2;
+    _accumulationStride = (lastBlock - firstBlock + 1) * blockStride;
+    _accumulation.assign(static_cast<size_t>(_accumulationStride) * rows, 0.0f);
+    // Column 0 holds what is left of originBlock, column 1 + i the cover of block originBlock + i
+    _cover.assign(static_cast<size_t>(lastBlock - originBlock + 1) * rows, 0.0f);
+
+    const std::vector<Edge>& edges = edgeList.edges;
+    const size_t edgeCount = tile ? tile->edgeCount : edges.size();
+    for (size_t i = 0; i < edgeCount; ++i) {
+        const Edge& edge = edges[tile ? tile->edges[i] : i];
+        if (edge.yMax <= yMin || edge.yMin >= yMax + 1) continue;
+        ForEachEdgePiece(edgeList, edge, originBlock, lastBlock, !tile,
+                         [&](int block, float ya, float yb, float left, float right) {
+            if (block < lastBlock) {
+                float* cover = _cover.data() + static_cast<size_t>(block - originBlock + 1) * rows;
+                AccumulateCover(ya, yb, edge.direction, yMin, yMax, cover);
+            }
+            if (block >= firstBlock) {
+                float* columns = _accumulation.data() + static_cast<size_t>(block - firstBlock) * blockStride;
+                AccumulatePiece(edge, ya, yb, left, right, columns, block * blockSize, yMin, yMax);
+            }
+        });
+    }
+
+    _rowCoverage.resize(xMax - xMin + 1);
     for (int y = yMin; y <= yMax; ++y) {
-        // Collect edges that intersect this scanline range
-        std::vector<const Edge*> activeEdges;
-        for (const auto& edge : edges) {
-            if (edge.yMin <= y + 1 && edge.yMax >= y) {
-                activeEdges.push_back(&edge);
+        const size_t row = static_cast<size_t>(y - yMin);
+        const float* acc = _accumulation.data() + row * _accumulationStride;
+        float carry = tile ? (tile->cover ? tile->cover[y - tile->rowTop] : 0.0f) : _cover[row];
+        for (int block = originBlock; block <= lastBlock; ++block) {
+            if (block >= firstBlock) {
+                int blockX0 = block * blockSize;
+                int emitX1 = std::min(xMax, blockX0 + blockSize - 1);
+                const float* columns = acc + static_cast<size_t>(block - firstBlock) * blockStride;
+                float winding = carry;
+                for (int x = blockX0; x <= emitX1; ++x) {
+                    winding += columns[x - blockX0];
+                    if (x >= xMin) {
+                        _rowCoverage[x - xMin] = ResolveAccumulated(winding);
+                    }
+                }
             }
-        }
-        
-        if (activeEdges.empty()) continue;
-        
-        // Compute coverage for each pixel in scanline
-        for (int x = xMin; x <= xMax; ++x) {
-            float cov = ComputePixelCoverage(x, y, edges);
-            if (cov > 0) {
-                coverage[y * width + x] = cov;
+            if (block < lastBlock) {
+                carry += _cover[static_cast<size_t>(block - originBlock + 1) * rows + row];
             }
         }
+        EmitRowSpans(y, xMin, xMax, sink);
     }
 }
 
-inline std::vector<Edge> ScanlineRasterizer::BuildEdgeTableFromSubPaths(const std::vector<std::vector<Vec2>>& subPaths) {
-    std::vector<Edge> edges;
-    
-    for (const auto& polygon : subPaths) {
-        size_t n = polygon.size();
-        if (n < 2) continue;
-        
-        for (size_t i = 0; i < n; ++i) {
-            size_t j = (i + 1) % n;
-            const Vec2& p0 = polygon[i];
-            const Vec2& p1 = polygon[j];
-            
-            // Skip horizontal edges
-            if (std::abs(p0.y - p1.y) > 1e-6f) {
-                edges.emplace_back(p0, p1);
+template <typename Piece>
+inline void ScanlineRasterizer::ForEachEdgePiece(const EdgeList& edgeList, const Edge& edge,
+                                                 int firstBlock, int lastBlock, bool withLeft,
+                                                 Piece&& piece) {
+    // Blocks within a pixel of the edge's x extent; EdgePiece finds the exact parts
+    const float blockSize = static_cast<float>(c_AccumulationBlock);
+    float xBottom = edge.XAt(edge.yMax);
+    float xLow = std::min(edge.xAtYMin, xBottom) - 1.0f;
+    float xHigh = std::max(edge.xAtYMin, xBottom) + 1.0f;
+    float ya, yb;
+
+    const float firstX = firstBlock * blockSize;
+    if (withLeft && xLow < firstX &&
+        EdgePiece(edge, -std::numeric_limits<float>::infinity(), firstX, ya, yb)) {
+        piece(firstBlock - 1, ya, yb, -std::numeric_limits<float>::infinity(), firstX);
+    }
+
+    auto blockOf = [&](float x) {
+        return static_cast<int>(std::floor(std::clamp(x / blockSize, firstBlock - 1.0f, lastBlock + 1.0f)));
+    };
+    int block0 = std::max(firstBlock, blockOf(xLow));
+    int block1 = std::min(lastBlock, blockOf(xHigh));
+    for (int block = block0; block <= block1; ++block) {
+        // The last block ends at the shape's bounds: nothing right of it is visible
+        float left = block * blockSize;
+        float right = static_cast<float>(std::min((block + 1) * c_AccumulationBlock, edgeList.xMax + 1));
+        if (EdgePiece(edge, left, right, ya, yb)) {
+            piece(block, ya, yb, left, right);
+        }
+    }
+}
+
+inline bool ScanlineRasterizer::EdgePiece(const Edge& edge, float left, float right, float& ya, float& yb) {
+    float x0 = edge.xAtYMin;
+    float dxdy = (edge.XAt(edge.yMax) - x0) / (edge.yMax - edge.yMin);
+    if (dxdy == 0) {
+        // Vertical: belongs to the block it is in, the left side included
+        if (x0 < left || x0 >= right) return false;
+        ya = edge.yMin;
+        yb = edge.yMax;
+        return true;
+    }
+    float tLeft = (left - x0) / dxdy + edge.yMin;
+    float tRight = (right - x0) / dxdy + edge.yMin;
+    ya = std::clamp(std::min(tLeft, tRight), edge.yMin, edge.yMax);
+    yb = std::clamp(std::max(tLeft, tRight), edge.yMin, edge.yMax);
+    return yb > ya;
+}
+
+inline void ScanlineRasterizer::AccumulateCover(float y0, float y1, int direction, int yMin, int yMax,
+                                                float* cover) {
+    float top = std::max(y0, static_cast<float>(yMin));
+    float bottom = std::min(y1, static_cast<float>(yMax + 1));
+    if (bottom <= top) return;
+
+    int rowStart = static_cast<int>(std::floor(top));
+    int rowEnd = static_cast<int>(std::ceil(bottom));
+    for (int y = rowStart; y < rowEnd; ++y) {
+        // The same per-row cover AccumulateSegment deposits
+        float ya = std::max(static_cast<float>(y), y0);
+        float yb = std::min(static_cast<float>(y + 1), y1);
+        cover[y - yMin] += (yb - ya) * direction;
+    }
+}
+
+inline float ScanlineRasterizer::ResolveAccumulated(float winding) const {
+    float w = std::abs(winding);
+    if (_fillRule == FillRule::EvenOdd) {
+        // Fold the accumulated winding into [0, 1]: 1 inside odd, 0 inside even
+        w -= 2.0f * std::floor(w * 0.5f);
+        return w > 1.0f ? 2.0f - w : w;
+    }
+    return std::min(w, 1.0f);
+}
+
+inline void ScanlineRasterizer::AccumulatePiece(const Edge& edge, float ya, float yb, float left, float right,
+                                                float* block, int blockX0, int yMin, int yMax) {
+    // The ends are evaluated on the whole edge, so the pieces of neighbouring
+    // blocks meet exactly
+    float x0 = edge.xAtYMin;
+    float x1 = edge.XAt(edge.yMax);
+    float dxdy = (x1 - x0) / (edge.yMax - edge.yMin);
+    float xa = std::clamp(x0 + (ya - edge.yMin) * dxdy, left, right);
+    float xb = std::clamp(yb == edge.yMax ? x1 : x0 + (yb - edge.yMin) * dxdy, left, right);
+    AccumulateSegment(xa, ya, xb, yb, edge.direction, block, blockX0, yMin, yMax);
+}
+
+inline void ScanlineRasterizer::AccumulateSegment(float x0, float y0, float x1, float y1, int direction,
+                                                  float* block, int xMin, int yMin, int yMax) {
+    // x0/x1 are already inside the block, [xMin, xMin + c_AccumulationBlock]
+    float dxdy = (x1 - x0) / (y1 - y0);
+    float top = std::max(y0, static_cast<float>(yMin));
+    float bottom = std::min(y1, static_cast<float>(yMax + 1));
+    if (bottom <= top) return;
+
+    const float maxX = static_cast<float>(c_AccumulationBlock);
+    int rowStart = static_cast<int>(std::floor(top));
+    int rowEnd = static_cast<int>(std::ceil(bottom));
+
+    for (int y = rowStart; y < rowEnd; ++y) {
+        float* acc = block + static_cast<size_t>(y - yMin) * _accumulationStride;
+
+        // Both ends are evaluated per row (not stepped), so the deposits of a
+        // row do not depend on which rows are being accumulated
+        float ya = std::max(static_cast<float>(y), y0);
+        float yb = std::min(static_cast<float>(y + 1), y1);
+        float x = std::clamp(x0 + (ya - y0) * dxdy - xMin, 0.0f, maxX);
+        float xNext = std::clamp(x0 + (yb - y0) * dxdy - xMin, 0.0f, maxX);
+        float d = (yb - ya) * direction;
+
+        float xl = std::min(x, xNext);
+        float xr = std::max(x, xNext);
+        float xlFloor = std::floor(xl);
+        int xli = static_cast<int>(xlFloor);
+        int xri = static_cast<int>(std::ceil(xr));
+
+        if (xri <= xli + 1) {
+            // Stays within one pixel column: split by the mean x
+            float xmf = 0.5f * (x + xNext) - xlFloor;
+            acc[xli] += d - d * xmf;
+            acc[xli + 1] += d * xmf;
+        } else {
+            // Spans several columns: trapezoid areas per column
+            float s = 1.0f / (xr - xl);
+            float xlf = xl - xlFloor;
+            float a0 = 0.5f * s * (1.0f - xlf) * (1.0f - xlf);
+            float xrf = xr - static_cast<float>(xri) + 1.0f;
+            float am = 0.5f * s * xrf * xrf;
+            acc[xli] += d * a0;
+            if (xri == xli + 2) {
+                acc[xli + 1] += d * (1.0f - a0 - am);
+            } else {
+                float a1 = s * (1.5f - xlf);
+                acc[xli + 1] += d * (a1 - a0);
+                for (int xi = xli + 2; xi < xri - 1; ++xi) {
+                    acc[xi] += d * s;
+                }
+                float a2 = a1 + (xri - xli - 3) * s;
+                acc[xri - 1] += d * (1.0f - a2 - am);
             }
+            acc[xri] += d * am;
         }
     }
-    
-    return edges;
 }
 
-inline void ScanlineRasterizer::RasterizeSubPaths(const std::vector<std::vector<Vec2>>& subPaths,
-                                                   int width, int height,
-                                                   std::vector<float>& coverage) {
-    coverage.resize(width * height, 0.0f);
-    
-    if (subPaths.empty()) return;
-    
+inline EdgeList ScanlineRasterizer::PrepareEdges(const std::vector<Vec2>& polygon, int width, int height) {
+    EdgeList edgeList;
+    if (polygon.size() < 3) return edgeList;
+
+    // Build edge table
+    edgeList.edges = BuildEdgeTable(polygon);
+    if (edgeList.edges.empty()) return edgeList;
+    SortEdgeTable(edgeList.edges);
+
+    // Compute bounding box
+    BBox bbox = Geometry::ComputeBBox(polygon);
+    ComputePixelBounds(edgeList, bbox.min.x, bbox.min.y, bbox.max.x, bbox.max.y, width, height);
+    return edgeList;
+}
+
+inline EdgeList ScanlineRasterizer::PrepareEdges(const std::vector<std::vector<Vec2>>& subPaths,
+                                                 int width, int height) {
+    EdgeList edgeList;
+    if (subPaths.empty()) return edgeList;
+
     // Build edge table from all sub-paths
-    std::vector<Edge> edges = BuildEdgeTableFromSubPaths(subPaths);
-    if (edges.empty()) return;
-    
+    edgeList.edges = BuildEdgeTableFromSubPaths(subPaths);
+    if (edgeList.edges.empty()) return edgeList;
+    SortEdgeTable(edgeList.edges);
+
     // Compute combined bounding box
     float minX = std::numeric_limits<float>::max();
     float maxX = std::numeric_limits<float>::lowest();
     float minY = std::numeric_limits<float>::max();
     float maxY = std::numeric_limits<float>::lowest();
-    
+
     for (const auto& polygon : subPaths) {
         for (const auto& p : polygon) {
             minX = std::min(minX, p.x);
@@ -421,32 +880,87 @@ inline void ScanlineRasterizer::RasterizeSubPaths(const std::vector<std::vector<
             maxY = std::max(maxY, p.y);
         }
     }
-    
-    int yMin = std::max(0, static_cast<int>(std::floor(minY)));
-    int yMax = std::min(height - 1, static_cast<int>(std::ceil(maxY)));
-    int xMin = std::max(0, static_cast<int>(std::floor(minX)));
-    int xMax = std::min(width - 1, static_cast<int>(std::ceil(maxX)));
-    
-    // Process each scanline
-    for (int y = yMin; y <= yMax; ++y) {
-        // Collect edges that intersect this scanline range
-        std::vector<const Edge*> activeEdges;
-        for (const auto& edge : edges) {
-            if (edge.yMin <= y + 1 && edge.yMax >= y) {
-                activeEdges.push_back(&edge);
-            }
-        }
-        
-        if (activeEdges.empty()) continue;
-        
-        // Compute coverage for each pixel in scanline
-        for (int x = xMin; x <= xMax; ++x) {
-            float cov = ComputePixelCoverage(x, y, edges);
-            if (cov > 0) {
-                coverage[y * width + x] = cov;
-            }
+
+    ComputePixelBounds(edgeList, minX, minY, maxX, maxY, width, height);
+    return edgeList;
+}
+
+inline EdgeList ScanlineRasterizer::PrepareEdges(const FlattenedPath& path, int width, int height) {
+    EdgeList edgeList;
+
+    float minX = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float minY = std::numeric_limits<float>::max();
+    float maxY = std::numeric_limits<float>::lowest();
+
+    edgeList.edges.reserve(path.points.size());
+    for (const auto& contour : path.contours) {
+        if (contour.count < 3) continue;
+        const Vec2* points = path.ContourPoints(contour);
+        AppendContourEdges(points, contour.count, edgeList.edges);
+        for (std::uint32_t i = 0; i < contour.count; ++i) {
+            minX = std::min(minX, points[i].x);
+            maxX = std::max(maxX, points[i].x);
+            minY = std::min(minY, points[i].y);
+            maxY = std::max(maxY, points[i].y);
         }
     }
+    if (edgeList.edges.empty()) return edgeList;
+    SortEdgeTable(edgeList.edges);
+
+    ComputePixelBounds(edgeList, minX, minY, maxX, maxY, width, height);
+    return edgeList;
+}
+
+inline void ScanlineRasterizer::Rasterize(const EdgeList& edgeList, const SpanSink& sink) {
+    ScanEdges(edgeList, nullptr, edgeList.xMin, edgeList.yMin, edgeList.xMax, edgeList.yMax, sink);
+}
+
+inline void ScanlineRasterizer::RasterizeClipped(const EdgeList& edgeList,
+                                                  int clipX0, int clipY0, int clipX1, int clipY1,
+                                                  const SpanSink& sink) {
+    ScanEdges(edgeList, nullptr, clipX0, clipY0, clipX1, clipY1, sink);
+}
+
+inline void ScanlineRasterizer::RasterizeTile(const EdgeList& edgeList, const TileEdges& tile,
+                                               int clipX0, int clipY0, int clipX1, int clipY1,
+                                               const SpanSink& sink) {
+    if (tile.IsEmpty()) return;
+    ScanEdges(edgeList, &tile, clipX0, clipY0, clipX1, clipY1, sink);
+}
+
+inline void ScanlineRasterizer::Rasterize(const std::vector<Vec2>& polygon,
+                                           int width, int height,
+                                           std::vector<float>& coverage) {
+    coverage.resize(width * height, 0.0f);
+    Rasterize(polygon, width, height, BufferSink(coverage, width));
+}
+
+inline void ScanlineRasterizer::Rasterize(const std::vector<Vec2>& polygon,
+                                           int width, int height,
+                                           const SpanSink& sink) {
+    Rasterize(PrepareEdges(polygon, width, height), sink);
+}
+
+inline std::vector<Edge> ScanlineRasterizer::BuildEdgeTableFromSubPaths(const std::vector<std::vector<Vec2>>& subPaths) {
+    std::vector<Edge> edges;
+    for (const auto& polygon : subPaths) {
+        AppendContourEdges(polygon.data(), polygon.size(), edges);
+    }
+    return edges;
+}
+
+inline void ScanlineRasterizer::RasterizeSubPaths(const std::vector<std::vector<Vec2>>& subPaths,
+                                                   int width, int height,
+                                                   std::vector<float>& coverage) {
+    coverage.resize(width * height, 0.0f);
+    RasterizeSubPaths(subPaths, width, height, BufferSink(coverage, width));
+}
+
+inline void ScanlineRasterizer::RasterizeSubPaths(const std::vector<std::vector<Vec2>>& subPaths,
+                                                   int width, int height,
+                                                   const SpanSink& sink) {
+    Rasterize(PrepareEdges(subPaths, width, height), sink);
 }
 
 inline void ScanlineRasterizer::RasterizeClipped(const std::vector<Vec2>& polygon,
@@ -455,30 +969,22 @@ inline void ScanlineRasterizer::RasterizeClipped(const std::vector<Vec2>& polygo
                                                   std::vector<float>& coverage) {
     // Same as Rasterize but clipped to given rectangle
     coverage.resize(width * height, 0.0f);
-    
-    if (polygon.size() < 3) return;
-    
-    std::vector<Edge> edges = BuildEdgeTable(polygon);
-    if (edges.empty()) return;
-    
-    BBox bbox = Geometry::ComputeBBox(polygon);
-    bbox = bbox.Intersection(clipRect);
-    
-    if (bbox.IsEmpty()) return;
-    
-    int yMin = std::max(0, static_cast<int>(std::floor(bbox.min.y)));
-    int yMax = std::min(height - 1, static_cast<int>(std::ceil(bbox.max.y)));
-    int xMin = std::max(0, static_cast<int>(std::floor(bbox.min.x)));
-    int xMax = std::min(width - 1, static_cast<int>(std::ceil(bbox.max.x)));
-    
-    for (int y = yMin; y <= yMax; ++y) {
-        for (int x = xMin; x <= xMax; ++x) {
-            float cov = ComputePixelCoverage(x, y, edges);
-            if (cov > 0) {
-                coverage[y * width + x] = cov;
-            }
-        }
-    }
+    RasterizeClipped(polygon, clipRect, width, height, BufferSink(coverage, width));
+}
+
+inline void ScanlineRasterizer::RasterizeClipped(const std::vector<Vec2>& polygon,
+                                                  const BBox& clipRect,
+                                                  int width, int height,
+                                                  const SpanSink& sink) {
+    if (clipRect.IsEmpty()) return;
+
+    EdgeList edgeList = PrepareEdges(polygon, width, height);
+    RasterizeClipped(edgeList,
+                     static_cast<int>(std::floor(clipRect.min.x)),
+                     static_cast<int>(std::floor(clipRect.min.y)),
+                     static_cast<int>(std::ceil(clipRect.max.x)),
+                     static_cast<int>(std::ceil(clipRect.max.y)),
+                     sink);
 }
 
 } // namespace VCX::Labs::SVG
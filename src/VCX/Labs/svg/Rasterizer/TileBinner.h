@@ -0,0 +1,402 @@
+#pragma once
+
+#include "Rasterizer/ScanlineRasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// TileBinner - Edge lists split over a grid of square tiles
+//
+// Each list's edges are bucketed per tile row, and listed in every tile of
+// that row they come within a pixel of. Edges entirely left of a tile are
+// not listed there: what they add is carried in instead (see TileEdges), so
+// a tile walks only the edges that touch it, yet its coverage is the one of
+// the whole list clipped to the tile.
+//
+// Binning (Add) runs in painter's order on one thread and costs one step per
+// edge and tile row, plus one per edge and tile it touches. The carries are
+// then resolved per (list, tile row): those jobs are independent and may run
+// in parallel, as may the tiles afterwards.
+//=============================================================================
+class TileBinner {
+public:
+    using AAMode = ScanlineRasterizer::AAMode;
+
+    // One list in one tile
+    struct Entry {
+        std::uint32_t list;         // As passed to Add
+        std::uint32_t edgeCount;
+        size_t firstEdge;           // Into the edge index pool
+        std::int64_t carry;         // Into the winding or cover pool, -1 if nothing is carried in
+        bool cover;                 // AccumulatedArea: carry is a cover
+    };
+
+    // Grid of tileSize squares aligned to the canvas, over the inclusive
+    // pixel rect [x0, x1] x [y0, y1]; drops the lists binned so far
+    void Reset(int tileSize, int x0, int y0, int x1, int y1);
+
+    // Bins a list after the previous ones; aaMode decides what is carried in
+    void Add(const EdgeList& edgeList, AAMode aaMode, std::uint32_t list);
+
+    // Fills in the carries of one (list, tile row) job
+    size_t GetCarryJobCount() const { return _jobs.size(); }
+    void ResolveCarries(size_t job);
+
+    size_t GetTileCount() const { return _bins.size(); }
+    // The lists reaching a tile, in the order they were added
+    const std::vector<Entry>& GetEntries(size_t tile) const { return _bins[tile]; }
+    // Inclusive pixel rect of a tile, clipped to the grid's rect
+    void GetTileRect(size_t tile, int& x0, int& y0, int& x1, int& y1) const;
+    // ScanlineRasterizer::RasterizeTile's view of an entry; empty if it draws nothing
+    TileEdges GetTileEdges(size_t tile, const Entry& entry) const;
+
+    size_t GetBufferBytes() const;
+
+private:
+    // An edge in a tile row: it comes within a pixel of the tiles
+    // [firstTile, leftOfTile), and is entirely left of those after
+    struct BandEdge {
+        std::uint32_t edge;
+        int firstTile;
+        int leftOfTile;
+    };
+
+    struct EntryRef {
+        std::uint32_t tile;         // c_NoTile if the list has no entry there
+        std::uint32_t index;
+    };
+    static constexpr std::uint32_t c_NoTile = ~0u;
+
+    struct CarryJob {
+        const EdgeList* edgeList;
+        AAMode aaMode;
+        int band;                   // Tile row on the canvas
+        int tile0, tile1;           // Tile columns of the list on the canvas
+        size_t firstEdge;           // Into _bandEdges
+        size_t edgeCount;
+        size_t firstEntry;          // Into _entryRefs, one per column in [tile0, tile1]
+    };
+
+    // First row in [0, _tileSize] of a tile row whose given sample row is at
+    // or below y, as CollectCrossings tests it
+    int FirstSampleRow(AAMode mode, int rowTop, int sampleRow, float y) const;
+    void ResolveWinding(const CarryJob& job);
+    void ResolveCover(const CarryJob& job);
+    Entry* EntryAt(const CarryJob& job, int column);
+
+    int _tileSize = 64;
+    int _x0 = 0, _y0 = 0, _x1 = -1, _y1 = -1;
+    int _tileX0 = 0, _tileY0 = 0, _tilesX = 0;
+
+    std::vector<std::vector<Entry>> _bins;
+    std::vector<std::uint32_t> _edgePool;
+    std::vector<int> _windingPool;
+    std::vector<float> _coverPool;
+    std::vector<CarryJob> _jobs;
+    std::vector<BandEdge> _bandEdges;
+    std::vector<EntryRef> _entryRefs;
+
+    // Add's scratch, kept for its capacity
+    std::vector<std::vector<BandEdge>> _bands;
+    std::vector<size_t> _tileEdges;
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline void TileBinner::Reset(int tileSize, int x0, int y0, int x1, int y1) {
+    _tileSize = tileSize;
+    _x0 = x0;
+    _y0 = y0;
+    _x1 = x1;
+    _y1 = y1;
+    _tileX0 = x0 / tileSize;
+    _tileY0 = y0 / tileSize;
+    _tilesX = x0 > x1 ? 0 : x1 / tileSize - _tileX0 + 1;
+    int tilesY = y0 > y1 ? 0 : y1 / tileSize - _tileY0 + 1;
+
+    _bins.resize(static_cast<size_t>(_tilesX) * tilesY);
+    for (auto& bin : _bins) bin.clear();
+    _edgePool.clear();
+    _windingPool.clear();
+    _coverPool.clear();
+    _jobs.clear();
+    _bandEdges.clear();
+    _entryRefs.clear();
+}
+
+inline void TileBinner::Add(const EdgeList& edgeList, AAMode aaMode, std::uint32_t list) {
+    int x0 = std::max(edgeList.xMin, _x0);
+    int x1 = std::min(edgeList.xMax, _x1);
+    int y0 = std::max(edgeList.yMin, _y0);
+    int y1 = std::min(edgeList.yMax, _y1);
+    if (edgeList.edges.empty() || x0 > x1 || y0 > y1) return;
+
+    const int size = _tileSize;
+    const int tile0 = x0 / size;
+    const int tile1 = x1 / size;
+    const int band0 = y0 / size;
+    const int band1 = y1 / size;
+    if (_bands.size() < static_cast<size_t>(band1 - band0 + 1)) _bands.resize(band1 - band0 + 1);
+    for (int band = band0; band <= band1; ++band) _bands[band - band0].clear();
+
+    // Bucket the edges per tile row, keeping their order (by yMin)
+    auto tileOf = [&](float x) {
+        return static_cast<int>(std::floor(std::clamp(x / size, tile0 - 1.0f, tile1 + 1.0f)));
+    };
+    const std::vector<Edge>& edges = edgeList.edges;
+    for (std::uint32_t i = 0; i < edges.size(); ++i) {
+        const Edge& edge = edges[i];
+        if (edge.yMin >= y1 + 1) break;
+        int rowFirst = std::max(y0, static_cast<int>(std::floor(edge.yMin)));
+        int rowLast = std::min(y1, static_cast<int>(std::ceil(edge.yMax)) - 1);
+        if (rowFirst > rowLast) continue;
+
+        for (int band = rowFirst / size; band <= rowLast / size; ++band) {
+            // x extent over the tile row, with a pixel of slack for rounding
+            float xa = edge.XAt(std::max(edge.yMin, static_cast<float>(band * size)));
+            float xb = edge.XAt(std::min(edge.yMax, static_cast<float>((band + 1) * size)));
+            int firstTile = tileOf(std::min(xa, xb) - 1.0f);
+            int leftOfTile = tileOf(std::max(xa, xb) + 1.0f) + 1;
+            _bands[band - band0].push_back({ i, firstTile, leftOfTile });
+        }
+    }
+
+    const bool area = aaMode == AAMode::AccumulatedArea;
+    const size_t carrySize = area ? size : static_cast<size_t>(size) * ScanlineRasterizer::SampleRows(aaMode);
+    const int columns = tile1 - tile0 + 1;
+    for (int band = band0; band <= band1; ++band) {
+        // No edge on the tile row: no crossing either, so nothing is inside
+        const std::vector<BandEdge>& bandEdges = _bands[band - band0];
+        if (bandEdges.empty()) continue;
+
+        // Edges per tile, and the first tile that may get something carried
+        // in: one right of an edge, or for AccumulatedArea right of a part
+        // of one
+        _tileEdges.assign(columns, 0);
+        int carryFrom = tile1 + 1;
+        for (const BandEdge& bandEdge : bandEdges) {
+            int first = std::max(bandEdge.firstTile, tile0);
+            int last = std::min(bandEdge.leftOfTile - 1, tile1);
+            for (int tile = first; tile <= last; ++tile) {
+                ++_tileEdges[tile - tile0];
+            }
+            carryFrom = std::min(carryFrom, area ? bandEdge.firstTile + 1 : bandEdge.leftOfTile);
+        }
+
+        size_t firstEntry = _entryRefs.size();
+        bool carries = false;
+        for (int column = 0; column < columns; ++column) {
+            size_t count = _tileEdges[column];
+            bool carry = tile0 + column >= carryFrom;
+            if (count == 0 && !carry) {
+                _entryRefs.push_back({ c_NoTile, 0 });
+                continue;
+            }
+
+            size_t tile = static_cast<size_t>(band - _tileY0) * _tilesX + (tile0 + column - _tileX0);
+            Entry entry;
+            entry.list = list;
+            entry.edgeCount = static_cast<std::uint32_t>(count);
+            entry.firstEdge = _edgePool.size();
+            entry.carry = -1;
+            entry.cover = area;
+            if (carry) {
+                if (area) {
+                    entry.carry = static_cast<std::int64_t>(_coverPool.size());
+                    _coverPool.resize(_coverPool.size() + carrySize);
+                } else {
+                    entry.carry = static_cast<std::int64_t>(_windingPool.size());
+                    _windingPool.resize(_windingPool.size() + carrySize);
+                }
+                carries = true;
+            }
+            _edgePool.resize(_edgePool.size() + count);
+            _tileEdges[column] = entry.firstEdge;
+            _entryRefs.push_back({ static_cast<std::uint32_t>(tile), static_cast<std::uint32_t>(_bins[tile].size()) });
+            _bins[tile].push_back(entry);
+        }
+
+        // Each tile's edges, in edge table order
+        for (const BandEdge& bandEdge : bandEdges) {
+            int first = std::max(bandEdge.firstTile, tile0);
+            int last = std::min(bandEdge.leftOfTile - 1, tile1);
+            for (int tile = first; tile <= last; ++tile) {
+                _edgePool[_tileEdges[tile - tile0]++] = bandEdge.edge;
+            }
+        }
+
+        if (!carries) {
+            _entryRefs.resize(firstEntry);
+            continue;
+        }
+        CarryJob job;
+        job.edgeList = &edgeList;
+        job.aaMode = aaMode;
+        job.band = band;
+        job.tile0 = tile0;
+        job.tile1 = tile1;
+        job.firstEdge = _bandEdges.size();
+        job.edgeCount = bandEdges.size();
+        job.firstEntry = firstEntry;
+        _bandEdges.insert(_bandEdges.end(), bandEdges.begin(), bandEdges.end());
+        _jobs.push_back(job);
+    }
+}
+
+inline TileBinner::Entry* TileBinner::EntryAt(const CarryJob& job, int column) {
+    const EntryRef& ref = _entryRefs[job.firstEntry + column];
+    if (ref.tile == c_NoTile) return nullptr;
+    Entry& entry = _bins[ref.tile][ref.index];
+    return entry.carry >= 0 ? &entry : nullptr;
+}
+
+inline void TileBinner::ResolveCarries(size_t job) {
+    if (_jobs[job].aaMode == AAMode::AccumulatedArea) {
+        ResolveCover(_jobs[job]);
+    } else {
+        ResolveWinding(_jobs[job]);
+    }
+}
+
+inline int TileBinner::FirstSampleRow(AAMode mode, int rowTop, int sampleRow, float y) const {
+    float offset = ScanlineRasterizer::SampleRowY(mode, 0, sampleRow);
+    int row = static_cast<int>(std::clamp(std::ceil(y - rowTop - offset), 0.0f, static_cast<float>(_tileSize)));
+    while (row > 0 && ScanlineRasterizer::SampleRowY(mode, rowTop + row - 1, sampleRow) >= y) --row;
+    while (row < _tileSize && ScanlineRasterizer::SampleRowY(mode, rowTop + row, sampleRow) < y) ++row;
+    return row;
+}
+
+inline void TileBinner::ResolveWinding(const CarryJob& job) {
+    // An edge first entirely left of a tile column adds its direction from
+    // there on, over the sample rows it crosses: record where those runs
+    // start and stop, then sum them down the rows and across the columns
+    const int size = _tileSize;
+    const int rowTop = job.band * size;
+    const int samples = ScanlineRasterizer::SampleRows(job.aaMode);
+    const int columns = job.tile1 - job.tile0 + 1;
+    const size_t columnSize = static_cast<size_t>(size + 1) * samples;
+    const std::vector<Edge>& edges = job.edgeList->edges;
+
+    std::vector<int> steps(columnSize * columns, 0);
+    for (size_t i = 0; i < job.edgeCount; ++i) {
+        const BandEdge& bandEdge = _bandEdges[job.firstEdge + i];
+        if (bandEdge.leftOfTile > job.tile1) continue;
+        const Edge& edge = edges[bandEdge.edge];
+        int* columnSteps = steps.data() + (std::max(bandEdge.leftOfTile, job.tile0) - job.tile0) * columnSize;
+        for (int s = 0; s < samples; ++s) {
+            int row0 = FirstSampleRow(job.aaMode, rowTop, s, edge.yMin);
+            int row1 = FirstSampleRow(job.aaMode, rowTop, s, edge.yMax);
+            if (row0 >= row1) continue;
+            columnSteps[row0 * samples + s] += edge.direction;
+            columnSteps[row1 * samples + s] -= edge.direction;
+        }
+    }
+
+    std::vector<int> winding(static_cast<size_t>(size) * samples, 0);
+    for (int column = 0; column < columns; ++column) {
+        const int* columnSteps = steps.data() + column * columnSize;
+        for (int s = 0; s < samples; ++s) {
+            int run = 0;
+            for (int row = 0; row < size; ++row) {
+                run += columnSteps[row * samples + s];
+                winding[row * samples + s] += run;
+            }
+        }
+
+        Entry* entry = EntryAt(job, column);
+        if (!entry) continue;
+        if (std::all_of(winding.begin(), winding.end(), [](int w) { return w == 0; })) {
+            entry->carry = -1;
+            continue;
+        }
+        std::copy(winding.begin(), winding.end(), _windingPool.begin() + entry->carry);
+    }
+}
+
+inline void TileBinner::ResolveCover(const CarryJob& job) {
+    // The carry chain of ScanlineRasterizer::AccumulateEdges, over the tile
+    // row: the same pieces, covers and additions, so a tile starts from the
+    // very value the whole list would reach at its first block
+    const int size = _tileSize;
+    const int rowTop = job.band * size;
+    const int blockSize = ScanlineRasterizer::c_AccumulationBlock;
+    const EdgeList& edgeList = *job.edgeList;
+    const int originBlock = edgeList.xMin / blockSize;
+    auto firstBlockOf = [&](int tile) { return std::max(tile * size / blockSize, originBlock); };
+    const int lastBlock = firstBlockOf(job.tile1);
+
+    std::vector<float> cover(static_cast<size_t>(lastBlock - originBlock + 1) * size, 0.0f);
+    for (size_t i = 0; i < job.edgeCount; ++i) {
+        const Edge& edge = edgeList.edges[_bandEdges[job.firstEdge + i].edge];
+        ScanlineRasterizer::ForEachEdgePiece(edgeList, edge, originBlock, lastBlock - 1, true,
+                                             [&](int block, float ya, float yb, float, float) {
+            float* column = cover.data() + static_cast<size_t>(block - originBlock + 1) * size;
+            ScanlineRasterizer::AccumulateCover(ya, yb, edge.direction, rowTop, rowTop + size - 1, column);
+        });
+    }
+
+    for (int row = 0; row < size; ++row) {
+        float carry = cover[row];
+        int block = originBlock;
+        for (int tile = job.tile0; tile <= job.tile1; ++tile) {
+            for (int first = firstBlockOf(tile); block < first; ++block) {
+                carry += cover[static_cast<size_t>(block - originBlock + 1) * size + row];
+            }
+            if (Entry* entry = EntryAt(job, tile - job.tile0)) {
+                _coverPool[entry->carry + row] = carry;
+            }
+        }
+    }
+
+    for (int column = 0; column < job.tile1 - job.tile0 + 1; ++column) {
+        Entry* entry = EntryAt(job, column);
+        if (!entry) continue;
+        auto first = _coverPool.begin() + entry->carry;
+        if (std::all_of(first, first + size, [](float c) { return c == 0.0f; })) {
+            entry->carry = -1;
+        }
+    }
+}
+
+inline void TileBinner::GetTileRect(size_t tile, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = (_tileX0 + static_cast<int>(tile % _tilesX)) * _tileSize;
+    y0 = (_tileY0 + static_cast<int>(tile / _tilesX)) * _tileSize;
+    x1 = std::min(x0 + _tileSize - 1, _x1);
+    y1 = std::min(y0 + _tileSize - 1, _y1);
+    x0 = std::max(x0, _x0);
+    y0 = std::max(y0, _y0);
+}
+
+inline TileEdges TileBinner::GetTileEdges(size_t tile, const Entry& entry) const {
+    TileEdges edges;
+    edges.edges = _edgePool.data() + entry.firstEdge;
+    edges.edgeCount = entry.edgeCount;
+    edges.rowTop = (_tileY0 + static_cast<int>(tile / _tilesX)) * _tileSize;
+    if (entry.carry >= 0) {
+        if (entry.cover) {
+            edges.cover = _coverPool.data() + entry.carry;
+        } else {
+            edges.winding = _windingPool.data() + entry.carry;
+        }
+    }
+    return edges;
+}
+
+inline size_t TileBinner::GetBufferBytes() const {
+    size_t bytes = _edgePool.capacity() * sizeof(std::uint32_t) +
+                   _windingPool.capacity() * sizeof(int) +
+                   _coverPool.capacity() * sizeof(float) +
+                   _jobs.capacity() * sizeof(CarryJob) +
+                   _bandEdges.capacity() * sizeof(BandEdge) +
+                   _entryRefs.capacity() * sizeof(EntryRef);
+    for (const auto& bin : _bins) bytes += bin.capacity() * sizeof(Entry);
+    return bytes;
+}
+
+} // namespace VCX::Labs::SVG
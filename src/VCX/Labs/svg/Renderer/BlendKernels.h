@@ -0,0 +1,293 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SVG_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+    #define SVG_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+// Per-function ISA enabling (GCC/Clang); MSVC accepts intrinsics anywhere
+#if defined(SVG_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define SVG_TARGET_SSE41 __attribute__((target("sse4.1")))
+    #define SVG_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define SVG_TARGET_SSE41
+    #define SVG_TARGET_AVX2
+#endif
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// Span blend kernels on premultiplied RGBA float pixels
+//
+// Every variant evaluates exactly the same per-channel operations (separate
+// multiply and add, no FMA), so all ISAs produce bit-identical results and
+// the scalar versions double as the reference.
+//=============================================================================
+enum class SimdLevel {
+    Scalar,
+    SSE41,
+    AVX2,
+    NEON
+};
+
+struct BlendKernels {
+    // dst = premul (fully opaque runs)
+    void (*fillOpaque)(glm::vec4* dst, int count, const glm::vec4& premul);
+    // dst = premul + dst * invAlpha (constant coverage)
+    void (*blendSolid)(glm::vec4* dst, int count, const glm::vec4& premul, float invAlpha);
+    // a = alpha * mask[i]; dst = src * a + dst * (1 - a), with src.a == 1
+    void (*blendSolidMask)(glm::vec4* dst, const float* mask, int count, const glm::vec4& src, float alpha);
+    // a = colors[i].a * (mask ? mask[i] : coverage); dst = (colors[i].rgb, 1) * a + dst * (1 - a)
+    void (*blendColors)(glm::vec4* dst, const glm::vec4* colors, const float* mask, float coverage, int count);
+};
+
+namespace BlendScalar {
+    inline void FillOpaque(glm::vec4* dst, int count, const glm::vec4& premul) {
+        for (int i = 0; i < count; ++i) dst[i] = premul;
+    }
+
+    inline void BlendSolid(glm::vec4* dst, int count, const glm::vec4& premul, float invAlpha) {
+        for (int i = 0; i < count; ++i) dst[i] = premul + dst[i] * invAlpha;
+    }
+
+    inline void BlendSolidMask(glm::vec4* dst, const float* mask, int count, const glm::vec4& src, float alpha) {
+        for (int i = 0; i < count; ++i) {
+            float a = alpha * mask[i];
+            dst[i] = src * a + dst[i] * (1.0f - a);
+        }
+    }
+
+    inline void BlendColors(glm::vec4* dst, const glm::vec4* colors, const float* mask, float coverage, int count) {
+        for (int i = 0; i < count; ++i) {
+            float a = colors[i].a * (mask ? mask[i] : coverage);
+            glm::vec4 src(colors[i].r, colors[i].g, colors[i].b, 1.0f);
+            dst[i] = src * a + dst[i] * (1.0f - a);
+        }
+    }
+} // namespace BlendScalar
+
+#if defined(SVG_SIMD_X86)
+namespace BlendSSE41 {
+    // One pixel per 128-bit register
+    SVG_TARGET_SSE41 inline void FillOpaque(glm::vec4* dst, int count, const glm::vec4& premul) {
+        __m128 c = _mm_loadu_ps(&premul.x);
+        for (int i = 0; i < count; ++i) _mm_storeu_ps(&dst[i].x, c);
+    }
+
+    SVG_TARGET_SSE41 inline void BlendSolid(glm::vec4* dst, int count, const glm::vec4& premul, float invAlpha) {
+        __m128 c = _mm_loadu_ps(&premul.x);
+        __m128 inv = _mm_set1_ps(invAlpha);
+        for (int i = 0; i < count; ++i) {
+            __m128 d = _mm_loadu_ps(&dst[i].x);
+            _mm_storeu_ps(&dst[i].x, _mm_add_ps(c, _mm_mul_ps(d, inv)));
+        }
+    }
+
+    SVG_TARGET_SSE41 inline void BlendSolidMask(glm::vec4* dst, const float* mask, int count, const glm::vec4& src, float alpha) {
+        __m128 s = _mm_loadu_ps(&src.x);
+        __m128 one = _mm_set1_ps(1.0f);
+        __m128 alphaV = _mm_set1_ps(alpha);
+        for (int i = 0; i < count; ++i) {
+            __m128 a = _mm_mul_ps(alphaV, _mm_set1_ps(mask[i]));
+            __m128 d = _mm_loadu_ps(&dst[i].x);
+            _mm_storeu_ps(&dst[i].x, _mm_add_ps(_mm_mul_ps(s, a), _mm_mul_ps(d, _mm_sub_ps(one, a))));
+        }
+    }
+
+    SVG_TARGET_SSE41 inline void BlendColors(glm::vec4* dst, const glm::vec4* colors, const float* mask, float coverage, int count) {
+        __m128 one = _mm_set1_ps(1.0f);
+        for (int i = 0; i < count; ++i) {
+            __m128 c = _mm_loadu_ps(&colors[i].x);
+            __m128 a = _mm_mul_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3)),
+                                  _mm_set1_ps(mask ? mask[i] : coverage));
+            __m128 s = _mm_blend_ps(c, one, 0x8);   // alpha lane -> 1
+            __m128 d = _mm_loadu_ps(&dst[i].x);
+            _mm_storeu_ps(&dst[i].x, _mm_add_ps(_mm_mul_ps(s, a), _mm_mul_ps(d, _mm_sub_ps(one, a))));
+        }
+    }
+} // namespace BlendSSE41
+
+namespace BlendAVX2 {
+    // Two pixels per 256-bit register, SSE4.1 for the odd tail
+    SVG_TARGET_AVX2 inline void FillOpaque(glm::vec4* dst, int count, const glm::vec4& premul) {
+        __m256 c = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&premul.x));
+        int i = 0;
+        for (; i + 2 <= count; i += 2) _mm256_storeu_ps(&dst[i].x, c);
+        if (i < count) BlendSSE41::FillOpaque(dst + i, count - i, premul);
+    }
+
+    SVG_TARGET_AVX2 inline void BlendSolid(glm::vec4* dst, int count, const glm::vec4& premul, float invAlpha) {
+        __m256 c = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&premul.x));
+        __m256 inv = _mm256_set1_ps(invAlpha);
+        int i = 0;
+        for (; i + 2 <= count; i += 2) {
+            __m256 d = _mm256_loadu_ps(&dst[i].x);
+            _mm256_storeu_ps(&dst[i].x, _mm256_add_ps(c, _mm256_mul_ps(d, inv)));
+        }
+        if (i < count) BlendSSE41::BlendSolid(dst + i, count - i, premul, invAlpha);
+    }
+
+    SVG_TARGET_AVX2 inline void BlendSolidMask(glm::vec4* dst, const float* mask, int count, const glm::vec4& src, float alpha) {
+        __m256 s = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&src.x));
+        __m256 one = _mm256_set1_ps(1.0f);
+        __m256 alphaV = _mm256_set1_ps(alpha);
+        const __m256i spread = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+        int i = 0;
+        for (; i + 2 <= count; i += 2) {
+            __m128 m2 = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask + i)));
+            __m256 m = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(m2), spread);
+            __m256 a = _mm256_mul_ps(alphaV, m);
+            __m256 d = _mm256_loadu_ps(&dst[i].x);
+            _mm256_storeu_ps(&dst[i].x, _mm256_add_ps(_mm256_mul_ps(s, a), _mm256_mul_ps(d, _mm256_sub_ps(one, a))));
+        }
+        if (i < count) BlendSSE41::BlendSolidMask(dst + i, mask + i, count - i, src, alpha);
+    }
+
+    SVG_TARGET_AVX2 inline void BlendColors(glm::vec4* dst, const glm::vec4* colors, const float* mask, float coverage, int count) {
+        __m256 one = _mm256_set1_ps(1.0f);
+        const __m256i spread = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+        __m256 coverageV = _mm256_set1_ps(coverage);
+        int i = 0;
+        for (; i + 2 <= count; i += 2) {
+            __m256 c = _mm256_loadu_ps(&colors[i].x);
+            __m256 m = coverageV;
+            if (mask) {
+                __m128 m2 = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask + i)));
+                m = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(m2), spread);
+            }
+            __m256 a = _mm256_mul_ps(_mm256_permute_ps(c, _MM_SHUFFLE(3, 3, 3, 3)), m);
+            __m256 s = _mm256_blend_ps(c, one, 0x88);   // alpha lanes -> 1
+            __m256 d = _mm256_loadu_ps(&dst[i].x);
+            _mm256_storeu_ps(&dst[i].x, _mm256_add_ps(_mm256_mul_ps(s, a), _mm256_mul_ps(d, _mm256_sub_ps(one, a))));
+        }
+        if (i < count) BlendSSE41::BlendColors(dst + i, colors + i, mask ? mask + i : nullptr, coverage, count - i);
+    }
+} // namespace BlendAVX2
+#endif
+
+#if defined(SVG_SIMD_NEON)
+namespace BlendNEON {
+    inline void FillOpaque(glm::vec4* dst, int count, const glm::vec4& premul) {
+        float32x4_t c = vld1q_f32(&premul.x);
+        for (int i = 0; i < count; ++i) vst1q_f32(&dst[i].x, c);
+    }
+
+    inline void BlendSolid(glm::vec4* dst, int count, const glm::vec4& premul, float invAlpha) {
+        float32x4_t c = vld1q_f32(&premul.x);
+        float32x4_t inv = vdupq_n_f32(invAlpha);
+        for (int i = 0; i < count; ++i) {
+            float32x4_t d = vld1q_f32(&dst[i].x);
+            vst1q_f32(&dst[i].x, vaddq_f32(c, vmulq_f32(d, inv)));
+        }
+    }
+
+    inline void BlendSolidMask(glm::vec4* dst, const float* mask, int count, const glm::vec4& src, float alpha) {
+        float32x4_t s = vld1q_f32(&src.x);
+        float32x4_t one = vdupq_n_f32(1.0f);
+        float32x4_t alphaV = vdupq_n_f32(alpha);
+        for (int i = 0; i < count; ++i) {
+            float32x4_t a = vmulq_f32(alphaV, vdupq_n_f32(mask[i]));
+            float32x4_t d = vld1q_f32(&dst[i].x);
+            vst1q_f32(&dst[i].x, vaddq_f32(vmulq_f32(s, a), vmulq_f32(d, vsubq_f32(one, a))));
+        }
+    }
+
+    inline void BlendColors(glm::vec4* dst, const glm::vec4* colors, const float* mask, float coverage, int count) {
+        float32x4_t one = vdupq_n_f32(1.0f);
+        for (int i = 0; i < count; ++i) {
+            float32x4_t c = vld1q_f32(&colors[i].x);
+            float32x4_t a = vmulq_f32(vdupq_laneq_f32(c, 3), vdupq_n_f32(mask ? mask[i] : coverage));
+            float32x4_t s = vsetq_lane_f32(1.0f, c, 3);
+            float32x4_t d = vld1q_f32(&dst[i].x);
+            vst1q_f32(&dst[i].x, vaddq_f32(vmulq_f32(s, a), vmulq_f32(d, vsubq_f32(one, a))));
+        }
+    }
+} // namespace BlendNEON
+#endif
+
+//=============================================================================
+// Runtime selection
+//=============================================================================
+
+inline SimdLevel DetectSimdLevel() {
+#if defined(SVG_SIMD_NEON)
+    return SimdLevel::NEON;
+#elif defined(SVG_SIMD_X86)
+    bool sse41 = false;
+    bool avx2 = false;
+    #if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    sse41 = (info[2] & (1 << 19)) != 0;
+    bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 0x6) == 0x6);
+    if (maxLeaf >= 7 && osAvx) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    #else
+    __builtin_cpu_init();
+    sse41 = __builtin_cpu_supports("sse4.1");
+    avx2 = __builtin_cpu_supports("avx2");
+    #endif
+    if (avx2) return SimdLevel::AVX2;
+    if (sse41) return SimdLevel::SSE41;
+    return SimdLevel::Scalar;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+inline const char* GetSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE41: return "SSE4.1";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::NEON: return "NEON";
+        default: return "Scalar";
+    }
+}
+
+// Kernels for an explicit level (falls back to scalar if not compiled in)
+inline const BlendKernels& GetBlendKernels(SimdLevel level) {
+    static const BlendKernels scalar = {
+        BlendScalar::FillOpaque, BlendScalar::BlendSolid,
+        BlendScalar::BlendSolidMask, BlendScalar::BlendColors
+    };
+#if defined(SVG_SIMD_X86)
+    static const BlendKernels sse41 = {
+        BlendSSE41::FillOpaque, BlendSSE41::BlendSolid,
+        BlendSSE41::BlendSolidMask, BlendSSE41::BlendColors
+    };
+    static const BlendKernels avx2 = {
+        BlendAVX2::FillOpaque, BlendAVX2::BlendSolid,
+        BlendAVX2::BlendSolidMask, BlendAVX2::BlendColors
+    };
+    if (level == SimdLevel::AVX2) return avx2;
+    if (level == SimdLevel::SSE41) return sse41;
+#endif
+#if defined(SVG_SIMD_NEON)
+    static const BlendKernels neon = {
+        BlendNEON::FillOpaque, BlendNEON::BlendSolid,
+        BlendNEON::BlendSolidMask, BlendNEON::BlendColors
+    };
+    if (level == SimdLevel::NEON) return neon;
+#endif
+    return scalar;
+}
+
+// Best kernels for this CPU (detected once)
+inline const BlendKernels& GetBlendKernels() {
+    static const BlendKernels& kernels = GetBlendKernels(DetectSimdLevel());
+    return kernels;
+}
+
+} // namespace VCX::Labs::SVG
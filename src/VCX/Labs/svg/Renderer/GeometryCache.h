@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Core/Math2D.h"
+#include "Geometry/FlattenedPath.h"
+#include "Geometry/StrokeExpander.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// ElementGeometry - Device-space geometry of one element
+//=============================================================================
+struct ElementGeometry {
+    FlattenedPath fill;                         // Flattened contours (also the stroke centerlines)
+    std::vector<std::vector<Vec2>> strokes;     // Expanded stroke outlines, each filled NonZero
+    BBox bounds;                                // Of all points above, set by UpdateBounds
+
+    void Clear() {
+        fill.Clear();
+        strokes.clear();
+        bounds = BBox();
+    }
+
+    void UpdateBounds() {
+        bounds = BBox();
+        for (const auto& p : fill.points) bounds.Expand(p);
+        for (const auto& outline : strokes) {
+            for (const auto& p : outline) bounds.Expand(p);
+        }
+    }
+
+    void Translate(const Vec2& offset) {
+        fill.Translate(offset);
+        for (auto& outline : strokes) {
+            for (auto& p : outline) p += offset;
+        }
+        if (bounds.IsValid()) {
+            bounds.min += offset;
+            bounds.max += offset;
+        }
+    }
+};
+
+//=============================================================================
+// GeometryCache - Per-element geometry kept across frames
+//
+// Entries are keyed by element uid and are valid while the content version,
+// flatness tolerance, stroke style and the linear part of the device
+// transform stay the same. A change in translation alone is applied by
+// offsetting the cached points. Entries not used in a frame are evicted.
+//=============================================================================
+class GeometryCache {
+public:
+    struct Key {
+        std::uint64_t element = 0;      // SVGElement::uid
+        std::uint32_t version = 0;      // SVGElement::version
+        Matrix3x3 transform;            // Device transform, including SVGElement::contentOffset
+        float tolerance = 0.5f;
+        bool stroked = false;
+        StrokeStyle strokeStyle;        // Only compared when stroked
+    };
+
+    struct Stats {
+        size_t hits = 0;                // Reused as is
+        size_t translated = 0;          // Reused after offsetting
+        size_t misses = 0;              // Rebuilt
+    };
+
+    enum class Result {
+        Hit,            // Geometry valid as is
+        Translated,     // Geometry valid after offsetting
+        Miss            // Entry cleared, caller must rebuild it
+    };
+
+    Result Acquire(const Key& key, ElementGeometry*& geometry);
+
+    void BeginFrame();
+    void EndFrame();    // Evict entries not used since BeginFrame
+    void Clear() { _entries.clear(); }
+    void Erase(std::uint64_t element) { _entries.erase(element); }
+
+    const Stats& GetStats() const { return _stats; }   // Counters of the last frame
+    size_t GetEntryCount() const { return _entries.size(); }
+
+private:
+    struct Entry {
+        Key key;
+        ElementGeometry geometry;
+        std::uint64_t lastFrame = 0;
+    };
+
+    std::unordered_map<std::uint64_t, Entry> _entries;
+    std::uint64_t _frame = 0;
+    Stats _stats;
+
+    static bool SameLinear(const Matrix3x3& a, const Matrix3x3& b);
+    static bool SameStroke(const Key& a, const Key& b);
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline bool GeometryCache::SameLinear(const Matrix3x3& a, const Matrix3x3& b) {
+    return a.m[0][0] == b.m[0][0] && a.m[0][1] == b.m[0][1] &&
+           a.m[1][0] == b.m[1][0] && a.m[1][1] == b.m[1][1];
+}
+
+inline bool GeometryCache::SameStroke(const Key& a, const Key& b) {
+    if (a.stroked != b.stroked) return false;
+    if (!a.stroked) return true;
+    const StrokeStyle& sa = a.strokeStyle;
+    const StrokeStyle& sb = b.strokeStyle;
+    return sa.width == sb.width && sa.lineCap == sb.lineCap && sa.lineJoin == sb.lineJoin &&
+           sa.miterLimit == sb.miterLimit && sa.dashArray == sb.dashArray &&
+           sa.dashOffset == sb.dashOffset;
+}
+
+inline GeometryCache::Result GeometryCache::Acquire(const Key& key, ElementGeometry*& geometry) {
+    Entry& entry = _entries[key.element];
+    geometry = &entry.geometry;
+
+    bool fresh = entry.lastFrame == 0;
+    entry.lastFrame = _frame;
+
+    if (!fresh &&
+        entry.key.version == key.version &&
+        entry.key.tolerance == key.tolerance &&
+        SameLinear(entry.key.transform, key.transform) &&
+        SameStroke(entry.key, key)) {
+        Vec2 offset(key.transform.m[2][0] - entry.key.transform.m[2][0],
+                    key.transform.m[2][1] - entry.key.transform.m[2][1]);
+        if (offset.x != 0 || offset.y != 0) {
+            entry.geometry.Translate(offset);
+            entry.key.transform = key.transform;
+            ++_stats.translated;
+            return Result::Translated;
+        }
+        ++_stats.hits;
+        return Result::Hit;
+    }
+
+    entry.key = key;
+    entry.geometry.Clear();
+    ++_stats.misses;
+    return Result::Miss;
+}
+
+inline void GeometryCache::BeginFrame() {
+    ++_frame;
+    _stats = Stats();
+}
+
+inline void GeometryCache::EndFrame() {
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->second.lastFrame != _frame) {
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Core/Math2D.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// RenderStats - Timings and counters of one SVGRendererV2 frame
+//
+// Stage times are summed over the frame; in tiled mode rasterize and blend
+// are summed over the worker threads and can exceed the frame time. The
+// renderer never sees the source text, so Parse is left to the caller.
+//=============================================================================
+struct RenderStats {
+    using Clock = std::chrono::steady_clock;
+
+    enum class Stage {
+        Parse,
+        Flatten,
+        Stroke,
+        Rasterize,
+        Blend,
+        Count
+    };
+
+    // Complete ("X") event of a Chrome trace
+    struct TraceEvent {
+        const char* name;           // Static string
+        std::uint32_t thread;       // 0 = calling thread, workers from 1
+        double start;               // Microseconds since the frame began
+        double duration;
+    };
+
+    // What one element cost to draw (geometry + rasterize + blend)
+    struct ElementCost {
+        std::uint64_t element = 0;      // SVGElement::uid
+        double ms = 0;
+        std::uint64_t edges = 0;
+        std::uint64_t pixels = 0;
+        BBox bounds;                    // Device-space geometry bounds
+    };
+
+    double stageMs[static_cast<int>(Stage::Count)] = {};
+    double frameMs = 0;                 // Wall time of the render call
+
+    std::uint64_t elements = 0;         // Shapes resolved
+    std::uint64_t elementsCulled = 0;   // Shapes skipped as outside the drawn area
+    std::uint64_t fills = 0;            // Fills submitted (fill + stroke outlines)
+    std::uint64_t edges = 0;            // Edges generated for those fills
+    std::uint64_t pixelsCovered = 0;    // Pixels of all coverage spans
+    std::uint64_t coverageBytes = 0;    // Coverage buffers held by the rasterizers
+
+    bool tracing = false;
+    Clock::time_point origin;
+    std::vector<TraceEvent> events;
+
+    bool perElement = false;
+    std::vector<ElementCost> elementCosts;  // In draw order
+
+    // Start a frame (keeps nothing, not even Parse)
+    void Reset(bool trace, bool elements) {
+        *this = RenderStats();
+        tracing = trace;
+        perElement = elements;
+        origin = Clock::now();
+    }
+
+    // Empty stats sharing this frame's clock and elements, for a worker thread
+    RenderStats Fork() const {
+        RenderStats stats;
+        stats.tracing = tracing;
+        stats.origin = origin;
+        stats.perElement = perElement;
+        stats.elementCosts.reserve(elementCosts.size());
+        for (const auto& cost : elementCosts) {
+            stats.elementCosts.push_back({ cost.element, 0, 0, 0, cost.bounds });
+        }
+        return stats;
+    }
+
+    // Add the stage times, counters, events and element costs of a forked copy
+    void Merge(const RenderStats& other) {
+        for (int i = 0; i < static_cast<int>(Stage::Count); ++i) stageMs[i] += other.stageMs[i];
+        elements += other.elements;
+        elementsCulled += other.elementsCulled;
+        fills += other.fills;
+        edges += other.edges;
+        pixelsCovered += other.pixelsCovered;
+        coverageBytes += other.coverageBytes;
+        events.insert(events.end(), other.events.begin(), other.events.end());
+        if (other.elementCosts.size() == elementCosts.size()) {
+            for (size_t i = 0; i < elementCosts.size(); ++i) {
+                elementCosts[i].ms += other.elementCosts[i].ms;
+                elementCosts[i].edges += other.elementCosts[i].edges;
+                elementCosts[i].pixels += other.elementCosts[i].pixels;
+            }
+        }
+    }
+
+    double& Time(Stage stage) { return stageMs[static_cast<int>(stage)]; }
+    double Time(Stage stage) const { return stageMs[static_cast<int>(stage)]; }
+
+    void Add(Stage stage, Clock::duration duration) {
+        Time(stage) += std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    void AddEvent(const char* name, std::uint32_t thread, Clock::time_point start, Clock::time_point end) {
+        if (!tracing) return;
+        events.push_back({ name, thread,
+                           std::chrono::duration<double, std::micro>(start - origin).count(),
+                           std::chrono::duration<double, std::micro>(end - start).count() });
+    }
+
+    static const char* StageName(Stage stage) {
+        switch (stage) {
+            case Stage::Parse: return "Parse";
+            case Stage::Flatten: return "Flatten";
+            case Stage::Stroke: return "Stroke";
+            case Stage::Rasterize: return "Rasterize";
+            case Stage::Blend: return "Blend";
+            default: return "";
+        }
+    }
+
+    // Chrome trace_event JSON (chrome://tracing, Perfetto): the recorded
+    // events plus one counter sample with the frame totals
+    bool WriteChromeTrace(const std::string& path) const;
+};
+
+//=============================================================================
+// ScopedStageTimer - Adds the scope's duration to a stage (no-op without stats)
+//=============================================================================
+class ScopedStageTimer {
+public:
+    ScopedStageTimer(RenderStats* stats, RenderStats::Stage stage,
+                     const char* event = nullptr, std::uint32_t thread = 0)
+        : _stats(stats), _stage(stage), _event(event), _thread(thread) {
+        if (_stats) _start = RenderStats::Clock::now();
+    }
+
+    ~ScopedStageTimer() {
+        if (!_stats) return;
+        auto end = RenderStats::Clock::now();
+        if (_stage != RenderStats::Stage::Count) _stats->Add(_stage, end - _start);
+        if (_event) _stats->AddEvent(_event, _thread, _start, end);
+    }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    RenderStats* _stats;
+    RenderStats::Stage _stage;      // Count = trace event only
+    const char* _event;
+    std::uint32_t _thread;
+    RenderStats::Clock::time_point _start;
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline bool RenderStats::WriteChromeTrace(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"render\"}}");
+    for (const auto& e : events) {
+        std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"svg\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                     e.name, e.thread, e.start, e.duration);
+    }
+
+    double end = frameMs * 1000.0;
+    std::fprintf(file, ",\n{\"name\":\"stage ms\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":%.3f,\"args\":{", end);
+    for (int i = 0; i < static_cast<int>(Stage::Count); ++i) {
+        std::fprintf(file, "%s\"%s\":%.3f", i ? "," : "", StageName(static_cast<Stage>(i)), stageMs[i]);
+    }
+    std::fprintf(file, "}}");
+    std::fprintf(file, ",\n{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":%.3f,\"args\":{"
+                       "\"elements\":%llu,\"culled\":%llu,\"fills\":%llu,\"edges\":%llu,"
+                       "\"pixels\":%llu,\"coverage bytes\":%llu}}",
+                 end,
+                 static_cast<unsigned long long>(elements), static_cast<unsigned long long>(elementsCulled),
+                 static_cast<unsigned long long>(fills), static_cast<unsigned long long>(edges),
+                 static_cast<unsigned long long>(pixelsCovered), static_cast<unsigned long long>(coverageBytes));
+    std::fprintf(file, "\n]}\n");
+
+    bool ok = std::ferror(file) == 0;
+    return std::fclose(file) == 0 && ok;
+}
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "SVG.h"
+#include "Geometry/StrokeExpander.h"
+#include "Rasterizer/ScanlineRasterizer.h"
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// RenderStyle - Paint of a shape, resolved from its SVGStyle
+//
+// Opacities are multiplied into the colors (alpha 0: not painted), keywords
+// are renderer enums and unset properties hold their SVG defaults, so drawing
+// reads plain fields. Resolved when a style changes (render tree nodes) or
+// is parsed (FlatDocument), not on every frame. The stroke is in user units;
+// its dash array is empty for solid strokes.
+//=============================================================================
+struct RenderStyle {
+    glm::vec4 fillColor = glm::vec4(0);
+    glm::vec4 strokeColor = glm::vec4(0);
+    FillRule fillRule = FillRule::NonZero;
+    StrokeStyle stroke;
+
+    bool IsFilled() const { return fillColor.a > 0; }
+    bool IsStroked() const { return strokeColor.a > 0; }
+
+    static RenderStyle Resolve(const SVGStyle& style);
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline RenderStyle RenderStyle::Resolve(const SVGStyle& style) {
+    RenderStyle resolved;
+
+    // fill="none" paints nothing; an unset fill is black
+    if (!style.fillNone) {
+        resolved.fillColor = style.fillColor.value_or(glm::vec4(0, 0, 0, 1));
+        if (style.fillOpacity) resolved.fillColor.a *= *style.fillOpacity;
+        if (style.opacity) resolved.fillColor.a *= *style.opacity;
+    }
+
+    // An unset stroke paints nothing
+    if (style.strokeColor) {
+        resolved.strokeColor = *style.strokeColor;
+        if (style.strokeOpacity) resolved.strokeColor.a *= *style.strokeOpacity;
+        if (style.opacity) resolved.strokeColor.a *= *style.opacity;
+    }
+
+    if (style.fillRule == SVGFillRule::EvenOdd) resolved.fillRule = FillRule::EvenOdd;
+
+    StrokeStyle& stroke = resolved.stroke;
+    stroke.width = style.strokeWidth.value_or(1.0f);
+    switch (style.strokeLineCap.value_or(SVGLineCap::Butt)) {
+        case SVGLineCap::Round:  stroke.lineCap = LineCap::Round;  break;
+        case SVGLineCap::Square: stroke.lineCap = LineCap::Square; break;
+        default:                 stroke.lineCap = LineCap::Butt;   break;
+    }
+    switch (style.strokeLineJoin.value_or(SVGLineJoin::Miter)) {
+        case SVGLineJoin::Round: stroke.lineJoin = LineJoin::Round; break;
+        case SVGLineJoin::Bevel: stroke.lineJoin = LineJoin::Bevel; break;
+        default:                 stroke.lineJoin = LineJoin::Miter; break;
+    }
+    stroke.miterLimit = style.strokeMiterLimit.value_or(4.0f);
+    if (style.strokeDashArray && !style.strokeDashArray->empty()) {
+        stroke.dashArray = *style.strokeDashArray;
+        stroke.dashOffset = style.strokeDashOffset.value_or(0.0f);
+    }
+    return resolved;
+}
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Labs/Common/ImageRGB.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// PixelRect - Inclusive pixel rectangle
+//=============================================================================
+struct PixelRect {
+    int x0 = 0, y0 = 0;
+    int x1 = -1, y1 = -1;
+
+    bool IsEmpty() const { return x0 > x1 || y0 > y1; }
+    std::int64_t Area() const {
+        return IsEmpty() ? 0 : static_cast<std::int64_t>(x1 - x0 + 1) * (y1 - y0 + 1);
+    }
+
+    bool Intersects(const PixelRect& other) const {
+        return !(other.x1 < x0 || other.x0 > x1 || other.y1 < y0 || other.y0 > y1);
+    }
+
+    PixelRect Intersection(const PixelRect& other) const {
+        return { std::max(x0, other.x0), std::max(y0, other.y0),
+                 std::min(x1, other.x1), std::min(y1, other.y1) };
+    }
+};
+
+//=============================================================================
+// RenderTarget - Premultiplied RGBA float framebuffer
+//
+// All V2 compositing happens here with direct row access; conversion to
+// 8-bit images happens once, after the whole document is drawn.
+//=============================================================================
+class RenderTarget {
+public:
+    RenderTarget() = default;
+    RenderTarget(int width, int height) { Resize(width, height); }
+
+    void Resize(int width, int height) {
+        _width = std::max(0, width);
+        _height = std::max(0, height);
+        _pixels.assign(static_cast<size_t>(_width) * _height, glm::vec4(0));
+    }
+
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
+
+    // Premultiplied pixels of row y (no bounds check)
+    glm::vec4* Row(int y) { return _pixels.data() + static_cast<size_t>(y) * _width; }
+    const glm::vec4* Row(int y) const { return _pixels.data() + static_cast<size_t>(y) * _width; }
+
+    // Fill with a straight-alpha color
+    void Clear(const glm::vec4& color) {
+        std::fill(_pixels.begin(), _pixels.end(), Premultiply(color));
+    }
+
+    // Fill a rectangle (clipped to the target) with a straight-alpha color
+    void Clear(const glm::vec4& color, const PixelRect& rect) {
+        PixelRect r = rect.Intersection(Bounds());
+        if (r.IsEmpty()) return;
+        glm::vec4 value = Premultiply(color);
+        for (int y = r.y0; y <= r.y1; ++y) {
+            std::fill(Row(y) + r.x0, Row(y) + r.x1 + 1, value);
+        }
+    }
+
+    PixelRect Bounds() const { return { 0, 0, _width - 1, _height - 1 }; }
+
+    // Composited RGB (transparent areas come out over black)
+    Common::ImageRGB ToImageRGB() const {
+        Common::ImageRGB image(_width, _height);
+        for (int y = 0; y < _height; ++y) {
+            const glm::vec4* row = Row(y);
+            for (int x = 0; x < _width; ++x) {
+                image.At(x, y) = glm::vec3(row[x]);
+            }
+        }
+        return image;
+    }
+
+    // Update a rectangle of an image of the same size previously made by ToImageRGB
+    void CopyToImageRGB(Common::ImageRGB& image, const PixelRect& rect) const {
+        PixelRect r = rect.Intersection(Bounds());
+        for (int y = r.y0; y <= r.y1; ++y) {
+            const glm::vec4* row = Row(y);
+            for (int x = r.x0; x <= r.x1; ++x) {
+                image.At(x, y) = glm::vec3(row[x]);
+            }
+        }
+    }
+
+    // Straight-alpha RGBA, for transparent exports
+    Common::ImageRGBA ToImageRGBA() const {
+        Common::ImageRGBA image(_width, _height);
+        for (int y = 0; y < _height; ++y) {
+            const glm::vec4* row = Row(y);
+            for (int x = 0; x < _width; ++x) {
+                image.At(x, y) = Unpremultiply(row[x]);
+            }
+        }
+        return image;
+    }
+
+    static glm::vec4 Premultiply(const glm::vec4& c) {
+        return glm::vec4(c.r * c.a, c.g * c.a, c.b * c.a, c.a);
+    }
+
+    static glm::vec4 Unpremultiply(const glm::vec4& c) {
+        if (c.a <= 0) return glm::vec4(0);
+        float inv = 1.0f / c.a;
+        return glm::vec4(c.r * inv, c.g * inv, c.b * inv, c.a);
+    }
+
+private:
+    int _width = 0;
+    int _height = 0;
+    std::vector<glm::vec4> _pixels;
+};
+
+} // namespace VCX::Labs::SVG
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "SVG.h"
+#include "Core/Math2D.h"
+#include "Geometry/StrokeExpander.h"
+#include "Rasterizer/ScanlineRasterizer.h"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace VCX::Labs::SVG {
+
+//=============================================================================
+// RenderNode - One drawable shape of the document, resolved for drawing
+//=============================================================================
+struct RenderNode {
+    const SVGElement* element = nullptr;    // Refreshed on every sync
+    std::uint64_t uid = 0;                  // SVGElement::uid (0 = slot moved away)
+
+    // Stamps the node was resolved from
+    std::uint32_t version = 0;
+    std::uint32_t styleVersion = 0;
+    Point2D contentOffset;
+
+    Matrix3x3 transform;                    // Composed device transform (groups + shape)
+    glm::vec4 fillColor = glm::vec4(0);
+    glm::vec4 strokeColor = glm::vec4(0);
+    FillRule fillRule = FillRule::NonZero;
+    bool stroked = false;
+    StrokeStyle strokeStyle;                // Device units, valid when stroked
+    BBox bounds;                            // Conservative device-space bounds
+
+    std::uint32_t leaf = 0;                 // BVH leaf holding the node
+
+    bool IsCurrent(const SVGElement& source, const Matrix3x3& matrix) const {
+        return version == source.version && styleVersion == source.styleVersion &&
+               contentOffset.x == source.contentOffset.x && contentOffset.y == source.contentOffset.y &&
+               transform.m == matrix.m;
+    }
+};
+
+//=============================================================================
+// RenderTree - Retained, flattened view of a document
+//
+// Nodes are kept in paint order, so a node's index is its z-order. A BVH
+// (median split, a few nodes per leaf) over their bounds answers rectangle
+// and point queries in O(log n + k). The renderer keeps the nodes in sync
+// with the document: a node whose bounds changed is refitted in place (its
+// leaf and ancestors grow or shrink), while added, removed or reordered
+// nodes rebuild the hierarchy.
+//=============================================================================
+class RenderTree {
+public:
+    std::vector<RenderNode>& Nodes() { return _nodes; }
+    const std::vector<RenderNode>& Nodes() const { return _nodes; }
+    size_t Size() const { return _nodes.size(); }
+    bool IsEmpty() const { return _nodes.empty(); }
+
+    // Index of the node of an element, -1 if it has none
+    int Find(std::uint64_t uid) const {
+        auto it = _index.find(uid);
+        return it == _index.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    void Clear() {
+        _nodes.clear();
+        _index.clear();
+        _bvh.clear();
+        _items.clear();
+    }
+
+    // Rebuild the index and the BVH after the node list changed
+    void Build();
+    // Update the BVH after one node's bounds changed
+    void Refit(std::uint32_t node);
+
+    // Nodes whose bounds intersect rect, in paint order
+    void Query(const BBox& rect, std::vector<std::uint32_t>& result) const;
+    // Nodes whose bounds contain point, topmost first
+    void QueryPoint(const Vec2& point, std::vector<std::uint32_t>& result) const;
+
+    // Leaves hold up to this many nodes
+    static constexpr std::uint32_t c_LeafSize = 4;
+
+private:
+    struct BVHNode {
+        BBox bounds;
+        std::int32_t parent = -1;
+        std::int32_t left = -1;         // -1: leaf over _items[first, first + count)
+        std::int32_t right = -1;
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+    };
+
+    std::vector<RenderNode> _nodes;
+    std::unordered_map<std::uint64_t, std::uint32_t> _index;    // uid -> node
+    std::vector<BVHNode> _bvh;          // [0] is the root
+    std::vector<std::uint32_t> _items;  // Node indices, grouped by leaf
+
+    std::int32_t BuildRange(std::uint32_t first, std::uint32_t count, std::int32_t parent);
+    void UpdateLeaf(BVHNode& leaf);
+
+    static void Include(BBox& box, const BBox& other) {
+        if (other.IsValid()) box.Expand(other);
+    }
+    static bool Overlaps(const BBox& a, const BBox& b) {
+        return a.IsValid() && b.IsValid() &&
+               a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y;
+    }
+};
+
+//=============================================================================
+// Implementation
+//=============================================================================
+
+inline void RenderTree::Build() {
+    _index.clear();
+    _index.reserve(_nodes.size());
+    _items.resize(_nodes.size());
+    for (std::uint32_t i = 0; i < _nodes.size(); ++i) {
+        _index[_nodes[i].uid] = i;
+        _items[i] = i;
+    }
+
+    _bvh.clear();
+    if (_nodes.empty()) return;
+    _bvh.reserve(2 * (_nodes.size() / c_LeafSize + 1));
+    BuildRange(0, static_cast<std::uint32_t>(_nodes.size()), -1);
+}
+
+inline std::int32_t RenderTree::BuildRange(std::uint32_t first, std::uint32_t count, std::int32_t parent) {
+    std::int32_t index = static_cast<std::int32_t>(_bvh.size());
+    _bvh.emplace_back();
+    _bvh[index].parent = parent;
+
+    if (count <= c_LeafSize) {
+        _bvh[index].first = first;
+        _bvh[index].count = count;
+        UpdateLeaf(_bvh[index]);
+        for (std::uint32_t i = first; i < first + count; ++i) {
+            _nodes[_items[i]].leaf = static_cast<std::uint32_t>(index);
+        }
+        return index;
+    }
+
+    // Split at the median center along the wider axis of the centers
+    BBox centers;
+    for (std::uint32_t i = first; i < first + count; ++i) {
+        const BBox& b = _nodes[_items[i]].bounds;
+        if (b.IsValid()) centers.Expand((b.min + b.max) * 0.5f);
+    }
+    bool splitX = !centers.IsValid() || centers.Width() >= centers.Height();
+    auto center = [&](std::uint32_t node) {
+        const BBox& b = _nodes[node].bounds;
+        if (!b.IsValid()) return 0.0f;
+        return splitX ? b.min.x + b.max.x : b.min.y + b.max.y;
+    };
+    std::uint32_t half = count / 2;
+    std::nth_element(_items.begin() + first, _items.begin() + first + half, _items.begin() + first + count,
+                     [&](std::uint32_t a, std::uint32_t b) { return center(a) < center(b); });
+
+    std::int32_t left = BuildRange(first, half, index);
+    std::int32_t right = BuildRange(first + half, count - half, index);
+    BVHNode& node = _bvh[index];
+    node.left = left;
+    node.right = right;
+    Include(node.bounds, _bvh[left].bounds);
+    Include(node.bounds, _bvh[right].bounds);
+    return index;
+}
+
+inline void RenderTree::UpdateLeaf(BVHNode& leaf) {
+    leaf.bounds = BBox();
+    for (std::uint32_t i = leaf.first; i < leaf.first + leaf.count; ++i) {
+        Include(leaf.bounds, _nodes[_items[i]].bounds);
+    }
+}
+
+inline void RenderTree::Refit(std::uint32_t node) {
+    if (node >= _nodes.size() || _bvh.empty()) return;
+    std::int32_t index = static_cast<std::int32_t>(_nodes[node].leaf);
+    UpdateLeaf(_bvh[index]);
+    for (index = _bvh[index].parent; index >= 0; index = _bvh[index].parent) {
+        BVHNode& parent = _bvh[index];
+        parent.bounds = BBox();
+        Include(parent.bounds, _bvh[parent.left].bounds);
+        Include(parent.bounds, _bvh[parent.right].bounds);
+    }
+}
+
+inline void RenderTree::Query(const BBox& rect, std::vector<std::uint32_t>& result) const {
+    result.clear();
+    if (_bvh.empty()) return;
+
+    std::int32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const BVHNode& node = _bvh[stack[--top]];
+        if (!Overlaps(node.bounds, rect)) continue;
+        if (node.left < 0) {
+            for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+                if (Overlaps(_nodes[_items[i]].bounds, rect)) result.push_back(_items[i]);
+            }
+        } else {
+            stack[top++] = node.left;
+            stack[top++] = node.right;
+        }
+    }
+    std::sort(result.begin(), result.end());
+}
+
+inline void RenderTree::QueryPoint(const Vec2& point, std::vector<std::uint32_t>& result) const {
+    BBox rect;
+    rect.Expand(point);
+    Query(rect, result);
+    std::reverse(result.begin(), result.end());
+}
+
+} // namespace VCX::Labs::SVG
@@ -1,13 +1,26 @@
 #pragma once
 
 #include "SVG.h"
+#include "Document/FlatDocument.h"
 #include "Core/Math2D.h"
 #include "Core/Bezier.h"
 #include "Geometry/StrokeExpander.h"
+#include "Geometry/PathFlattener.h"
+#include "Geometry/ShapeBounds.h"
+#include "Geometry/ShapeView.h"
 #include "Rasterizer/ScanlineRasterizer.h"
+#include "Rasterizer/TileBinner.h"
 #include "Paint/Gradient.h"
+#include "Core/ThreadPool.h"
+#include "Renderer/RenderTarget.h"
+#include "Renderer/BlendKernels.h"
+#include "Renderer/GeometryCache.h"
+#include "Renderer/RenderStats.h"
+#include "Renderer/RenderStyle.h"
+#include "Renderer/RenderTree.h"
 #include "Labs/Common/ImageRGB.h"
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace VCX::Labs::SVG {
@@ -15,20 +28,47 @@ namespace VCX::Labs::SVG {
 //=============================================================================
 // Render Context - Holds state during rendering
 //=============================================================================
+struct DrawCommand;
+struct PreparedShape;
+
 struct RenderContext {
-    Common::ImageRGB* targetImage = nullptr;
+    RenderTarget* target = nullptr;
     int width = 0;
     int height = 0;
+    PixelRect clip;                  // Pixels that may be written
     TransformStack transformStack;
     float flatnessTolerance = 0.5f;  // Bézier tessellation tolerance
     bool enableAA = true;
+    bool strokes = true;             // false: fill geometry only (stage benchmarks)
     ScanlineRasterizer::AAMode aaMode = ScanlineRasterizer::AAMode::Coverage4x;
+    std::vector<DrawCommand>* commands = nullptr;  // Tiled mode: record fills instead of drawing
+    std::vector<PreparedShape>* shapes = nullptr;  // Incremental mode: collect shapes instead of drawing
+};
+
+//=============================================================================
+// Prepared Shape - Geometry and paint of one element, resolved for drawing
+//=============================================================================
+struct PreparedShape {
+    std::uint64_t element = 0;                  // SVGElement::uid
+    const ElementGeometry* geometry = nullptr;  // Owned by the geometry cache
+    glm::vec4 fillColor = glm::vec4(0);
+    glm::vec4 strokeColor = glm::vec4(0);
+    FillRule fillRule = FillRule::NonZero;
+    bool geometryChanged = true;                // Rebuilt or moved since the last frame
+    std::int32_t cost = -1;                     // Index into RenderStats::elementCosts
 };
 
-// 子路径结构（包含顶点和是否闭合）
-struct SubPathV2 {
-    std::vector<Vec2> points;
-    bool closed = false;
+//=============================================================================
+// Draw Command - One recorded fill (tiled rendering)
+//=============================================================================
+struct DrawCommand {
+    EdgeList geometry;                  // Device-space edges and pixel bounds
+    FillRule fillRule = FillRule::NonZero;
+    ScanlineRasterizer::AAMode aaMode = ScanlineRasterizer::AAMode::Coverage4x;
+    glm::vec4 color = glm::vec4(0);     // Used when paint is None
+    Paint paint;                        // Sampled per pixel otherwise
+    BBox paintBounds;
+    std::int32_t cost = -1;             // Index into RenderStats::elementCosts
 };
 
 //=============================================================================
@@ -44,34 +84,189 @@ public:
                                std::uint32_t width,
                                std::uint32_t height);
 
+    // Same, collecting timings and counters of this call into stats
+    Common::ImageRGB RenderSVG(const SVGDocument& document,
+                               std::uint32_t width,
+                               std::uint32_t height,
+                               RenderStats& stats);
+
+    // Same, keeping alpha (background alpha is honored, e.g. 0 for transparent exports)
+    Common::ImageRGBA RenderSVGRGBA(const SVGDocument& document,
+                                    std::uint32_t width,
+                                    std::uint32_t height);
+
+    // Draw the document over the current contents of a premultiplied target
+    void RenderToTarget(const SVGDocument& document, RenderTarget& target);
+    // Same, writing only the pixels of region (e.g. one tile of a large export)
+    void RenderRegion(const SVGDocument& document, RenderTarget& target, const PixelRect& region);
+
+    // The same for a FlatDocument (load-and-render path). Its shapes are drawn
+    // straight from the tables; the render tree is not used or changed.
+    Common::ImageRGB RenderSVG(const FlatDocument& document, std::uint32_t width, std::uint32_t height);
+    Common::ImageRGBA RenderSVGRGBA(const FlatDocument& document, std::uint32_t width, std::uint32_t height);
+    void RenderToTarget(const FlatDocument& document, RenderTarget& target);
+    void RenderRegion(const FlatDocument& document, RenderTarget& target, const PixelRect& region);
+
+    // Editor path: bring a target kept between calls up to date with the document
+    // over the opaque background, redrawing only the area of elements that were
+    // added, removed, reordered or changed since the previous call. Falls back to
+    // a full redraw when the target or the render settings changed. Returns the
+    // redrawn rectangle (empty if nothing changed).
+    PixelRect RenderIncremental(const SVGDocument& document, RenderTarget& target);
+    void InvalidateIncremental() { _incremental.target = nullptr; }
+
+    // Geometry stage alone, for benchmarks and tools: resolve every shape of the
+    // document for the target's size without drawing. All geometry is rebuilt
+    // (the geometry cache is cleared and then owns it until the next render);
+    // strokes = false skips stroke expansion.
+    void PrepareShapes(const SVGDocument& document, RenderTarget& target, bool strokes,
+                       std::vector<PreparedShape>& shapes);
+
     // Settings
     void SetBackgroundColor(const glm::vec4& color) { _backgroundColor = color; }
     void SetAntiAliasing(bool enabled) { _enableAA = enabled; }
     void SetAAMode(ScanlineRasterizer::AAMode mode) { _aaMode = mode; }
     void SetFlatnessTolerance(float tolerance) { _flatnessTolerance = tolerance; }
+    // 1 = single-threaded, >1 = tiled rendering on that many threads, 0 = one per core
+    void SetThreadCount(unsigned count) { _threadCount = count; }
+    // Blend kernels are picked from the CPU at construction; Scalar is the reference
+    void SetSimdLevel(SimdLevel level) { _blend = &GetBlendKernels(level); }
+    // Keep flattened/stroked geometry of unchanged elements across renders
+    void SetGeometryCacheEnabled(bool enabled) {
+        _useGeometryCache = enabled;
+        if (!enabled) _geometryCache.Clear();
+    }
+    void ClearGeometryCache() { _geometryCache.Clear(); }
+    const GeometryCache& GetGeometryCache() const { return _geometryCache; }
+    // Keep a retained render tree (resolved shapes + BVH) synced with the
+    // document, so that culling, partial redraws and hit-testing only visit
+    // the shapes they touch. Off: walk the document on every render.
+    void SetRenderTreeEnabled(bool enabled) {
+        _useRenderTree = enabled;
+        _renderTree.Clear();
+        InvalidateIncremental();
+    }
+    // Shapes of the last rendered document, in the target's device space
+    const RenderTree& GetRenderTree() const { return _renderTree; }
+    // Per-frame stage timings and counters; trace also records events for a
+    // Chrome trace, perElement the cost of every element. Off by default:
+    // timing every span costs a little when on.
+    void SetStatsEnabled(bool enabled, bool trace = false, bool perElement = false) {
+        _statsEnabled = enabled;
+        _statsTrace = trace;
+        _statsPerElement = perElement;
+    }
+    const RenderStats& GetLastStats() const { return _stats; }
+
+    // Tile edge length of the multithreaded backend
+    static constexpr int c_TileSize = 64;
+    static_assert(c_TileSize % ScanlineRasterizer::c_AccumulationBlock == 0,
+                  "tiles must be aligned to accumulation blocks");
 
 private:
     glm::vec4 _backgroundColor;
     bool _enableAA;
     ScanlineRasterizer::AAMode _aaMode;
     float _flatnessTolerance;
+    unsigned _threadCount;
+    const BlendKernels* _blend;
+    bool _useGeometryCache;
+    bool _statsEnabled = false;
+    bool _statsTrace = false;
+    bool _statsPerElement = false;
+    std::int32_t _currentCost = -1;         // Element cost fills are charged to
+    RenderStats _stats;                     // Last frame
+    RenderStats* _activeStats = nullptr;    // &_stats while a frame is being measured
     
     ScanlineRasterizer _rasterizer;
     StrokeExpander _strokeExpander;
+    PathFlattener _flattener;
+    GeometryCache _geometryCache;
+    ElementGeometry _scratchGeometry;       // Used when the cache is disabled
+    std::vector<Vec2> _contourPoints;       // One contour, for the stroke expander
+    std::unique_ptr<ThreadPool> _threadPool;
+    TileBinner _tileBinner;                 // RenderTiles' bins, kept for their capacity
+
+    // Retained render tree and what changed in it since RenderIncremental last ran
+    bool _useRenderTree = true;
+    RenderTree _renderTree;
+    BBox _treeDamage;
+    bool _treeReordered = false;
+    std::vector<RenderNode> _syncNodes;
+    std::vector<std::uint32_t> _changedNodes;
+    std::vector<std::uint32_t> _visibleNodes;
+
+    // What RenderIncremental drew last time, per element
+    struct DrawnShape {
+        BBox bounds;
+        glm::vec4 fillColor;
+        glm::vec4 strokeColor;
+        FillRule fillRule;
+        std::uint64_t previous;     // Element drawn right before (z-order changes)
+        std::uint64_t frame;
+    };
+    struct IncrementalState {
+        const RenderTarget* target = nullptr;
+        int width = 0;
+        int height = 0;
+        glm::vec4 background = glm::vec4(0);
+        bool enableAA = true;
+        ScanlineRasterizer::AAMode aaMode = ScanlineRasterizer::AAMode::Coverage4x;
+        std::uint64_t frame = 0;
+    };
+    IncrementalState _incremental;
+    std::unordered_map<std::uint64_t, DrawnShape> _drawnShapes;
+    std::vector<PreparedShape> _preparedShapes;
+
+    void SetupContext(const std::string& viewBox, RenderTarget& target, RenderContext& ctx);
+    // Draw with ctx.clip set: inline, or recorded and tiled when multithreaded.
+    // evict: drop cache entries of shapes not drawn (no render tree owns them)
+    template <typename Draw>
+    void RenderPass(RenderContext& ctx, RenderTarget& target, bool evict, Draw&& draw);
+
+    // Measures one render call when stats are enabled; nested calls join the outer frame
+    class StatsFrame {
+    public:
+        explicit StatsFrame(SVGRendererV2& renderer);
+        ~StatsFrame();
+    private:
+        SVGRendererV2& _renderer;
+        bool _owner = false;
+        RenderStats::Clock::time_point _start;
+    };
+    static PixelRect ToPixelRect(const BBox& bounds);
 
     // Element rendering
     void RenderElement(const SVGElement& element, RenderContext& ctx);
-    void RenderPath(const SVGPath& path, RenderContext& ctx);
-    void RenderCircle(const SVGCircle& circle, RenderContext& ctx);
-    void RenderEllipse(const SVGEllipse& ellipse, RenderContext& ctx);
-    void RenderRect(const SVGRect& rect, RenderContext& ctx);
-    void RenderLine(const SVGLine& line, RenderContext& ctx);
-    void RenderText(const SVGText& text, RenderContext& ctx);
+    void RenderShape(const SVGElement& element, const SVGStyle& style,
+                     const Transform2D& transform, RenderContext& ctx);
+    // Geometry of a resolved shape (cached or built under uid/version/offset), then drawn or collected
+    void EmitShape(const ShapeView& view, std::uint64_t uid, std::uint32_t version, const Point2D& contentOffset,
+                   const Matrix3x3& matrix, const StrokeStyle* stroke, PreparedShape& shape, RenderContext& ctx);
+    void DrawShape(const PreparedShape& shape, RenderContext& ctx);
+    static bool GetShapeStyle(const SVGElement& element, const SVGStyle*& style, const Transform2D*& transform);
+
+    // Render tree: bring the nodes up to date with the document (accumulating
+    // _treeDamage), then draw the nodes that overlap ctx.clip
+    void SyncRenderTree(const SVGDocument& document, RenderContext& ctx);
+    void ResolveNode(RenderNode& node, const SVGElement& element, const SVGStyle& style,
+                     const Matrix3x3& matrix);
+    void DrawRenderTree(RenderContext& ctx);
+    // All shapes of a FlatDocument in order, culled against ctx.clip
+    void DrawFlatDocument(const FlatDocument& document, RenderContext& ctx);
+
+    // Device-space geometry of a shape or text marker (strokeStyle = nullptr: fill only)
+    void BuildGeometry(const ShapeView& shape, const Matrix3x3& transform, float tolerance,
+                       const StrokeStyle* strokeStyle, ElementGeometry& geometry);
+
+    // View culling: a shape (EstimateShapeBounds) or group whose conservative
+    // bounds miss ctx.clip is skipped before its geometry is built
+    BBox EstimateGroupBounds(const SVGElement& group, const Matrix3x3& transform, bool strokes);
+    // Stroke of a shape in device units; false if it is not stroked
+    static bool ResolveStroke(SVGElement::Type type, const RenderStyle& paint, const Matrix3x3& transform,
+                              bool strokes, StrokeStyle& strokeStyle);
 
     // Path processing
-    std::vector<Vec2> TessellatePath(const SVGPath& path, const Matrix3x3& transform);
-    std::vector<std::vector<Vec2>> TessellatePathSubPaths(const SVGPath& path, const Matrix3x3& transform);
-    std::vector<SubPathV2> TessellatePathSubPathsEx(const SVGPath& path, const Matrix3x3& transform);
     std::vector<Vec2> GenerateCircleVertices(const Vec2& center, float radius, int segments = 64);
     std::vector<Vec2> GenerateEllipseVertices(const Vec2& center, float rx, float ry, int segments = 64);
     std::vector<Vec2> GenerateRoundedRectVertices(const Vec2& pos, float w, float h, float rx, float ry);
@@ -79,28 +274,27 @@ private:
     // Fill and stroke
     void FillPolygon(const std::vector<Vec2>& polygon, const glm::vec4& color, 
                      FillRule fillRule, RenderContext& ctx);
-    void FillSubPaths(const std::vector<std::vector<Vec2>>& subPaths, const glm::vec4& color,
-                      FillRule fillRule, RenderContext& ctx);
-    void FillSubPathsEx(const std::vector<SubPathV2>& subPaths, const glm::vec4& color,
-                        FillRule fillRule, RenderContext& ctx);
+    void FillFlattened(const FlattenedPath& path, const glm::vec4& color,
+                       FillRule fillRule, RenderContext& ctx);
     void FillPolygonWithPaint(const std::vector<Vec2>& polygon, const Paint& paint,
                               FillRule fillRule, RenderContext& ctx);
-    void StrokePath(const std::vector<Vec2>& vertices, bool closed,
-                    const glm::vec4& color, const StrokeStyle& style, RenderContext& ctx);
-    void StrokeSubPaths(const std::vector<std::vector<Vec2>>& subPaths,
-                        const glm::vec4& color, const StrokeStyle& style, RenderContext& ctx);
-    void StrokeSubPathsEx(const std::vector<SubPathV2>& subPaths,
-                          const glm::vec4& color, const StrokeStyle& style, RenderContext& ctx);
+    void ExpandStroke(const FlattenedPath& path, const StrokeStyle& style,
+                      std::vector<std::vector<Vec2>>& outlines);
 
-    // Pixel operations
-    void BlendPixel(Common::ImageRGB& image, int x, int y, 
-                    const glm::vec4& color, float coverage);
+    // Draw a fill now, or record it when ctx.commands is set
+    void SubmitFill(DrawCommand&& command, RenderContext& ctx);
+    // With tile, only its binned edges are scanned (the clip rect is the tile's)
+    void ExecuteCommand(const DrawCommand& command, ScanlineRasterizer& rasterizer,
+                        RenderTarget& target, int clipX0, int clipY0, int clipX1, int clipY1,
+                        RenderStats* stats, std::uint32_t thread, const TileEdges* tile = nullptr);
+
+    // Tiled backend: bin recorded commands into tiles, draw tiles in parallel
+    void RenderTiles(const std::vector<DrawCommand>& commands, RenderTarget& target,
+                     const PixelRect& region);
 
-    // Color/style extraction
-    glm::vec4 GetFillColor(const SVGStyle& style);
-    glm::vec4 GetStrokeColor(const SVGStyle& style);
-    StrokeStyle GetStrokeStyle(const SVGStyle& style);
-    FillRule GetFillRule(const SVGStyle& style);
+    // Pixel operations
+    void BlendSpan(RenderTarget& target, const CoverageSpan& span,
+                   const glm::vec4& color);
 
     // Transform helpers
     Matrix3x3 ConvertTransform(const Transform2D& t);
@@ -114,7 +308,10 @@ inline SVGRendererV2::SVGRendererV2()
     : _backgroundColor(1, 1, 1, 1)
     , _enableAA(true)
     , _aaMode(ScanlineRasterizer::AAMode::Coverage4x)
-    , _flatnessTolerance(0.5f) {
+    , _flatnessTolerance(0.5f)
+    , _threadCount(1)
+    , _blend(&GetBlendKernels())
+    , _useGeometryCache(true) {
 }
 
 inline SVGRendererV2::~SVGRendererV2() = default;
@@ -122,40 +319,311 @@ inline SVGRendererV2::~SVGRendererV2() = default;
 inline Common::ImageRGB SVGRendererV2::RenderSVG(const SVGDocument& document,
                                                   std::uint32_t width,
                                                   std::uint32_t height) {
-    Common::ImageRGB image(width, height);
+    RenderTarget target(static_cast<int>(width), static_cast<int>(height));
 
-    // Initialize background
-    glm::vec3 bgColor(_backgroundColor.r, _backgroundColor.g, _backgroundColor.b);
-    for (std::uint32_t y = 0; y < height; ++y) {
-        for (std::uint32_t x = 0; x < width; ++x) {
-            image.At(x, y) = bgColor;
-        }
-    }
+    // Initialize background (opaque)
+    target.Clear(glm::vec4(_backgroundColor.r, _backgroundColor.g, _backgroundColor.b, 1.0f));
 
-    // Setup render context
-    RenderContext ctx;
-    ctx.targetImage = &image;
-    ctx.width = static_cast<int>(width);
-    ctx.height = static_cast<int>(height);
+    RenderToTarget(document, target);
+    return target.ToImageRGB();
+}
+
+inline Common::ImageRGB SVGRendererV2::RenderSVG(const SVGDocument& document,
+                                                  std::uint32_t width,
+                                                  std::uint32_t height,
+                                                  RenderStats& stats) {
+    bool enabled = _statsEnabled;
+    _statsEnabled = true;
+    Common::ImageRGB image = RenderSVG(document, width, height);
+    _statsEnabled = enabled;
+    stats = _stats;
+    return image;
+}
+
+inline SVGRendererV2::StatsFrame::StatsFrame(SVGRendererV2& renderer) : _renderer(renderer) {
+    if (!renderer._statsEnabled || renderer._activeStats) return;
+    _owner = true;
+    renderer._stats.Reset(renderer._statsTrace, renderer._statsPerElement);
+    renderer._activeStats = &renderer._stats;
+    _start = RenderStats::Clock::now();
+}
+
+inline SVGRendererV2::StatsFrame::~StatsFrame() {
+    if (!_owner) return;
+    RenderStats& stats = _renderer._stats;
+    auto end = RenderStats::Clock::now();
+    stats.frameMs = std::chrono::duration<double, std::milli>(end - _start).count();
+    stats.coverageBytes += _renderer._rasterizer.GetBufferBytes();
+    stats.AddEvent("Frame", 0, _start, end);
+    _renderer._activeStats = nullptr;
+}
+
+inline Common::ImageRGBA SVGRendererV2::RenderSVGRGBA(const SVGDocument& document,
+                                                      std::uint32_t width,
+                                                      std::uint32_t height) {
+    RenderTarget target(static_cast<int>(width), static_cast<int>(height));
+    target.Clear(_backgroundColor);
+
+    RenderToTarget(document, target);
+    return target.ToImageRGBA();
+}
+
+inline Common::ImageRGB SVGRendererV2::RenderSVG(const FlatDocument& document,
+                                                  std::uint32_t width,
+                                                  std::uint32_t height) {
+    RenderTarget target(static_cast<int>(width), static_cast<int>(height));
+    target.Clear(glm::vec4(_backgroundColor.r, _backgroundColor.g, _backgroundColor.b, 1.0f));
+    RenderToTarget(document, target);
+    return target.ToImageRGB();
+}
+
+inline Common::ImageRGBA SVGRendererV2::RenderSVGRGBA(const FlatDocument& document,
+                                                       std::uint32_t width,
+                                                       std::uint32_t height) {
+    RenderTarget target(static_cast<int>(width), static_cast<int>(height));
+    target.Clear(_backgroundColor);
+    RenderToTarget(document, target);
+    return target.ToImageRGBA();
+}
+
+inline void SVGRendererV2::SetupContext(const std::string& viewBox, RenderTarget& target,
+                                         RenderContext& ctx) {
+    int width = target.GetWidth();
+    int height = target.GetHeight();
+
+    ctx.target = &target;
+    ctx.width = width;
+    ctx.height = height;
+    ctx.clip = target.Bounds();
     ctx.flatnessTolerance = _flatnessTolerance;
     ctx.enableAA = _enableAA;
     ctx.aaMode = _aaMode;
 
     // Apply viewBox transform if present
     float vbX, vbY, vbW, vbH;
-    if (document.ParseViewBox(vbX, vbY, vbW, vbH)) {
+    if (SVGDocument::ParseViewBox(viewBox, vbX, vbY, vbW, vbH)) {
         float scaleX = width / vbW;
         float scaleY = height / vbH;
         ctx.transformStack.Translate(-vbX * scaleX, -vbY * scaleY);
         ctx.transformStack.Scale(scaleX, scaleY);
     }
+}
+
+inline void SVGRendererV2::RenderToTarget(const SVGDocument& document, RenderTarget& target) {
+    RenderRegion(document, target, target.Bounds());
+}
+
+inline void SVGRendererV2::RenderRegion(const SVGDocument& document, RenderTarget& target,
+                                         const PixelRect& region) {
+    StatsFrame frame(*this);
+    RenderContext ctx;
+    SetupContext(document.viewBox, target, ctx);
+    ctx.clip = region.Intersection(target.Bounds());
+    if (ctx.clip.IsEmpty()) return;
+
+    // Without the tree, entries of elements not drawn this frame are evicted;
+    // with it, entries leave with their node
+    _geometryCache.BeginFrame();
+    if (_useRenderTree) SyncRenderTree(document, ctx);
+
+    RenderPass(ctx, target, !_useRenderTree, [&]() {
+        if (_useRenderTree) {
+            DrawRenderTree(ctx);
+            return;
+        }
+        for (const auto& element : document.elements) {
+            RenderElement(element, ctx);
+        }
+    });
+}
+
+inline void SVGRendererV2::RenderToTarget(const FlatDocument& document, RenderTarget& target) {
+    RenderRegion(document, target, target.Bounds());
+}
+
+inline void SVGRendererV2::RenderRegion(const FlatDocument& document, RenderTarget& target,
+                                         const PixelRect& region) {
+    StatsFrame frame(*this);
+    RenderContext ctx;
+    SetupContext(document.viewBox, target, ctx);
+    ctx.clip = region.Intersection(target.Bounds());
+    if (ctx.clip.IsEmpty()) return;
+
+    _geometryCache.BeginFrame();
+    RenderPass(ctx, target, true, [&]() { DrawFlatDocument(document, ctx); });
+}
+
+template <typename Draw>
+inline void SVGRendererV2::RenderPass(RenderContext& ctx, RenderTarget& target, bool evict, Draw&& draw) {
+    if (_threadCount == 1) {
+        draw();
+        if (evict) _geometryCache.EndFrame();
+        return;
+    }
+
+    // Tiled: record every fill in painter's order, then draw tiles in parallel
+    std::vector<DrawCommand> commands;
+    ctx.commands = &commands;
+    {
+        ScopedStageTimer timer(_activeStats, RenderStats::Stage::Count, "Geometry");
+        draw();
+    }
+    ctx.commands = nullptr;
+    if (evict) _geometryCache.EndFrame();
+
+    RenderTiles(commands, target, ctx.clip);
+}
 
-    // Render all elements
+inline void SVGRendererV2::PrepareShapes(const SVGDocument& document, RenderTarget& target,
+                                          bool strokes, std::vector<PreparedShape>& shapes) {
+    RenderContext ctx;
+    SetupContext(document.viewBox, target, ctx);
+    ctx.strokes = strokes;
+    shapes.clear();
+    ctx.shapes = &shapes;
+
+    // Shapes point into the cache, so it is used even when disabled for rendering
+    bool useCache = _useGeometryCache;
+    _useGeometryCache = true;
+    _geometryCache.Clear();
+    _geometryCache.BeginFrame();
     for (const auto& element : document.elements) {
         RenderElement(element, ctx);
     }
+    _geometryCache.EndFrame();
+    _useGeometryCache = useCache;
+}
 
-    return image;
+inline PixelRect SVGRendererV2::ToPixelRect(const BBox& bounds) {
+    if (!bounds.IsValid()) return PixelRect();
+    // One pixel of margin beyond the rasterizer's own floor/ceil bounds
+    return { static_cast<int>(std::floor(bounds.min.x)) - 1, static_cast<int>(std::floor(bounds.min.y)) - 1,
+             static_cast<int>(std::ceil(bounds.max.x)) + 1, static_cast<int>(std::ceil(bounds.max.y)) + 1 };
+}
+
+inline PixelRect SVGRendererV2::RenderIncremental(const SVGDocument& document, RenderTarget& target) {
+    if (target.Bounds().IsEmpty()) return PixelRect();
+    StatsFrame statsFrame(*this);
+
+    glm::vec4 background(_backgroundColor.r, _backgroundColor.g, _backgroundColor.b, 1.0f);
+
+    // Damage tracking needs geometry that outlives the prepare pass (or the tree)
+    if (!_useGeometryCache && !_useRenderTree) {
+        _incremental.target = nullptr;
+        _drawnShapes.clear();
+        target.Clear(background);
+        RenderToTarget(document, target);
+        return target.Bounds();
+    }
+
+    bool fullRedraw = _incremental.target != &target ||
+                      _incremental.width != target.GetWidth() ||
+                      _incremental.height != target.GetHeight() ||
+                      _incremental.background != background ||
+                      _incremental.enableAA != _enableAA ||
+                      _incremental.aaMode != _aaMode;
+    _incremental.target = &target;
+    _incremental.width = target.GetWidth();
+    _incremental.height = target.GetHeight();
+    _incremental.background = background;
+    _incremental.enableAA = _enableAA;
+    _incremental.aaMode = _aaMode;
+    std::uint64_t frame = ++_incremental.frame;
+
+    RenderContext ctx;
+    SetupContext(document.viewBox, target, ctx);
+
+    if (_useRenderTree) {
+        // Damage comes from the tree: old and new bounds of changed, added and
+        // removed nodes since the last call; a reorder redraws everything
+        _geometryCache.BeginFrame();
+        SyncRenderTree(document, ctx);
+        bool full = fullRedraw || _treeReordered;
+        PixelRect region = full ? target.Bounds() : ToPixelRect(_treeDamage).Intersection(target.Bounds());
+        _treeDamage = BBox();
+        _treeReordered = false;
+        if (region.IsEmpty()) return region;
+
+        target.Clear(background, region);
+        ctx.clip = region;
+        if (_threadCount == 1) {
+            DrawRenderTree(ctx);
+            return region;
+        }
+
+        std::vector<DrawCommand> commands;
+        ctx.commands = &commands;
+        DrawRenderTree(ctx);
+        ctx.commands = nullptr;
+        RenderTiles(commands, target, region);
+        return region;
+    }
+
+    // Resolve every shape; geometry of unchanged elements comes from the cache
+    _preparedShapes.clear();
+    ctx.shapes = &_preparedShapes;
+    _geometryCache.BeginFrame();
+    for (const auto& element : document.elements) {
+        RenderElement(element, ctx);
+    }
+    _geometryCache.EndFrame();
+    ctx.shapes = nullptr;
+
+    // Damage: old and new bounds of shapes that changed, appeared or moved in z-order
+    BBox damage;
+    std::uint64_t previous = 0;
+    for (const auto& shape : _preparedShapes) {
+        auto [it, inserted] = _drawnShapes.try_emplace(shape.element);
+        DrawnShape& drawn = it->second;
+        const BBox& bounds = shape.geometry->bounds;
+
+        bool changed = inserted || shape.geometryChanged ||
+                       drawn.fillColor != shape.fillColor ||
+                       drawn.strokeColor != shape.strokeColor ||
+                       drawn.fillRule != shape.fillRule ||
+                       drawn.previous != previous;
+        if (changed) {
+            if (!inserted && drawn.bounds.IsValid()) damage.Expand(drawn.bounds);
+            if (bounds.IsValid()) damage.Expand(bounds);
+        }
+
+        drawn = { bounds, shape.fillColor, shape.strokeColor, shape.fillRule, previous, frame };
+        previous = shape.element;
+    }
+
+    // ... and of shapes that are gone
+    for (auto it = _drawnShapes.begin(); it != _drawnShapes.end();) {
+        if (it->second.frame != frame) {
+            if (it->second.bounds.IsValid()) damage.Expand(it->second.bounds);
+            it = _drawnShapes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    PixelRect region = fullRedraw ? target.Bounds() : ToPixelRect(damage).Intersection(target.Bounds());
+    if (region.IsEmpty()) return region;
+
+    // Redraw the region from the background up, clipped to it
+    target.Clear(background, region);
+    ctx.clip = region;
+
+    if (_threadCount == 1) {
+        for (const auto& shape : _preparedShapes) {
+            DrawShape(shape, ctx);
+        }
+        return region;
+    }
+
+    std::vector<DrawCommand> commands;
+    ctx.commands = &commands;
+    for (const auto& shape : _preparedShapes) {
+        DrawShape(shape, ctx);
+    }
+    ctx.commands = nullptr;
+
+    RenderTiles(commands, target, region);
+    return region;
 }
 
 inline void SVGRendererV2::RenderElement(const SVGElement& element, RenderContext& ctx) {
@@ -164,601 +632,419 @@ inline void SVGRendererV2::RenderElement(const SVGElement& element, RenderContex
 
     switch (element.type) {
         case SVGElement::Type::Path:
-            RenderPath(element.path, ctx);
+            RenderShape(element, element.path.style, element.path.transform, ctx);
             break;
         case SVGElement::Type::Circle:
-            RenderCircle(element.circle, ctx);
+            RenderShape(element, element.circle.style, element.circle.transform, ctx);
             break;
         case SVGElement::Type::Ellipse:
-            RenderEllipse(element.ellipse, ctx);
+            RenderShape(element, element.ellipse.style, element.ellipse.transform, ctx);
             break;
         case SVGElement::Type::Rect:
-            RenderRect(element.rect, ctx);
+            RenderShape(element, element.rect.style, element.rect.transform, ctx);
             break;
         case SVGElement::Type::Line:
-            RenderLine(element.line, ctx);
+            RenderShape(element, element.line.style, element.line.transform, ctx);
             break;
         case SVGElement::Type::Text:
-            RenderText(element.text, ctx);
+            RenderShape(element, element.text.style, element.text.transform, ctx);
             break;
-        case SVGElement::Type::Group:
+        case SVGElement::Type::Group: {
+            BBox bounds = EstimateGroupBounds(element, ctx.transformStack.Current(), ctx.strokes);
+            if (!ToPixelRect(bounds).Intersects(ctx.clip)) {
+                if (_activeStats) ++_activeStats->elementsCulled;
+                break;
+            }
             for (const auto& child : element.children) {
                 RenderElement(child, ctx);
             }
             break;
+        }
     }
 
     ctx.transformStack.Pop();
 }
 
-inline void SVGRendererV2::RenderPath(const SVGPath& path, RenderContext& ctx) {
-    // Apply path's own transform
+inline void SVGRendererV2::RenderShape(const SVGElement& element, const SVGStyle& style,
+                                        const Transform2D& transform, RenderContext& ctx) {
+    // Apply the shape's own transform
     ctx.transformStack.Push();
-    ctx.transformStack.Multiply(ConvertTransform(path.transform));
+    ctx.transformStack.Multiply(ConvertTransform(transform));
+    const Matrix3x3& matrix = ctx.transformStack.Current();
 
-    // Tessellate path into sub-paths with closed info
-    std::vector<SubPathV2> subPaths = TessellatePathSubPathsEx(path, ctx.transformStack.Current());
+    // Walking the document resolves the paint every frame; the render tree
+    // keeps it per node until the style changes
+    RenderStyle paint = RenderStyle::Resolve(style);
+    PreparedShape shape;
+    shape.element = element.uid;
+    shape.fillColor = paint.fillColor;
+    shape.fillRule = element.type == SVGElement::Type::Path ? paint.fillRule : FillRule::NonZero;
 
-    if (subPaths.empty()) {
-        ctx.transformStack.Pop();
-        return;
-    }
+    StrokeStyle strokeStyle;
+    bool stroked = ResolveStroke(element.type, paint, matrix, ctx.strokes, strokeStyle);
+    shape.strokeColor = stroked ? paint.strokeColor : glm::vec4(0);
+    const StrokeStyle* stroke = stroked ? &strokeStyle : nullptr;
 
-    // Get fill color and render fill
-    glm::vec4 fillColor = GetFillColor(path.style);
-    if (fillColor.a > 0) {
-        FillSubPathsEx(subPaths, fillColor, GetFillRule(path.style), ctx);
-    }
+    if (_activeStats) ++_activeStats->elements;
 
-    // Get stroke color and render stroke
-    glm::vec4 strokeColor = GetStrokeColor(path.style);
-    if (strokeColor.a > 0) {
-        StrokeStyle strokeStyle = GetStrokeStyle(path.style);
-        StrokeSubPathsEx(subPaths, strokeColor, strokeStyle, ctx);
+    // Off-canvas (or outside the redrawn region): skip before flattening
+    ShapeView view = ShapeView::Of(element);
+    if (!ToPixelRect(EstimateShapeBounds(view, matrix, stroke)).Intersects(ctx.clip)) {
+        if (_activeStats) ++_activeStats->elementsCulled;
+        ctx.transformStack.Pop();
+        return;
     }
 
+    EmitShape(view, element.uid, element.version, element.contentOffset, matrix, stroke, shape, ctx);
     ctx.transformStack.Pop();
 }
 
-inline void SVGRendererV2::RenderCircle(const SVGCircle& circle, RenderContext& ctx) {
-    ctx.transformStack.Push();
-    ctx.transformStack.Multiply(ConvertTransform(circle.transform));
-
-    Vec2 center(circle.center.x, circle.center.y);
-    center = ctx.transformStack.TransformPoint(center);
-    float scale = ctx.transformStack.Current().GetScaleFactor();
-    float radius = circle.radius * scale;
-
-    std::vector<Vec2> vertices = GenerateCircleVertices(center, radius);
-
-    glm::vec4 fillColor = GetFillColor(circle.style);
-    if (fillColor.a > 0) {
-        FillPolygon(vertices, fillColor, FillRule::NonZero, ctx);
+inline void SVGRendererV2::EmitShape(const ShapeView& view, std::uint64_t uid, std::uint32_t version,
+                                      const Point2D& contentOffset, const Matrix3x3& matrix,
+                                      const StrokeStyle* stroke, PreparedShape& shape, RenderContext& ctx) {
+    RenderStats::Clock::time_point costStart;
+    if (_activeStats && _activeStats->perElement) {
+        shape.cost = static_cast<std::int32_t>(_activeStats->elementCosts.size());
+        RenderStats::ElementCost cost;
+        cost.element = uid;
+        _activeStats->elementCosts.push_back(cost);
+        costStart = RenderStats::Clock::now();
     }
 
-    glm::vec4 strokeColor = GetStrokeColor(circle.style);
-    if (strokeColor.a > 0) {
-        StrokeStyle strokeStyle = GetStrokeStyle(circle.style);
-        strokeStyle.width *= scale;
-        StrokePath(vertices, true, strokeColor, strokeStyle, ctx);
+    ElementGeometry* geometry = &_scratchGeometry;
+    if (_useGeometryCache) {
+        GeometryCache::Key key;
+        key.element = uid;
+        key.version = version;
+        key.transform = matrix * Matrix3x3::Translation(contentOffset.x, contentOffset.y);
+        key.tolerance = ctx.flatnessTolerance;
+        key.stroked = stroke != nullptr;
+        if (stroke) key.strokeStyle = *stroke;
+
+        GeometryCache::Result result = _geometryCache.Acquire(key, geometry);
+        if (result == GeometryCache::Result::Miss) {
+            BuildGeometry(view, matrix, ctx.flatnessTolerance, stroke, *geometry);
+        }
+        shape.geometryChanged = result != GeometryCache::Result::Hit;
+    } else {
+        _scratchGeometry.Clear();
+        BuildGeometry(view, matrix, ctx.flatnessTolerance, stroke, _scratchGeometry);
+    }
+    shape.geometry = geometry;
+    if (shape.cost >= 0) {
+        RenderStats::ElementCost& cost = _activeStats->elementCosts[shape.cost];
+        cost.ms += std::chrono::duration<double, std::milli>(RenderStats::Clock::now() - costStart).count();
+        cost.bounds = geometry->bounds;
     }
 
-    ctx.transformStack.Pop();
-}
-
-inline void SVGRendererV2::RenderEllipse(const SVGEllipse& ellipse, RenderContext& ctx) {
-    ctx.transformStack.Push();
-    ctx.transformStack.Multiply(ConvertTransform(ellipse.transform));
-
-    Vec2 center(ellipse.center.x, ellipse.center.y);
-    center = ctx.transformStack.TransformPoint(center);
-    float scale = ctx.transformStack.Current().GetScaleFactor();
-
-    std::vector<Vec2> vertices = GenerateEllipseVertices(center, 
-                                                          ellipse.rx * scale, 
-                                                          ellipse.ry * scale);
-
-    glm::vec4 fillColor = GetFillColor(ellipse.style);
-    if (fillColor.a > 0) {
-        FillPolygon(vertices, fillColor, FillRule::NonZero, ctx);
+    if (ctx.shapes) {
+        ctx.shapes->push_back(shape);
+    } else {
+        DrawShape(shape, ctx);
     }
+}
 
-    glm::vec4 strokeColor = GetStrokeColor(ellipse.style);
-    if (strokeColor.a > 0) {
-        StrokeStyle strokeStyle = GetStrokeStyle(ellipse.style);
-        strokeStyle.width *= scale;
-        StrokePath(vertices, true, strokeColor, strokeStyle, ctx);
+inline bool SVGRendererV2::GetShapeStyle(const SVGElement& element, const SVGStyle*& style,
+                                          const Transform2D*& transform) {
+    switch (element.type) {
+        case SVGElement::Type::Path:    style = &element.path.style;    transform = &element.path.transform;    return true;
+        case SVGElement::Type::Circle:  style = &element.circle.style;  transform = &element.circle.transform;  return true;
+        case SVGElement::Type::Ellipse: style = &element.ellipse.style; transform = &element.ellipse.transform; return true;
+        case SVGElement::Type::Rect:    style = &element.rect.style;    transform = &element.rect.transform;    return true;
+        case SVGElement::Type::Line:    style = &element.line.style;    transform = &element.line.transform;    return true;
+        case SVGElement::Type::Text:    style = &element.text.style;    transform = &element.text.transform;    return true;
+        default: return false;
     }
+}
 
-    ctx.transformStack.Pop();
+inline void SVGRendererV2::ResolveNode(RenderNode& node, const SVGElement& element, const SVGStyle& style,
+                                        const Matrix3x3& matrix) {
+    node.version = element.version;
+    node.styleVersion = element.styleVersion;
+    node.contentOffset = element.contentOffset;
+    node.transform = matrix;
+    RenderStyle paint = RenderStyle::Resolve(style);
+    node.fillColor = paint.fillColor;
+    node.fillRule = element.type == SVGElement::Type::Path ? paint.fillRule : FillRule::NonZero;
+    node.stroked = ResolveStroke(element.type, paint, matrix, true, node.strokeStyle);
+    node.strokeColor = node.stroked ? paint.strokeColor : glm::vec4(0);
+    node.bounds = EstimateShapeBounds(element, matrix, node.stroked ? &node.strokeStyle : nullptr);
 }
 
-inline void SVGRendererV2::RenderRect(const SVGRect& rect, RenderContext& ctx) {
-    ctx.transformStack.Push();
-    ctx.transformStack.Multiply(ConvertTransform(rect.transform));
+inline void SVGRendererV2::SyncRenderTree(const SVGDocument& document, RenderContext& ctx) {
+    ScopedStageTimer timer(_activeStats, RenderStats::Stage::Count, "Sync");
+    std::vector<RenderNode>& nodes = _renderTree.Nodes();
+    _syncNodes.clear();
+    _syncNodes.reserve(nodes.size());
+    _changedNodes.clear();
+    bool structural = false;
+    std::int64_t lastTaken = -1;
+
+    auto damage = [&](const BBox& bounds) {
+        if (bounds.IsValid()) _treeDamage.Expand(bounds);
+    };
+
+    // Nodes are matched by uid: in place when the order is unchanged, through
+    // the index otherwise. Matched nodes are moved over and resolved again only
+    // when their stamps or composed transform differ.
+    auto visit = [&](auto& self, const SVGElement& element, const Matrix3x3& parent) -> void {
+        Matrix3x3 matrix = parent * ConvertTransform(element.transform);
+        if (element.type == SVGElement::Type::Group) {
+            for (const auto& child : element.children) self(self, child, matrix);
+            return;
+        }
+        const SVGStyle* style;
+        const Transform2D* shapeTransform;
+        if (!GetShapeStyle(element, style, shapeTransform)) return;
+        matrix = matrix * ConvertTransform(*shapeTransform);
+
+        std::uint32_t position = static_cast<std::uint32_t>(_syncNodes.size());
+        int from = position < nodes.size() && nodes[position].uid == element.uid
+                 ? static_cast<int>(position) : _renderTree.Find(element.uid);
+        if (from < 0 || nodes[from].uid != element.uid) {
+            structural = true;
+            RenderNode& node = _syncNodes.emplace_back();
+            node.uid = element.uid;
+            node.element = &element;
+            ResolveNode(node, element, *style, matrix);
+            damage(node.bounds);
+            return;
+        }
 
-    std::vector<Vec2> vertices;
-    
-    if (rect.rx > 0 || rect.ry > 0) {
-        // Rounded rectangle
-        Vec2 pos(rect.position.x, rect.position.y);
-        vertices = GenerateRoundedRectVertices(pos, rect.width, rect.height, rect.rx, rect.ry);
-    } else {
-        // Simple rectangle
-        float x = rect.position.x;
-        float y = rect.position.y;
-        float w = rect.width;
-        float h = rect.height;
-        
-        vertices.push_back(Vec2(x, y));
-        vertices.push_back(Vec2(x + w, y));
-        vertices.push_back(Vec2(x + w, y + h));
-        vertices.push_back(Vec2(x, y + h));
-    }
+        if (static_cast<std::uint32_t>(from) != position) structural = true;
+        if (from < lastTaken) _treeReordered = true;
+        lastTaken = from;
+
+        RenderNode& node = _syncNodes.emplace_back(std::move(nodes[from]));
+        nodes[from].uid = 0;
+        node.element = &element;
+        if (!node.IsCurrent(element, matrix)) {
+            damage(node.bounds);
+            ResolveNode(node, element, *style, matrix);
+            damage(node.bounds);
+            _changedNodes.push_back(position);
+        }
+    };
 
-    // Transform vertices
-    for (auto& v : vertices) {
-        v = ctx.transformStack.TransformPoint(v);
+    Matrix3x3 view = ctx.transformStack.Current();
+    for (const auto& element : document.elements) {
+        visit(visit, element, view);
     }
 
-    glm::vec4 fillColor = GetFillColor(rect.style);
-    if (fillColor.a > 0) {
-        FillPolygon(vertices, fillColor, FillRule::NonZero, ctx);
+    // Whatever was not matched is gone from the document
+    for (const auto& node : nodes) {
+        if (node.uid == 0) continue;
+        structural = true;
+        damage(node.bounds);
+        _geometryCache.Erase(node.uid);
     }
+    nodes.swap(_syncNodes);
 
-    glm::vec4 strokeColor = GetStrokeColor(rect.style);
-    if (strokeColor.a > 0) {
-        StrokeStyle strokeStyle = GetStrokeStyle(rect.style);
-        float scale = ctx.transformStack.Current().GetScaleFactor();
-        strokeStyle.width *= scale;
-        StrokePath(vertices, true, strokeColor, strokeStyle, ctx);
+    if (structural || _changedNodes.size() > nodes.size() / 4) {
+        _renderTree.Build();
+    } else {
+        for (std::uint32_t node : _changedNodes) _renderTree.Refit(node);
     }
-
-    ctx.transformStack.Pop();
 }
 
-inline void SVGRendererV2::RenderLine(const SVGLine& line, RenderContext& ctx) {
-    ctx.transformStack.Push();
-    ctx.transformStack.Multiply(ConvertTransform(line.transform));
-
-    Vec2 start(line.start.x, line.start.y);
-    Vec2 end(line.end.x, line.end.y);
-    
-    start = ctx.transformStack.TransformPoint(start);
-    end = ctx.transformStack.TransformPoint(end);
-
-    std::vector<Vec2> vertices = {start, end};
-
-    glm::vec4 strokeColor = GetStrokeColor(line.style);
-    if (strokeColor.a > 0) {
-        StrokeStyle strokeStyle = GetStrokeStyle(line.style);
-        float scale = ctx.transformStack.Current().GetScaleFactor();
-        strokeStyle.width *= scale;
-        StrokePath(vertices, false, strokeColor, strokeStyle, ctx);
+inline void SVGRendererV2::DrawRenderTree(RenderContext& ctx) {
+    // Same margin as DrawShape's ToPixelRect test, which still runs per shape
+    BBox query;
+    query.Expand(Vec2(static_cast<float>(ctx.clip.x0 - 2), static_cast<float>(ctx.clip.y0 - 2)));
+    query.Expand(Vec2(static_cast<float>(ctx.clip.x1 + 2), static_cast<float>(ctx.clip.y1 + 2)));
+    _renderTree.Query(query, _visibleNodes);
+    if (_activeStats) _activeStats->elementsCulled += _renderTree.Size() - _visibleNodes.size();
+
+    for (std::uint32_t index : _visibleNodes) {
+        const RenderNode& node = _renderTree.Nodes()[index];
+        PreparedShape shape;
+        shape.element = node.uid;
+        shape.fillColor = node.fillColor;
+        shape.strokeColor = node.strokeColor;
+        shape.fillRule = node.fillRule;
+        if (_activeStats) ++_activeStats->elements;
+        const SVGElement& element = *node.element;
+        EmitShape(ShapeView::Of(element), node.uid, element.version, element.contentOffset,
+                  node.transform, node.stroked ? &node.strokeStyle : nullptr, shape, ctx);
     }
-
-    ctx.transformStack.Pop();
 }
 
-inline void SVGRendererV2::RenderText(const SVGText& text, RenderContext& ctx) {
-    // TODO: Implement proper text rendering with FreeType
-    // For now, use basic text rendering from original renderer
-    // This is a placeholder that draws text position as a marker
-    
-    ctx.transformStack.Push();
-    ctx.transformStack.Multiply(ConvertTransform(text.transform));
-
-    Vec2 pos(text.position.x, text.position.y);
-    pos = ctx.transformStack.TransformPoint(pos);
+inline void SVGRendererV2::DrawFlatDocument(const FlatDocument& document, RenderContext& ctx) {
+    const Matrix3x3 view = ctx.transformStack.Current();
+    for (std::uint32_t node = 0; node < document.Size(); ++node) {
+        ShapeView shape = document.Shape(node);
+        const RenderStyle& paint = document.paints[document.nodes.style[node]];
+        // Same composition as RenderElement + RenderShape
+        Matrix3x3 matrix = view * Matrix3x3::FromGlm(document.transforms[document.nodes.transform[node]]);
+        matrix = matrix * Matrix3x3::FromGlm(document.transforms[document.nodes.shapeTransform[node]]);
+
+        PreparedShape prepared;
+        prepared.element = document.Uid(node);
+        prepared.fillColor = paint.fillColor;
+        prepared.fillRule = shape.type == SVGElement::Type::Path ? paint.fillRule : FillRule::NonZero;
+
+        StrokeStyle strokeStyle;
+        bool stroked = ResolveStroke(shape.type, paint, matrix, ctx.strokes, strokeStyle);
+        prepared.strokeColor = stroked ? paint.strokeColor : glm::vec4(0);
+        const StrokeStyle* stroke = stroked ? &strokeStyle : nullptr;
+
+        if (_activeStats) ++_activeStats->elements;
+        if (!ToPixelRect(EstimateShapeBounds(shape, matrix, stroke)).Intersects(ctx.clip)) {
+            if (_activeStats) ++_activeStats->elementsCulled;
+            continue;
+        }
 
-    // Draw a small circle at text position as placeholder
-    glm::vec4 fillColor = GetFillColor(text.style);
-    if (fillColor.a > 0) {
-        std::vector<Vec2> marker = GenerateCircleVertices(pos, 3.0f, 16);
-        FillPolygon(marker, fillColor, FillRule::NonZero, ctx);
+        EmitShape(shape, prepared.element, 0, Point2D(), matrix, stroke, prepared, ctx);
     }
-
-    ctx.transformStack.Pop();
 }
 
-inline std::vector<Vec2> SVGRendererV2::TessellatePath(const SVGPath& path, const Matrix3x3& transform) {
-    std::vector<Vec2> vertices;
-    Vec2 currentPos(0, 0);
-    Vec2 startPos(0, 0);
-    Vec2 lastControlPoint(0, 0);
-
-    for (const auto& cmd : path.commands) {
-        switch (cmd.type) {
-            case PathCommandType::MoveTo: {
-                if (!cmd.points.empty()) {
-                    Vec2 target = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    currentPos = target;
-                    startPos = target;
-                    vertices.push_back(transform.TransformPoint(target));
-                }
-                break;
-            }
-
-            case PathCommandType::LineTo: {
-                if (!cmd.points.empty()) {
-                    Vec2 target = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    currentPos = target;
-                    vertices.push_back(transform.TransformPoint(target));
-                }
-                break;
-            }
-
-            case PathCommandType::CurveTo: {
-                if (cmd.points.size() >= 3) {
-                    Vec2 p0 = currentPos;
-                    Vec2 p1 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    Vec2 p2 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[1].x, cmd.points[1].y)
-                        : Vec2(cmd.points[1].x, cmd.points[1].y);
-                    Vec2 p3 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[2].x, cmd.points[2].y)
-                        : Vec2(cmd.points[2].x, cmd.points[2].y);
-
-                    // Adaptive tessellation
-                    std::vector<Vec2> curvePoints;
-                    Bezier::TessellateCubicAdaptive(p0, p1, p2, p3, _flatnessTolerance, curvePoints);
-                    
-                    for (const auto& p : curvePoints) {
-                        vertices.push_back(transform.TransformPoint(p));
-                    }
-                    
-                    currentPos = p3;
-                    lastControlPoint = p2;
-                }
-                break;
-            }
+inline void SVGRendererV2::DrawShape(const PreparedShape& shape, RenderContext& ctx) {
+    const ElementGeometry& geometry = *shape.geometry;
+    if (!ToPixelRect(geometry.bounds).Intersects(ctx.clip)) {
+        if (_activeStats) ++_activeStats->elementsCulled;
+        return;
+    }
 
-            case PathCommandType::QuadCurveTo: {
-                if (cmd.points.size() >= 2) {
-                    Vec2 p0 = currentPos;
-                    Vec2 p1 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    Vec2 p2 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[1].x, cmd.points[1].y)
-                        : Vec2(cmd.points[1].x, cmd.points[1].y);
-
-                    // Adaptive tessellation
-                    std::vector<Vec2> curvePoints;
-                    Bezier::TessellateQuadraticAdaptive(p0, p1, p2, _flatnessTolerance, curvePoints);
-                    
-                    for (const auto& p : curvePoints) {
-                        vertices.push_back(transform.TransformPoint(p));
-                    }
-                    
-                    currentPos = p2;
-                    lastControlPoint = p1;
-                }
-                break;
-            }
+    // Fills are charged to the shape; drawn inline, their whole cost is timed here
+    bool timed = _activeStats && shape.cost >= 0;
+    RenderStats::Clock::time_point start;
+    if (timed) start = RenderStats::Clock::now();
+    _currentCost = shape.cost;
 
-            case PathCommandType::ArcTo: {
-                if (cmd.points.size() >= 2) {
-                    Vec2 target = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[1].x, cmd.points[1].y)
-                        : Vec2(cmd.points[1].x, cmd.points[1].y);
-                    
-                    // Arc parameters are in points[0]
-                    float rx = std::abs(cmd.points[0].x);
-                    float ry = std::abs(cmd.points[0].y);
-                    
-                    if (rx > 0 && ry > 0) {
-                        // Convert arc to cubic beziers
-                        std::vector<Vec2> arcControls;
-                        // Simplified: assume no rotation, largeArc=false, sweep=true
-                        Bezier::ArcToCubics(currentPos, rx, ry, 0, false, true, target, arcControls);
-                        
-                        // Process cubic segments
-                        Vec2 cp0 = currentPos;
-                        for (size_t i = 0; i + 2 < arcControls.size(); i += 3) {
-                            std::vector<Vec2> curvePoints;
-                            Bezier::TessellateCubicAdaptive(cp0, arcControls[i], arcControls[i+1], 
-                                                            arcControls[i+2], _flatnessTolerance, curvePoints);
-                            for (const auto& p : curvePoints) {
-                                vertices.push_back(transform.TransformPoint(p));
-                            }
-                            cp0 = arcControls[i+2];
-                        }
-                    }
-                    
-                    vertices.push_back(transform.TransformPoint(target));
-                    currentPos = target;
-                }
-                break;
-            }
+    if (shape.fillColor.a > 0) {
+        FillFlattened(geometry.fill, shape.fillColor, shape.fillRule, ctx);
+    }
 
-            case PathCommandType::ClosePath: {
-                currentPos = startPos;
-                if (!vertices.empty() && DistanceSquared(vertices.back(), transform.TransformPoint(startPos)) > 1e-4f) {
-                    vertices.push_back(transform.TransformPoint(startPos));
-                }
-                break;
-            }
+    if (shape.strokeColor.a > 0) {
+        for (const auto& outline : geometry.strokes) {
+            FillPolygon(outline, shape.strokeColor, FillRule::NonZero, ctx);
         }
     }
 
-    return vertices;
+    _currentCost = -1;
+    if (timed) {
+        _activeStats->elementCosts[shape.cost].ms +=
+            std::chrono::duration<double, std::milli>(RenderStats::Clock::now() - start).count();
+    }
 }
 
-inline std::vector<std::vector<Vec2>> SVGRendererV2::TessellatePathSubPaths(const SVGPath& path, const Matrix3x3& transform) {
-    std::vector<std::vector<Vec2>> subPaths;
-    std::vector<Vec2> currentPath;
-    Vec2 currentPos(0, 0);
-    Vec2 startPos(0, 0);
-    Vec2 lastControlPoint(0, 0);
-
-    for (const auto& cmd : path.commands) {
-        switch (cmd.type) {
-            case PathCommandType::MoveTo: {
-                // 新的MoveTo开始一个新的子路径
-                if (!currentPath.empty() && currentPath.size() >= 2) {
-                    subPaths.push_back(std::move(currentPath));
-                    currentPath.clear();
-                }
-                if (!cmd.points.empty()) {
-                    Vec2 target = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    currentPos = target;
-                    startPos = target;
-                    currentPath.push_back(transform.TransformPoint(target));
+inline void SVGRendererV2::BuildGeometry(const ShapeView& shape, const Matrix3x3& transform,
+                                          float tolerance, const StrokeStyle* strokeStyle,
+                                          ElementGeometry& geometry) {
+    float scale = transform.GetScaleFactor();
+    {
+        ScopedStageTimer flattenTimer(_activeStats, RenderStats::Stage::Flatten, "Flatten");
+        switch (shape.type) {
+            case SVGElement::Type::Path:
+                if (shape.path) {
+                    _flattener.Flatten(*shape.path, transform, tolerance, geometry.fill);
+                } else {
+                    _flattener.Flatten(shape.verbs, transform, tolerance, geometry.fill);
                 }
                 break;
-            }
 
-            case PathCommandType::LineTo: {
-                if (!cmd.points.empty()) {
-                    Vec2 target = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    currentPos = target;
-                    currentPath.push_back(transform.TransformPoint(target));
-                }
+            case SVGElement::Type::Circle: {
+                Vec2 center = transform.TransformPoint(Vec2(shape.point.x, shape.point.y));
+                geometry.fill.AddContour(GenerateCircleVertices(center, shape.rx * scale), true);
                 break;
             }
 
-            case PathCommandType::CurveTo: {
-                if (cmd.points.size() >= 3) {
-                    Vec2 p0 = currentPos;
-                    Vec2 p1 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    Vec2 p2 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[1].x, cmd.points[1].y)
-                        : Vec2(cmd.points[1].x, cmd.points[1].y);
-                    Vec2 p3 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[2].x, cmd.points[2].y)
-                        : Vec2(cmd.points[2].x, cmd.points[2].y);
-
-                    std::vector<Vec2> curvePoints;
-                    Bezier::TessellateCubicAdaptive(p0, p1, p2, p3, _flatnessTolerance, curvePoints);
-                    
-                    for (const auto& p : curvePoints) {
-                        currentPath.push_back(transform.TransformPoint(p));
-                    }
-                    
-                    currentPos = p3;
-                    lastControlPoint = p2;
-                }
+            case SVGElement::Type::Ellipse: {
+                Vec2 center = transform.TransformPoint(Vec2(shape.point.x, shape.point.y));
+                geometry.fill.AddContour(GenerateEllipseVertices(center, shape.rx * scale, shape.ry * scale), true);
                 break;
             }
 
-            case PathCommandType::QuadCurveTo: {
-                if (cmd.points.size() >= 2) {
-                    Vec2 p0 = currentPos;
-                    Vec2 p1 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    Vec2 p2 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[1].x, cmd.points[1].y)
-                        : Vec2(cmd.points[1].x, cmd.points[1].y);
-
-                    std::vector<Vec2> curvePoints;
-                    Bezier::TessellateQuadraticAdaptive(p0, p1, p2, _flatnessTolerance, curvePoints);
-                    
-                    for (const auto& p : curvePoints) {
-                        currentPath.push_back(transform.TransformPoint(p));
-                    }
-                    
-                    currentPos = p2;
-                    lastControlPoint = p1;
+            case SVGElement::Type::Rect: {
+                std::vector<Vec2> vertices;
+                if (shape.rx > 0 || shape.ry > 0) {
+                    // Rounded rectangle
+                    Vec2 pos(shape.point.x, shape.point.y);
+                    vertices = GenerateRoundedRectVertices(pos, shape.width, shape.height, shape.rx, shape.ry);
+                } else {
+                    // Simple rectangle
+                    float x = shape.point.x;
+                    float y = shape.point.y;
+                    float w = shape.width;
+                    float h = shape.height;
+
+                    vertices.push_back(Vec2(x, y));
+                    vertices.push_back(Vec2(x + w, y));
+                    vertices.push_back(Vec2(x + w, y + h));
+                    vertices.push_back(Vec2(x, y + h));
+                }
+                for (auto& v : vertices) {
+                    v = transform.TransformPoint(v);
                 }
+                geometry.fill.AddContour(vertices, true);
                 break;
             }
 
-            case PathCommandType::ArcTo: {
-                if (cmd.points.size() >= 2) {
-                    Vec2 target = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[1].x, cmd.points[1].y)
-                        : Vec2(cmd.points[1].x, cmd.points[1].y);
-                    
-                    float rx = std::abs(cmd.points[0].x);
-                    float ry = std::abs(cmd.points[0].y);
-                    
-                    if (rx > 0 && ry > 0) {
-                        std::vector<Vec2> arcControls;
-                        Bezier::ArcToCubics(currentPos, rx, ry, 0, false, true, target, arcControls);
-                        
-                        Vec2 cp0 = currentPos;
-                        for (size_t i = 0; i + 2 < arcControls.size(); i += 3) {
-                            std::vector<Vec2> curvePoints;
-                            Bezier::TessellateCubicAdaptive(cp0, arcControls[i], arcControls[i+1], 
-                                                            arcControls[i+2], _flatnessTolerance, curvePoints);
-                            for (const auto& p : curvePoints) {
-                                currentPath.push_back(transform.TransformPoint(p));
-                            }
-                            cp0 = arcControls[i+2];
-                        }
-                    }
-                    
-                    currentPath.push_back(transform.TransformPoint(target));
-                    currentPos = target;
-                }
+            case SVGElement::Type::Line: {
+                // Open two-point contour: stroked, never filled
+                std::vector<Vec2> vertices = {
+                    transform.TransformPoint(Vec2(shape.point.x, shape.point.y)),
+                    transform.TransformPoint(Vec2(shape.point2.x, shape.point2.y))
+                };
+                geometry.fill.AddContour(vertices, false);
                 break;
             }
 
-            case PathCommandType::ClosePath: {
-                currentPos = startPos;
-                if (!currentPath.empty() && DistanceSquared(currentPath.back(), transform.TransformPoint(startPos)) > 1e-4f) {
-                    currentPath.push_back(transform.TransformPoint(startPos));
-                }
+            case SVGElement::Type::Text: {
+                // TODO: Implement proper text rendering with FreeType
+                // Placeholder: a small circle at the text position
+                Vec2 pos = transform.TransformPoint(Vec2(shape.point.x, shape.point.y));
+                geometry.fill.AddContour(GenerateCircleVertices(pos, 3.0f, 16), true);
                 break;
             }
+
+            default:
+                break;
         }
     }
 
-    // 添加最后一个子路径
-    if (!currentPath.empty() && currentPath.size() >= 2) {
-        subPaths.push_back(std::move(currentPath));
+    if (strokeStyle) {
+        ScopedStageTimer strokeTimer(_activeStats, RenderStats::Stage::Stroke, "Stroke");
+        ExpandStroke(geometry.fill, *strokeStyle, geometry.strokes);
     }
-
-    return subPaths;
+    geometry.UpdateBounds();
 }
 
-inline std::vector<SubPathV2> SVGRendererV2::TessellatePathSubPathsEx(const SVGPath& path, const Matrix3x3& transform) {
-    std::vector<SubPathV2> subPaths;
-    SubPathV2 currentSubPath;
-    Vec2 currentPos(0, 0);
-    Vec2 startPos(0, 0);
-    Vec2 lastControlPoint(0, 0);
-
-    for (const auto& cmd : path.commands) {
-        switch (cmd.type) {
-            case PathCommandType::MoveTo: {
-                if (!currentSubPath.points.empty() && currentSubPath.points.size() >= 2) {
-                    subPaths.push_back(std::move(currentSubPath));
-                    currentSubPath = SubPathV2();
-                }
-                if (!cmd.points.empty()) {
-                    Vec2 target = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    currentPos = target;
-                    startPos = target;
-                    currentSubPath.points.push_back(transform.TransformPoint(target));
-                }
-                break;
-            }
-
-            case PathCommandType::LineTo: {
-                if (!cmd.points.empty()) {
-                    Vec2 target = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    currentPos = target;
-                    currentSubPath.points.push_back(transform.TransformPoint(target));
-                }
-                break;
-            }
-
-            case PathCommandType::CurveTo: {
-                if (cmd.points.size() >= 3) {
-                    Vec2 p0 = currentPos;
-                    Vec2 p1 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    Vec2 p2 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[1].x, cmd.points[1].y)
-                        : Vec2(cmd.points[1].x, cmd.points[1].y);
-                    Vec2 p3 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[2].x, cmd.points[2].y)
-                        : Vec2(cmd.points[2].x, cmd.points[2].y);
-
-                    std::vector<Vec2> curvePoints;
-                    Bezier::TessellateCubicAdaptive(p0, p1, p2, p3, _flatnessTolerance, curvePoints);
-                    
-                    for (const auto& p : curvePoints) {
-                        currentSubPath.points.push_back(transform.TransformPoint(p));
-                    }
-                    
-                    currentPos = p3;
-                    lastControlPoint = p2;
-                }
-                break;
-            }
-
-            case PathCommandType::QuadCurveTo: {
-                if (cmd.points.size() >= 2) {
-                    Vec2 p0 = currentPos;
-                    Vec2 p1 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[0].x, cmd.points[0].y)
-                        : Vec2(cmd.points[0].x, cmd.points[0].y);
-                    Vec2 p2 = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[1].x, cmd.points[1].y)
-                        : Vec2(cmd.points[1].x, cmd.points[1].y);
-
-                    std::vector<Vec2> curvePoints;
-                    Bezier::TessellateQuadraticAdaptive(p0, p1, p2, _flatnessTolerance, curvePoints);
-                    
-                    for (const auto& p : curvePoints) {
-                        currentSubPath.points.push_back(transform.TransformPoint(p));
-                    }
-                    
-                    currentPos = p2;
-                    lastControlPoint = p1;
-                }
-                break;
-            }
+inline bool SVGRendererV2::ResolveStroke(SVGElement::Type type, const RenderStyle& paint,
+                                          const Matrix3x3& transform, bool strokes,
+                                          StrokeStyle& strokeStyle) {
+    // Text is drawn as a filled marker only
+    if (type == SVGElement::Type::Text || !strokes || !paint.IsStroked()) return false;
 
-            case PathCommandType::ArcTo: {
-                if (cmd.points.size() >= 2) {
-                    Vec2 target = cmd.relative 
-                        ? currentPos + Vec2(cmd.points[1].x, cmd.points[1].y)
-                        : Vec2(cmd.points[1].x, cmd.points[1].y);
-                    
-                    float rx = std::abs(cmd.points[0].x);
-                    float ry = std::abs(cmd.points[0].y);
-                    
-                    if (rx > 0 && ry > 0) {
-                        std::vector<Vec2> arcControls;
-                        Bezier::ArcToCubics(currentPos, rx, ry, 0, false, true, target, arcControls);
-                        
-                        Vec2 cp0 = currentPos;
-                        for (size_t i = 0; i + 2 < arcControls.size(); i += 3) {
-                            std::vector<Vec2> curvePoints;
-                            Bezier::TessellateCubicAdaptive(cp0, arcControls[i], arcControls[i+1], 
-                                                            arcControls[i+2], _flatnessTolerance, curvePoints);
-                            for (const auto& p : curvePoints) {
-                                currentSubPath.points.push_back(transform.TransformPoint(p));
-                            }
-                            cp0 = arcControls[i+2];
-                        }
-                    }
-                    
-                    currentSubPath.points.push_back(transform.TransformPoint(target));
-                    currentPos = target;
-                }
-                break;
-            }
+    strokeStyle = paint.stroke;
+    // Path points are transformed but its stroke width is used as is
+    if (type != SVGElement::Type::Path) {
+        strokeStyle.width *= transform.GetScaleFactor();
+    }
+    return true;
+}
 
-            case PathCommandType::ClosePath: {
-                currentPos = startPos;
-                currentSubPath.closed = true;
-                if (!currentSubPath.points.empty() && DistanceSquared(currentSubPath.points.back(), transform.TransformPoint(startPos)) > 1e-4f) {
-                    currentSubPath.points.push_back(transform.TransformPoint(startPos));
-                }
-                break;
-            }
+inline BBox SVGRendererV2::EstimateGroupBounds(const SVGElement& group, const Matrix3x3& transform,
+                                                bool strokes) {
+    BBox bounds;
+    for (const auto& child : group.children) {
+        Matrix3x3 matrix = transform * ConvertTransform(child.transform);
+        if (child.type == SVGElement::Type::Group) {
+            bounds.Expand(EstimateGroupBounds(child, matrix, strokes));
+            continue;
         }
-    }
 
-    // 添加最后一个子路径
-    if (!currentSubPath.points.empty() && currentSubPath.points.size() >= 2) {
-        subPaths.push_back(std::move(currentSubPath));
-    }
+        const SVGStyle* style;
+        const Transform2D* shapeTransform;
+        if (!GetShapeStyle(child, style, shapeTransform)) continue;
+        matrix = matrix * ConvertTransform(*shapeTransform);
 
-    return subPaths;
+        StrokeStyle strokeStyle;
+        bool stroked = ResolveStroke(child.type, RenderStyle::Resolve(*style), matrix, strokes, strokeStyle);
+        BBox childBounds = EstimateShapeBounds(child, matrix, stroked ? &strokeStyle : nullptr);
+        if (childBounds.IsValid()) bounds.Expand(childBounds);
+    }
+    return bounds;
 }
 
 inline std::vector<Vec2> SVGRendererV2::GenerateCircleVertices(const Vec2& center, float radius, int segments) {
@@ -841,77 +1127,25 @@ inline void SVGRendererV2::FillPolygon(const std::vector<Vec2>& polygon,
                                         RenderContext& ctx) {
     if (polygon.size() < 3 || color.a <= 0) return;
 
-    _rasterizer.SetFillRule(fillRule);
-    _rasterizer.SetAAMode(ctx.enableAA ? ctx.aaMode : ScanlineRasterizer::AAMode::None);
-
-    std::vector<float> coverage;
-    _rasterizer.Rasterize(polygon, ctx.width, ctx.height, coverage);
-
-    // Apply coverage to pixels
-    for (int y = 0; y < ctx.height; ++y) {
-        for (int x = 0; x < ctx.width; ++x) {
-            float cov = coverage[y * ctx.width + x];
-            if (cov > 0) {
-                BlendPixel(*ctx.targetImage, x, y, color, cov);
-            }
-        }
-    }
-}
-
-inline void SVGRendererV2::FillSubPaths(const std::vector<std::vector<Vec2>>& subPaths,
-                                         const glm::vec4& color,
-                                         FillRule fillRule,
-                                         RenderContext& ctx) {
-    if (subPaths.empty() || color.a <= 0) return;
-
-    _rasterizer.SetFillRule(fillRule);
-    _rasterizer.SetAAMode(ctx.enableAA ? ctx.aaMode : ScanlineRasterizer::AAMode::None);
-
-    std::vector<float> coverage;
-    _rasterizer.RasterizeSubPaths(subPaths, ctx.width, ctx.height, coverage);
-
-    // Apply coverage to pixels
-    for (int y = 0; y < ctx.height; ++y) {
-        for (int x = 0; x < ctx.width; ++x) {
-            float cov = coverage[y * ctx.width + x];
-            if (cov > 0) {
-                BlendPixel(*ctx.targetImage, x, y, color, cov);
-            }
-        }
-    }
+    DrawCommand command;
+    command.geometry = _rasterizer.PrepareEdges(polygon, ctx.width, ctx.height);
+    command.fillRule = fillRule;
+    command.color = color;
+    SubmitFill(std::move(command), ctx);
 }
 
-inline void SVGRendererV2::FillSubPathsEx(const std::vector<SubPathV2>& subPaths,
-                                           const glm::vec4& color,
-                                           FillRule fillRule,
-                                           RenderContext& ctx) {
-    if (subPaths.empty() || color.a <= 0) return;
-
-    // 对于填充，closed 属性不影响结果，只需要提取所有顶点
-    std::vector<std::vector<Vec2>> allSubPaths;
-    for (const auto& sp : subPaths) {
-        if (sp.points.size() >= 3) {
-            allSubPaths.push_back(sp.points);
-        }
-    }
-    
-    if (allSubPaths.empty()) return;
-
-    _rasterizer.SetFillRule(fillRule);
-    _rasterizer.SetAAMode(ctx.enableAA ? ctx.aaMode : ScanlineRasterizer::AAMode::None);
-
-    std::vector<float> coverage;
-    _rasterizer.RasterizeSubPaths(allSubPaths, ctx.width, ctx.height, coverage);
-
-    // Apply coverage to pixels
-    for (int y = 0; y < ctx.height; ++y) {
-        for (int x = 0; x < ctx.width; ++x) {
-            float cov = coverage[y * ctx.width + x];
-            if (cov > 0) {
-                BlendPixel(*ctx.targetImage, x, y, color, cov);
-            }
-        }
-    }
+inline void SVGRendererV2::FillFlattened(const FlattenedPath& path,
+                                          const glm::vec4& color,
+                                          FillRule fillRule,
+                                          RenderContext& ctx) {
+    // 对于填充，closed 属性不影响结果，所有轮廓都按闭合处理
+    if (path.IsEmpty() || color.a <= 0) return;
+
+    DrawCommand command;
+    command.geometry = _rasterizer.PrepareEdges(path, ctx.width, ctx.height);
+    command.fillRule = fillRule;
+    command.color = color;
+    SubmitFill(std::move(command), ctx);
 }
 
 inline void SVGRendererV2::FillPolygonWithPaint(const std::vector<Vec2>& polygon,
@@ -920,212 +1154,209 @@ inline void SVGRendererV2::FillPolygonWithPaint(const std::vector<Vec2>& polygon
                                                  RenderContext& ctx) {
     if (polygon.size() < 3 || paint.IsNone()) return;
 
-    _rasterizer.SetFillRule(fillRule);
-    _rasterizer.SetAAMode(ctx.enableAA ? ctx.aaMode : ScanlineRasterizer::AAMode::None);
-
-    std::vector<float> coverage;
-    _rasterizer.Rasterize(polygon, ctx.width, ctx.height, coverage);
-
-    BBox bounds = Geometry::ComputeBBox(polygon);
+    DrawCommand command;
+    command.geometry = _rasterizer.PrepareEdges(polygon, ctx.width, ctx.height);
+    command.fillRule = fillRule;
+    command.paint = paint;
+    command.paintBounds = Geometry::ComputeBBox(polygon);
+    SubmitFill(std::move(command), ctx);
+}
 
-    // Apply coverage with paint sampling
-    for (int y = 0; y < ctx.height; ++y) {
-        for (int x = 0; x < ctx.width; ++x) {
-            float cov = coverage[y * ctx.width + x];
-            if (cov > 0) {
-                Vec2 samplePoint(x + 0.5f, y + 0.5f);
-                glm::vec4 color = paint.Sample(samplePoint, bounds);
-                BlendPixel(*ctx.targetImage, x, y, color, cov);
-            }
+inline void SVGRendererV2::SubmitFill(DrawCommand&& command, RenderContext& ctx) {
+    if (command.geometry.IsEmpty()) return;
+    if (_activeStats) {
+        ++_activeStats->fills;
+        _activeStats->edges += command.geometry.edges.size();
+        if (_currentCost >= 0) {
+            _activeStats->elementCosts[_currentCost].edges += command.geometry.edges.size();
         }
     }
+    command.cost = _currentCost;
+
+    command.aaMode = ctx.enableAA ? ctx.aaMode : ScanlineRasterizer::AAMode::None;
+    if (ctx.commands) {
+        ctx.commands->push_back(std::move(command));
+        return;
+    }
+    ExecuteCommand(command, _rasterizer, *ctx.target, ctx.clip.x0, ctx.clip.y0, ctx.clip.x1, ctx.clip.y1,
+                   _activeStats, 0);
 }
 
-inline void SVGRendererV2::StrokePath(const std::vector<Vec2>& vertices, bool closed,
-                                       const glm::vec4& color, const StrokeStyle& style,
-                                       RenderContext& ctx) {
-    if (vertices.size() < 2 || color.a <= 0 || style.width < 0.1f) return;
+inline void SVGRendererV2::ExecuteCommand(const DrawCommand& command, ScanlineRasterizer& rasterizer,
+                                           RenderTarget& target,
+                                           int clipX0, int clipY0, int clipX1, int clipY1,
+                                           RenderStats* stats, std::uint32_t thread, const TileEdges* tile) {
+    rasterizer.SetFillRule(command.fillRule);
+    rasterizer.SetAAMode(command.aaMode);
 
-    _strokeExpander.SetStyle(style);
-    
-    // Check if we have a dash pattern
-    if (!style.dashArray.empty()) {
-        // Apply dash pattern to get multiple dash segments
-        std::vector<std::vector<Vec2>> dashSegments = _strokeExpander.ApplyDashPattern(vertices, closed);
-        
-        // Render each dash segment (dashes are always open paths)
-        for (const auto& segment : dashSegments) {
-            if (segment.size() >= 2) {
-                std::vector<Vec2> strokePolygon = _strokeExpander.ExpandPolyline(segment, false);
-                if (strokePolygon.size() >= 3) {
-                    FillPolygon(strokePolygon, color, FillRule::NonZero, ctx);
-                }
-            }
+    auto scan = [&](const SpanSink& sink) {
+        if (tile) {
+            rasterizer.RasterizeTile(command.geometry, *tile, clipX0, clipY0, clipX1, clipY1, sink);
+        } else {
+            rasterizer.RasterizeClipped(command.geometry, clipX0, clipY0, clipX1, clipY1, sink);
         }
-    } else {
-        // No dash pattern - render solid stroke
-        std::vector<Vec2> strokePolygon = _strokeExpander.ExpandPolyline(vertices, closed);
+    };
 
-        if (strokePolygon.size() >= 3) {
-            FillPolygon(strokePolygon, color, FillRule::NonZero, ctx);
+    // With stats, each span's blend is timed and the rest of the scan counts as rasterize
+    auto rasterize = [&](auto&& blend) {
+        if (!stats) {
+            scan(blend);
+            return;
         }
-    }
-}
+        RenderStats::Clock::duration blendTime{};
+        std::uint64_t pixels = 0;
+        auto start = RenderStats::Clock::now();
+        scan([&](const CoverageSpan& span) {
+            auto spanStart = RenderStats::Clock::now();
+            blend(span);
+            blendTime += RenderStats::Clock::now() - spanStart;
+            pixels += span.x1 - span.x0 + 1;
+        });
+        auto end = RenderStats::Clock::now();
+        stats->Add(RenderStats::Stage::Rasterize, end - start - blendTime);
+        stats->Add(RenderStats::Stage::Blend, blendTime);
+        stats->pixelsCovered += pixels;
+        stats->AddEvent("Fill", thread, start, end);
+        if (command.cost >= 0 && command.cost < static_cast<std::int32_t>(stats->elementCosts.size())) {
+            RenderStats::ElementCost& cost = stats->elementCosts[command.cost];
+            cost.pixels += pixels;
+            // Inline fills are already inside DrawShape's time; tile workers add theirs
+            if (stats != _activeStats) {
+                cost.ms += std::chrono::duration<double, std::milli>(end - start).count();
+            }
+        }
+    };
 
-inline void SVGRendererV2::StrokeSubPaths(const std::vector<std::vector<Vec2>>& subPaths,
-                                           const glm::vec4& color, const StrokeStyle& style,
-                                           RenderContext& ctx) {
-    if (subPaths.empty() || color.a <= 0 || style.width < 0.1f) return;
+    if (command.paint.IsNone()) {
+        // Blend coverage spans directly, only covered pixels are touched
+        rasterize([&](const CoverageSpan& span) {
+            BlendSpan(target, span, command.color);
+        });
+        return;
+    }
 
-    _strokeExpander.SetStyle(style);
+    // Apply coverage spans with paint sampling, in chunks of sampled colors
+    rasterize([&](const CoverageSpan& span) {
+        const int chunkSize = 64;
+        glm::vec4 colors[chunkSize];
+        glm::vec4* row = target.Row(span.y);
+        for (int x0 = span.x0; x0 <= span.x1; x0 += chunkSize) {
+            int count = std::min(chunkSize, span.x1 - x0 + 1);
+            for (int i = 0; i < count; ++i) {
+                Vec2 samplePoint(x0 + i + 0.5f, span.y + 0.5f);
+                colors[i] = command.paint.Sample(samplePoint, command.paintBounds);
+            }
+            const float* mask = span.coverage ? span.coverage + (x0 - span.x0) : nullptr;
+            _blend->blendColors(row + x0, colors, mask, span.alpha, count);
+        }
+    });
+}
 
-    for (const auto& vertices : subPaths) {
-        if (vertices.size() < 2) continue;
-        
-        // Check if this sub-path is closed (first and last point are close)
-        bool closed = vertices.size() >= 3 && 
-                      DistanceSquared(vertices.front(), vertices.back()) < 1e-4f;
+inline void SVGRendererV2::RenderTiles(const std::vector<DrawCommand>& commands,
+                                        RenderTarget& target, const PixelRect& region) {
+    PixelRect clip = region.Intersection(target.Bounds());
+    if (commands.empty() || clip.IsEmpty()) return;
+
+    // Tiles stay aligned to the canvas grid; only those over the region are
+    // used. Each command's edges are binned per tile row and tile, in
+    // painter's order: a tile then scans only the edges near it, starting
+    // from the winding of those left of it.
+    _tileBinner.Reset(c_TileSize, clip.x0, clip.y0, clip.x1, clip.y1);
+    for (std::uint32_t i = 0; i < commands.size(); ++i) {
+        _tileBinner.Add(commands[i].geometry, commands[i].aaMode, i);
+    }
 
-        std::vector<Vec2> strokePolygon = _strokeExpander.ExpandPolyline(vertices, closed);
+    if (!_threadPool || (_threadCount != 0 && _threadPool->GetThreadCount() != _threadCount)) {
+        _threadPool = std::make_unique<ThreadPool>(_threadCount);
+    }
+    _threadPool->ParallelFor(_tileBinner.GetCarryJobCount(), [&](size_t job, unsigned) {
+        _tileBinner.ResolveCarries(job);
+    });
+
+    // Tiles own disjoint pixels, so workers never touch the same pixel.
+    // Coverage is clip-independent and the carries stand in exactly for the
+    // edges left out, hence identical to the single-threaded path.
+    std::vector<ScanlineRasterizer> rasterizers(_threadPool->GetThreadCount());
+    std::vector<RenderStats> workerStats;
+    if (_activeStats) workerStats.assign(rasterizers.size(), _activeStats->Fork());
+    _threadPool->ParallelFor(_tileBinner.GetTileCount(), [&](size_t tile, unsigned worker) {
+        const std::vector<TileBinner::Entry>& entries = _tileBinner.GetEntries(tile);
+        if (entries.empty()) return;
+        RenderStats* stats = _activeStats ? &workerStats[worker] : nullptr;
+        ScopedStageTimer tileTimer(stats, RenderStats::Stage::Count, "Tile", worker + 1);
+        int x0, y0, x1, y1;
+        _tileBinner.GetTileRect(tile, x0, y0, x1, y1);
+        for (const TileBinner::Entry& entry : entries) {
+            TileEdges edges = _tileBinner.GetTileEdges(tile, entry);
+            if (edges.IsEmpty()) continue;
+            ExecuteCommand(commands[entry.list], rasterizers[worker], target, x0, y0, x1, y1,
+                           stats, worker + 1, &edges);
+        }
+    });
 
-        if (strokePolygon.size() >= 3) {
-            FillPolygon(strokePolygon, color, FillRule::NonZero, ctx);
+    if (_activeStats) {
+        for (size_t i = 0; i < workerStats.size(); ++i) {
+            workerStats[i].coverageBytes = rasterizers[i].GetBufferBytes();
+            _activeStats->Merge(workerStats[i]);
         }
+        _activeStats->coverageBytes += _tileBinner.GetBufferBytes();
     }
 }
 
-inline void SVGRendererV2::StrokeSubPathsEx(const std::vector<SubPathV2>& subPaths,
-                                             const glm::vec4& color, const StrokeStyle& style,
-                                             RenderContext& ctx) {
-    if (subPaths.empty() || color.a <= 0 || style.width < 0.1f) return;
+inline void SVGRendererV2::ExpandStroke(const FlattenedPath& path, const StrokeStyle& style,
+                                         std::vector<std::vector<Vec2>>& outlines) {
+    if (path.IsEmpty() || style.width < 0.1f) return;
 
     _strokeExpander.SetStyle(style);
 
-    for (const auto& subPath : subPaths) {
-        if (subPath.points.size() < 2) continue;
-        
+    for (const auto& contour : path.contours) {
         // 使用明确的 closed 属性，而不是猜测
-        bool closed = subPath.closed;
+        const Vec2* points = path.ContourPoints(contour);
+        _contourPoints.assign(points, points + contour.count);
 
         // Check if we have a dash pattern
         if (!style.dashArray.empty()) {
             // Apply dash pattern to get multiple dash segments
-            std::vector<std::vector<Vec2>> dashSegments = _strokeExpander.ApplyDashPattern(subPath.points, closed);
-            
-            // Render each dash segment (dashes are always open paths)
+            std::vector<std::vector<Vec2>> dashSegments = _strokeExpander.ApplyDashPattern(_contourPoints, contour.closed);
+
+            // Expand each dash segment (dashes are always open paths)
             for (const auto& segment : dashSegments) {
                 if (segment.size() >= 2) {
                     std::vector<Vec2> strokePolygon = _strokeExpander.ExpandPolyline(segment, false);
                     if (strokePolygon.size() >= 3) {
-                        FillPolygon(strokePolygon, color, FillRule::NonZero, ctx);
+                        outlines.push_back(std::move(strokePolygon));
                     }
                 }
             }
         } else {
-            // No dash pattern - render solid stroke
-            std::vector<Vec2> strokePolygon = _strokeExpander.ExpandPolyline(subPath.points, closed);
-
+            // No dash pattern - solid stroke
+            std::vector<Vec2> strokePolygon = _strokeExpander.ExpandPolyline(_contourPoints, contour.closed);
             if (strokePolygon.size() >= 3) {
-                FillPolygon(strokePolygon, color, FillRule::NonZero, ctx);
+                outlines.push_back(std::move(strokePolygon));
             }
         }
     }
 }
 
-inline void SVGRendererV2::BlendPixel(Common::ImageRGB& image, int x, int y,
-                                       const glm::vec4& color, float coverage) {
-    auto [width, height] = image.GetSize();
-    
-    if (x < 0 || x >= static_cast<int>(width) || y < 0 || y >= static_cast<int>(height)) {
+inline void SVGRendererV2::BlendSpan(RenderTarget& target, const CoverageSpan& span,
+                                      const glm::vec4& color) {
+    // Spans are already clipped to the target
+    glm::vec4* row = target.Row(span.y) + span.x0;
+    int count = span.x1 - span.x0 + 1;
+    glm::vec4 src(color.r, color.g, color.b, 1.0f);
+
+    if (span.coverage) {
+        _blend->blendSolidMask(row, span.coverage, count, src, color.a);
         return;
     }
 
-    float alpha = color.a * coverage;
+    float alpha = color.a * span.alpha;
     if (alpha <= 0) return;
-
-    glm::vec3 existing = image.At(x, y);
-    float invAlpha = 1.0f - alpha;
-
-    glm::vec3 blended(
-        existing.r * invAlpha + color.r * alpha,
-        existing.g * invAlpha + color.g * alpha,
-        existing.b * invAlpha + color.b * alpha
-    );
-
-    image.At(x, y) = blended;
-}
-
-inline glm::vec4 SVGRendererV2::GetFillColor(const SVGStyle& style) {
-    // 根据SVG规范，如果显式设置了fill="none"，则不填充
-    if (style.fillNone) return glm::vec4(0, 0, 0, 0);
-    
-    // 如果没有设置fillColor，SVG默认为黑色
-    glm::vec4 color = style.fillColor.value_or(glm::vec4(0, 0, 0, 1));
-    if (style.fillOpacity) color.a *= *style.fillOpacity;
-    if (style.opacity) color.a *= *style.opacity;
-    
-    return color;
-}
-
-inline glm::vec4 SVGRendererV2::GetStrokeColor(const SVGStyle& style) {
-    if (!style.strokeColor) return glm::vec4(0, 0, 0, 0);
-    
-    glm::vec4 color = *style.strokeColor;
-    if (style.strokeOpacity) color.a *= *style.strokeOpacity;
-    if (style.opacity) color.a *= *style.opacity;
-    
-    return color;
-}
-
-inline StrokeStyle SVGRendererV2::GetStrokeStyle(const SVGStyle& style) {
-    StrokeStyle strokeStyle;
-    strokeStyle.width = style.strokeWidth.value_or(1.0f);
-    
-    // Parse lineCap from style
-    if (style.strokeLineCap) {
-        const std::string& cap = *style.strokeLineCap;
-        if (cap == "round") {
-            strokeStyle.lineCap = LineCap::Round;
-        } else if (cap == "square") {
-            strokeStyle.lineCap = LineCap::Square;
-        } else {
-            strokeStyle.lineCap = LineCap::Butt;  // Default
-        }
+    if (alpha >= 1.0f) {
+        _blend->fillOpaque(row, count, src);
     } else {
-        strokeStyle.lineCap = LineCap::Butt;
-    }
-    
-    // Parse lineJoin from style
-    if (style.strokeLineJoin) {
-        const std::string& join = *style.strokeLineJoin;
-        if (join == "round") {
-            strokeStyle.lineJoin = LineJoin::Round;
-        } else if (join == "bevel") {
-            strokeStyle.lineJoin = LineJoin::Bevel;
-        } else {
-            strokeStyle.lineJoin = LineJoin::Miter;  // Default
-        }
-    } else {
-        strokeStyle.lineJoin = LineJoin::Miter;
-    }
-    
-    // Parse miter limit
-    strokeStyle.miterLimit = style.strokeMiterLimit.value_or(4.0f);
-    
-    // Parse dash array
-    if (style.strokeDashArray && !style.strokeDashArray->empty()) {
-        strokeStyle.dashArray = *style.strokeDashArray;
-        strokeStyle.dashOffset = style.strokeDashOffset.value_or(0.0f);
-    }
-    
-    return strokeStyle;
-}
-
-inline FillRule SVGRendererV2::GetFillRule(const SVGStyle& style) {
-    if (style.fillRule && *style.fillRule == "evenodd") {
-        return FillRule::EvenOdd;
+        _blend->blendSolid(row, count, src * alpha, 1.0f - alpha);
     }
-    return FillRule::NonZero;
 }
 
 inline Matrix3x3 SVGRendererV2::ConvertTransform(const Transform2D& t) {
@@ -321,7 +321,7 @@ std::vector<SubPath> SVGPath::GetSubPathsWithClosedInfo() const {
 }
 
 // SVGDocument::ParseViewBox() 实现
-bool SVGDocument::ParseViewBox(float& x, float& y, float& w, float& h) const {
+bool SVGDocument::ParseViewBox(const std::string& viewBox, float& x, float& y, float& w, float& h) {
     if (viewBox.empty()) return false;
 
     std::istringstream iss(viewBox);
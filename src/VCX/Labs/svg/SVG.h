@@ -1,18 +1,19 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <optional>
 #include <glm/glm.hpp>
 
-// Forward declarations
-namespace tinyxml2 {
-    class XMLDocument;
-    class XMLElement;
-}
-
 namespace VCX::Labs::SVG {
 
+// 关键字属性，解析时即转换（无法识别的值按默认值处理）
+enum class SVGFillRule : std::uint8_t { NonZero, EvenOdd };
+enum class SVGLineCap : std::uint8_t { Butt, Round, Square };
+enum class SVGLineJoin : std::uint8_t { Miter, Round, Bevel };
+
 // SVG 样式结构
 struct SVGStyle {
     std::optional<glm::vec4> fillColor;        // RGBA fill color
@@ -21,13 +22,13 @@ struct SVGStyle {
     std::optional<float>     opacity;          // Overall opacity
     std::optional<float>     fillOpacity;      // Fill opacity
     std::optional<float>     strokeOpacity;    // Stroke opacity
-    std::optional<std::string> fillRule;       // "evenodd" or "nonzero"
+    std::optional<SVGFillRule> fillRule;       // evenodd / nonzero
     bool fillNone = false;                     // 显式设置fill="none"
     bool strokeNone = false;                   // 显式设置stroke="none"
     
     // Stroke styling (V2 renderer)
-    std::optional<std::string> strokeLineCap;  // "butt", "round", "square"
-    std::optional<std::string> strokeLineJoin; // "miter", "round", "bevel"
+    std::optional<SVGLineCap>  strokeLineCap;  // butt / round / square
+    std::optional<SVGLineJoin> strokeLineJoin; // miter / round / bevel
     std::optional<float>     strokeMiterLimit; // Miter limit ratio (default 4)
     std::optional<std::vector<float>> strokeDashArray;  // Dash pattern
     std::optional<float>     strokeDashOffset; // Dash offset
@@ -192,6 +193,30 @@ struct SVGElement {
     Transform2D transform;
     std::vector<SVGElement> children;  // 用于group元素
 
+    // 渲染缓存标识：uid 在元素生命周期内不变（随移动转移），
+    // version 在几何内容改变时递增，contentOffset 记录同一 version 下的纯平移，
+    // styleVersion 在样式（颜色、描边、填充规则）改变时递增
+    std::uint64_t uid = NextUid();
+    std::uint32_t version = 0;
+    std::uint32_t styleVersion = 0;
+    Point2D contentOffset;
+
+    // 几何内容被修改（除纯平移外的任何修改）
+    void MarkModified() { ++version; }
+    // 样式被修改
+    void MarkStyleModified() { ++styleVersion; }
+    // 几何内容整体平移了 (dx, dy)
+    void MarkTranslated(float dx, float dy) {
+        contentOffset.x += dx;
+        contentOffset.y += dy;
+    }
+
+    // count > 1 预留一段连续的 uid，返回其中第一个
+    static std::uint64_t NextUid(std::uint64_t count = 1) {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(count) + 1;
+    }
+
     SVGElement(Type t) : type(t) {
         // 根据类型初始化对应的union成员
         switch (type) {
@@ -215,7 +240,11 @@ struct SVGElement {
         id(std::move(other.id)),
         style(std::move(other.style)),
         transform(std::move(other.transform)),
-        children(std::move(other.children)) {
+        children(std::move(other.children)),
+        uid(other.uid),
+        version(other.version),
+        styleVersion(other.styleVersion),
+        contentOffset(other.contentOffset) {
         switch (type) {
             case Path:    new (&path)    SVGPath(std::move(other.path));       break;
             case Circle:  new (&circle)  SVGCircle(std::move(other.circle));   break;
@@ -245,6 +274,10 @@ struct SVGElement {
         style = std::move(other.style);
         transform = std::move(other.transform);
         children = std::move(other.children);
+        uid = other.uid;
+        version = other.version;
+        styleVersion = other.styleVersion;
+        contentOffset = other.contentOffset;
 
         switch (type) {
             case Path:    new (&path)    SVGPath(std::move(other.path));       break;
@@ -290,7 +323,10 @@ struct SVGDocument {
     std::vector<SVGElement> elements;
 
     // 解析viewBox
-    bool ParseViewBox(float& x, float& y, float& w, float& h) const;
+    bool ParseViewBox(float& x, float& y, float& w, float& h) const {
+        return ParseViewBox(viewBox, x, y, w, h);
+    }
+    static bool ParseViewBox(const std::string& viewBox, float& x, float& y, float& w, float& h);
 };
 
 } // namespace VCX::Labs::SVG
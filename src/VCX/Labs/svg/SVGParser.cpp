@@ -1,506 +1,712 @@
 #include "SVGParser.h"
-#include <tinyxml2.h>
+#include "Core/MappedFile.h"
+#include "Document/DocumentCache.h"
+#include "Parser/PathDataParser.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <optional>
 #include <regex>
+#include <type_traits>
 #include <unordered_map>
 
 namespace VCX::Labs::SVG {
 
-    SVGParser::SVGParser() : _xmlDoc(std::make_unique<tinyxml2::XMLDocument>()) {}
+    //=========================================================================
+    // Builder - XmlReader 的回调，边读边把元素写入文档
+    //
+    // 第一个 <svg> 元素为根；组按栈维护，进入 <g> 时合并变换（SVGDocument
+    // 还合并继承的样式）。形状在开始标签处解析并写入；<text> 的文本是它的
+    // 第一个子节点（与 tinyxml2 的 GetText 相同），所以在结束标签时才写入。
+    // 元数据、未知标签和形状的子树整体跳过。
+    //
+    // 给出 SVGSourceMap 时（仅 SVGDocument）记下各组的上下文与各元素的源文本范围；
+    // BeginFragment 让 Builder 直接处于某个组中，用来单独解析一个元素。
+    //=========================================================================
+    template <typename Document>
+    class SVGParser::Builder {
+    public:
+        Builder(SVGParser& parser, Document& document, SVGSourceMap* sourceMap = nullptr)
+            : _parser(parser), _document(document), _sourceMap(sourceMap) {}
+
+        bool FoundRoot() const { return _state != State::BeforeRoot; }
+
+        void BeginFragment(const SVGSourceMap::Group& context) {
+            Group group;
+            group.transform = context.transform;
+            group.style = context.style;
+            _groups.assign(1, group);
+            if (_sourceMap) _sourceMap->groups.assign(1, context);
+            _state = State::InRoot;
+        }
+
+        void StartElement(std::string_view name, const XmlAttributes& attributes) {
+            if (_skipDepth > 0) {
+                ++_skipDepth;
+                return;
+            }
+            if (_inText) {
+                // <text> 的子元素（如 <tspan>）不解析
+                _awaitingText = false;
+                _skipDepth = 1;
+                return;
+            }
+            if (_state != State::InRoot) {
+                if (_state == State::BeforeRoot && name == "svg") {
+                    _parser.ParseDocumentHeader(attributes, _document.width, _document.height, _document.viewBox);
+                    _groups.emplace_back();
+                    if (_sourceMap) _sourceMap->groups.emplace_back();
+                    _state = State::InRoot;
+                } else {
+                    _skipDepth = 1;
+                }
+                return;
+            }
 
-    SVGParser::~SVGParser() = default;
+            // 跳过元数据元素
+            if (name == "title" || name == "desc" || name == "metadata" || name == "defs") {
+                _skipDepth = 1;
+            } else if (name == "g") {
+                PushGroup(attributes);
+            } else if (name == "text") {
+                BeginText(attributes);
+                _inText = true;
+                _awaitingText = true;
+            } else {
+                AddShape(name, attributes);
+                _skipDepth = 1;
+            }
+        }
 
-    bool SVGParser::ParseFile(const std::string& filename, SVGDocument& document) {
-        tinyxml2::XMLError error = _xmlDoc->LoadFile(filename.c_str());
-        if (error != tinyxml2::XML_SUCCESS) {
-            std::cerr << "Failed to load SVG file: " << filename << std::endl;
-            return false;
+        void EndElement(std::string_view) {
+            if (_skipDepth > 0) {
+                if (--_skipDepth == 0 && _spanOpen) {
+                    // 形状的子树结束：它的源文本范围到此为止
+                    _sourceMap->spans.back().end = _parser._reader.TagEnd();
+                    _spanOpen = false;
+                }
+            } else if (_inText) {
+                EndText();
+                _inText = false;
+            } else if (_state == State::InRoot) {
+                _groups.pop_back();
+                if (_groups.empty()) _state = State::AfterRoot;
+            }
         }
 
-        // 尝试查找svg元素（处理带有XML声明的SVG）
-        // FirstChildElement会跳过XML声明和注释
-        tinyxml2::XMLElement* svgElement = _xmlDoc->FirstChildElement("svg");
-        // //打印出svgElement的内容
-        // if (svgElement) {
-        //     std::cout << "svgElement: " << svgElement->GetText() << std::endl;
-        // }
-        // else{
-        //     std::cerr << "wrong" << std::endl;
-        // }
-        
-        if (!svgElement) {
-            // 某些情况下，尝试使用RootElement
-            svgElement = _xmlDoc->RootElement();
-            if (!svgElement || std::string(svgElement->Name()) != "svg") {
-                std::cerr << "No SVG element found in file" << std::endl;
-                return false;
+        void Text(std::string_view text) {
+            if (_inText && _awaitingText) {
+                if constexpr (c_Flat) _textContent.assign(text);
+                else _pendingText->text.text.assign(text);
+            }
+            _awaitingText = false;
+        }
+
+        void OtherNode() { _awaitingText = false; }
+
+    private:
+        static constexpr bool c_Flat = std::is_same_v<Document, FlatDocument>;
+
+        enum class State { BeforeRoot, InRoot, AfterRoot };
+
+        struct Group {
+            Transform2D transform;
+            SVGStyle style;                     // SVGDocument：合并后的继承样式
+            std::uint32_t transformIndex = 0;   // FlatDocument：transform 在表中的位置
+            std::uint32_t mapGroup = 0;         // SVGDocument：在 SVGSourceMap::groups 中的位置
+        };
+
+        SVGParser& _parser;
+        Document& _document;
+        SVGSourceMap* _sourceMap;
+        bool _spanOpen = false;                 // spans.back() 的结束位置未定
+        size_t _textBegin = 0;                  // 未结束的 <text> 的开始位置
+        State _state = State::BeforeRoot;
+        int _skipDepth = 0;                     // >0：位于被跳过的子树中
+        bool _inText = false;
+        bool _awaitingText = false;             // 尚未读到 <text> 的第一个子节点
+        std::vector<Group> _groups;             // [0] 为根元素
+
+        std::optional<SVGElement> _pendingText; // SVGDocument
+        FlatText _flatText;                     // FlatDocument
+        std::string _textContent;
+
+        void PushGroup(const XmlAttributes& attributes) {
+            const Group& parent = _groups.back();
+            Group group;
+            // 组合父级变换（使用矩阵乘法）
+            group.transform = parent.transform * _parser.ParseTransform(_parser.GetAttribute(attributes, "transform"));
+
+            if constexpr (c_Flat) {
+                // 组样式的继承只写入 element.style，绘制并不使用，这里不保存
+                group.transformIndex = _document.AddTransform(group.transform.matrix);
+            } else {
+                // 继承样式（如果组自身没有定义的话）
+                group.style = _parser.ParseStyle(attributes);
+                if (!group.style.fillColor.has_value() && parent.style.fillColor.has_value()) {
+                    group.style.fillColor = parent.style.fillColor;
+                }
+                if (!group.style.strokeColor.has_value() && parent.style.strokeColor.has_value()) {
+                    group.style.strokeColor = parent.style.strokeColor;
+                }
+                if (!group.style.strokeWidth.has_value() && parent.style.strokeWidth.has_value()) {
+                    group.style.strokeWidth = parent.style.strokeWidth;
+                }
+                if (_sourceMap) {
+                    group.mapGroup = static_cast<std::uint32_t>(_sourceMap->groups.size());
+                    _sourceMap->groups.push_back({ group.transform, group.style });
+                }
+            }
+            _groups.push_back(std::move(group));
+        }
+
+        // 应用组合变换和继承样式后加入文档
+        void Append(SVGElement&& element) {
+            const Group& group = _groups.back();
+            element.transform = group.transform * element.transform;
+            if (!element.style.fillColor.has_value() && group.style.fillColor.has_value()) {
+                element.style.fillColor = group.style.fillColor;
+            }
+            if (!element.style.strokeColor.has_value() && group.style.strokeColor.has_value()) {
+                element.style.strokeColor = group.style.strokeColor;
+            }
+            if (!element.style.strokeWidth.has_value() && group.style.strokeWidth.has_value()) {
+                element.style.strokeWidth = group.style.strokeWidth;
+            }
+            _document.elements.push_back(std::move(element));
+        }
+
+        void AddShape(std::string_view name, const XmlAttributes& attributes) {
+            if constexpr (c_Flat) {
+                _parser.ParseFlatShape(name, attributes, _document, _groups.back().transformIndex);
+            } else {
+                SVGElement::Type type;
+                if (name == "path") {
+                    type = SVGElement::Type::Path;
+                } else if (name == "circle") {
+                    type = SVGElement::Type::Circle;
+                } else if (name == "ellipse") {
+                    type = SVGElement::Type::Ellipse;
+                } else if (name == "rect") {
+                    type = SVGElement::Type::Rect;
+                } else if (name == "line") {
+                    type = SVGElement::Type::Line;
+                } else {
+                    // 未知标签类型，跳过
+                    return;
+                }
+
+                SVGElement element(type);
+                bool parsed = false;
+                switch (type) {
+                    case SVGElement::Type::Path:    parsed = _parser.ParsePathElement(attributes, element);    break;
+                    case SVGElement::Type::Circle:  parsed = _parser.ParseCircleElement(attributes, element);  break;
+                    case SVGElement::Type::Ellipse: parsed = _parser.ParseEllipseElement(attributes, element); break;
+                    case SVGElement::Type::Rect:    parsed = _parser.ParseRectElement(attributes, element);    break;
+                    case SVGElement::Type::Line:    parsed = _parser.ParseLineElement(attributes, element);    break;
+                    default: break;
+                }
+                if (!parsed) return;
+                if (type == SVGElement::Type::Path && _parser.DefersPaths()) {
+                    std::uint32_t index = static_cast<std::uint32_t>(_document.elements.size());
+                    _parser._deferredPaths.push_back({ index, _parser.GetAttribute(attributes, "d") });
+                }
+                Append(std::move(element));
+                if (_sourceMap) {
+                    _sourceMap->spans.push_back({ _parser._reader.TagBegin(), 0, _groups.back().mapGroup });
+                    _spanOpen = true;
+                }
+            }
+        }
+
+        void BeginText(const XmlAttributes& attributes) {
+            if constexpr (c_Flat) {
+                _parser.ParseFlatText(attributes, _document, _groups.back().transformIndex, _flatText);
+                _textContent.clear();
+            } else {
+                _pendingText.emplace(SVGElement::Type::Text);
+                _parser.ParseTextElement(attributes, *_pendingText);
+                _textBegin = _parser._reader.TagBegin();
+            }
+        }
+
+        void EndText() {
+            if constexpr (c_Flat) {
+                _flatText.run.text = _document.strings.Intern(_textContent);
+                _document.AddText(_flatText.id, _flatText.style, _flatText.transform, _flatText.shapeTransform, _flatText.run);
+            } else {
+                Append(std::move(*_pendingText));
+                _pendingText.reset();
+                if (_sourceMap) {
+                    _sourceMap->spans.push_back({ _textBegin, _parser._reader.TagEnd(), _groups.back().mapGroup });
+                }
             }
         }
+    };
 
-        return ParseSVGElement(svgElement, document);
+    bool SVGParser::ParseFile(const std::string& filename, SVGDocument& document) {
+        MappedFile file;
+        if (!file.Open(filename)) {
+            std::cerr << "Failed to load SVG file: " << filename << std::endl;
+            return false;
+        }
+        return ParseSource(file.View(), "file " + filename, document);
     }
 
     bool SVGParser::ParseString(const std::string& svgContent, SVGDocument& document) {
-        tinyxml2::XMLError error = _xmlDoc->Parse(svgContent.c_str());
-        if (error != tinyxml2::XML_SUCCESS) {
-            //打印出error详细信息
-            std::cout << "error: " << error << std::endl;
-            std::cerr << "Failed to parse SVG content" << std::endl;
+        return ParseSource(svgContent, "content", document);
+    }
+
+    bool SVGParser::ParseString(const std::string& svgContent, SVGDocument& document, SVGSourceMap& sourceMap) {
+        return ParseSource(svgContent, "content", document, &sourceMap);
+    }
+
+    bool SVGParser::ParseElement(std::string_view markup, const SVGSourceMap::Group& group, SVGElement& element) {
+        // 只接受恰好从头到尾是一个元素的文本；编辑中途的残缺文本很常见，这里不报错
+        SVGDocument fragment;
+        SVGSourceMap sourceMap;
+        Builder<SVGDocument> builder(*this, fragment, &sourceMap);
+        builder.BeginFragment(group);
+        _deferredPaths.clear();
+        bool parsed = _reader.Parse(markup, builder) && fragment.elements.size() == 1 &&
+                      sourceMap.spans.size() == 1 && sourceMap.spans[0].begin == 0 &&
+                      sourceMap.spans[0].end == markup.size();
+        if (parsed && !_deferredPaths.empty()) ParseDeferredPaths(fragment);
+        _deferredPaths.clear();
+        if (!parsed) return false;
+        element = std::move(fragment.elements[0]);
+        return true;
+    }
+
+    bool SVGParser::ParseFile(const std::string& filename, FlatDocument& document) {
+        MappedFile file;
+        if (!file.Open(filename)) {
+            std::cerr << "Failed to load SVG file: " << filename << std::endl;
             return false;
         }
+        std::string_view source = file.View();
+        if (!_documentCacheEnabled) return ParseSource(source, "file " + filename, document);
 
-        // 尝试查找svg元素（处理带有XML声明的SVG）
-        // FirstChildElement会跳过XML声明和注释
-        tinyxml2::XMLElement* svgElement = _xmlDoc->FirstChildElement("svg");
-        
-        if (!svgElement) {
-            // 某些情况下，尝试使用RootElement
-            svgElement = _xmlDoc->RootElement();
-            if (!svgElement || std::string(svgElement->Name()) != "svg") {
-                std::cerr << "No SVG element found in content" << std::endl;
-                return false;
+        // 缓存以源文件内容哈希和 FlatDocumentCache::c_ParserRevision 为键（改动解析结果时须递增后者）：
+        // 一致时直接映射，否则解析后重写（写入失败不影响解析结果）
+        std::string cachePath = FlatDocumentCache::PathFor(filename);
+        std::uint64_t hash = FlatDocumentCache::ContentHash(source);
+        if (FlatDocumentCache::Load(cachePath, source.size(), hash, document)) return true;
+        if (!ParseSource(source, "file " + filename, document)) return false;
+        FlatDocumentCache::Save(cachePath, source.size(), hash, document);
+        return true;
+    }
+
+    bool SVGParser::ParseString(const std::string& svgContent, FlatDocument& document) {
+        return ParseSource(svgContent, "content", document);
+    }
+
+    template <typename Document>
+    bool SVGParser::ParseSource(std::string_view source, const std::string& description, Document& document,
+                                SVGSourceMap* sourceMap) {
+        // 元素边读边写入，失败时撤销已写入的部分
+        if (sourceMap) sourceMap->Clear();
+        size_t elementCount = 0;
+        if constexpr (std::is_same_v<Document, FlatDocument>) {
+            document.Clear();
+        } else {
+            elementCount = document.elements.size();
+        }
+        auto rollback = [&]() {
+            _deferredPaths.clear();
+            if (sourceMap) sourceMap->Clear();
+            if constexpr (std::is_same_v<Document, FlatDocument>) {
+                document.Clear();
+            } else {
+                document.elements.erase(document.elements.begin() + elementCount, document.elements.end());
             }
+        };
+
+        _deferredPaths.clear();
+        Builder<Document> builder(*this, document, sourceMap);
+        if (!_reader.Parse(source, builder)) {
+            std::cerr << "Failed to parse SVG " << description << ": " << _reader.Error() << std::endl;
+            rollback();
+            return false;
+        }
+        if (!builder.FoundRoot()) {
+            std::cerr << "No SVG element found in " << description << std::endl;
+            rollback();
+            return false;
         }
 
-        return ParseSVGElement(svgElement, document);
+        // 延后的 d 属性指向 source，须在返回前解析完
+        if (!_deferredPaths.empty()) {
+            ParseDeferredPaths(document);
+            _deferredPaths.clear();
+        }
+        if constexpr (std::is_same_v<Document, FlatDocument>) document.Finish();
+        return true;
     }
 
-    bool SVGParser::ParseSVGElement(tinyxml2::XMLElement* svgElement, SVGDocument& document) {
+    void SVGParser::ParseDocumentHeader(const XmlAttributes& attributes, float& width, float& height, std::string& viewBox) {
         // 解析基本属性
-        document.viewBox = GetAttribute(svgElement, "viewBox");
+        viewBox = GetAttribute(attributes, "viewBox");
         
         // 尝试从属性获取 width/height
-        std::string widthStr = GetAttribute(svgElement, "width");
-        std::string heightStr = GetAttribute(svgElement, "height");
+        std::string_view widthStr = GetAttribute(attributes, "width");
+        std::string_view heightStr = GetAttribute(attributes, "height");
         
         // 如果没有 width/height，尝试从 viewBox 推断
         if (widthStr.empty() || heightStr.empty()) {
             float vbX, vbY, vbW, vbH;
-            if (!document.viewBox.empty()) {
-                std::istringstream iss(document.viewBox);
+            if (!viewBox.empty()) {
+                std::istringstream iss(viewBox);
                 if (iss >> vbX >> vbY >> vbW >> vbH) {
-                    if (widthStr.empty()) document.width = vbW;
-                    if (heightStr.empty()) document.height = vbH;
+                    if (widthStr.empty()) width = vbW;
+                    if (heightStr.empty()) height = vbH;
                 }
             }
         }
         
         // 如果有明确的 width/height 属性，使用它们
         if (!widthStr.empty()) {
-            document.width = ParseLength(widthStr, 800.0f);
-        } else if (document.width == 0) {
-            document.width = 800.0f;  // 最后的默认值
+            width = ParseLength(widthStr, 800.0f);
+        } else if (width == 0) {
+            width = 800.0f;  // 最后的默认值
         }
         if (!heightStr.empty()) {
-            document.height = ParseLength(heightStr, 600.0f);
-        } else if (document.height == 0) {
-            document.height = 600.0f;  // 最后的默认值
+            height = ParseLength(heightStr, 600.0f);
+        } else if (height == 0) {
+            height = 600.0f;  // 最后的默认值
         }
+    }
 
-        // 解析子元素
-        for (tinyxml2::XMLElement* child = svgElement->FirstChildElement(); child; child = child->NextSiblingElement()) {
-            std::string tagName = child->Name();
-            
-            // 跳过元数据元素
-            if (tagName == "title" || tagName == "desc" || tagName == "metadata" || tagName == "defs") {
-                continue;
-            }
-            
-            SVGElement element(SVGElement::Type::Path); // 临时类型
-            bool parsed = false;
-
-            if (tagName == "path") {
-                element.type = SVGElement::Type::Path;
-                parsed = ParsePathElement(child, element);
-            } else         if (tagName == "circle") {
-                element.type = SVGElement::Type::Circle;
-                parsed = ParseCircleElement(child, element);
-            } else if (tagName == "ellipse") {
-                element.type = SVGElement::Type::Ellipse;
-                parsed = ParseEllipseElement(child, element);
-            } else if (tagName == "rect") {
-                element.type = SVGElement::Type::Rect;
-                parsed = ParseRectElement(child, element);
-            } else if (tagName == "line") {
-                element.type = SVGElement::Type::Line;
-                parsed = ParseLineElement(child, element);
-            } else if (tagName == "text") {
-                element.type = SVGElement::Type::Text;
-                parsed = ParseTextElement(child, element);
-            } else if (tagName == "g") {
-                // 展平处理<g>标签：将子元素直接添加到document，应用组的变换和样式
-                ParseGroupElementFlattened(child, document, Transform2D(), SVGStyle());
-                continue; // 已处理，继续下一个元素
+    bool SVGParser::ParseFlatShape(std::string_view tagName, const XmlAttributes& attributes, FlatDocument& document, std::uint32_t transform) {
+        SVGElement::Type type;
+        std::uint32_t firstVerb = static_cast<std::uint32_t>(document.verbs.size());
+        std::uint32_t firstPoint = static_cast<std::uint32_t>(document.points.size());
+        if (tagName == "path") {
+            // 命令直接写入文档的 verbs/points；与 ParsePathElement 一致，
+            // 没有有效命令的路径不加入文档（此时什么也没写入）
+            std::string_view pathData = GetAttribute(attributes, "d");
+            if (DefersPaths()) {
+                // 先以空范围加入，命令由 ParseDeferredPaths 填入
+                if (!PathDataParser::HasCommand(pathData)) return false;
+                _deferredPaths.push_back({ static_cast<std::uint32_t>(document.paths.size()), pathData });
+            } else if (PathDataParser::Parse(pathData, document.verbs, document.points) == 0) {
+                return false;
             }
+            type = SVGElement::Type::Path;
+        } else if (tagName == "circle") {
+            type = SVGElement::Type::Circle;
+        } else if (tagName == "ellipse") {
+            type = SVGElement::Type::Ellipse;
+        } else if (tagName == "rect") {
+            type = SVGElement::Type::Rect;
+        } else if (tagName == "line") {
+            type = SVGElement::Type::Line;
+        } else {
+            // 未知标签类型，跳过
+            return false;
+        }
+
+        std::uint32_t id = document.strings.Intern(GetAttribute(attributes, "id"));
+        std::uint32_t style = document.AddStyle(ParseStyle(attributes));
+        std::uint32_t shapeTransform = document.AddTransform(ParseTransform(GetAttribute(attributes, "transform")).matrix);
 
-            if (parsed) {
-                document.elements.push_back(std::move(element));
+        switch (type) {
+            case SVGElement::Type::Path:
+                document.AddPath(id, style, transform, shapeTransform, firstVerb, firstPoint);
+                break;
+
+            case SVGElement::Type::Circle: {
+                const float values[] = {
+                    ParseLength(GetAttribute(attributes, "cx", "0")),
+                    ParseLength(GetAttribute(attributes, "cy", "0")),
+                    ParseLength(GetAttribute(attributes, "r", "0"))
+                };
+                document.AddShape(type, id, style, transform, shapeTransform, values, 3);
+                break;
             }
-        }
 
-        return true;
-    }
+            case SVGElement::Type::Ellipse: {
+                const float values[] = {
+                    ParseLength(GetAttribute(attributes, "cx", "0")),
+                    ParseLength(GetAttribute(attributes, "cy", "0")),
+                    ParseLength(GetAttribute(attributes, "rx", "0")),
+                    ParseLength(GetAttribute(attributes, "ry", "0"))
+                };
+                document.AddShape(type, id, style, transform, shapeTransform, values, 4);
+                break;
+            }
 
-    void SVGParser::ParseGroupElementFlattened(tinyxml2::XMLElement* element, SVGDocument& document, const Transform2D& parentTransform, const SVGStyle& parentStyle) {
-        // 获取当前<g>标签的变换和样式
-        Transform2D currentTransform = ParseTransform(GetAttribute(element, "transform"));
-        SVGStyle currentStyle = ParseStyle(element);
-        
-        // 组合父级变换（使用矩阵乘法）
-        Transform2D combinedTransform = parentTransform * currentTransform;
-        
-        // 继承样式（如果子元素没有定义的话）
-        SVGStyle combinedStyle = currentStyle;
-        if (!combinedStyle.fillColor.has_value() && parentStyle.fillColor.has_value()) {
-            combinedStyle.fillColor = parentStyle.fillColor;
-        }
-        if (!combinedStyle.strokeColor.has_value() && parentStyle.strokeColor.has_value()) {
-            combinedStyle.strokeColor = parentStyle.strokeColor;
-        }
-        if (!combinedStyle.strokeWidth.has_value() && parentStyle.strokeWidth.has_value()) {
-            combinedStyle.strokeWidth = parentStyle.strokeWidth;
-        }
-        
-        // 递归解析子元素
-        for (tinyxml2::XMLElement* child = element->FirstChildElement(); child; child = child->NextSiblingElement()) {
-            std::string tagName = child->Name();
-            
-            // 跳过元数据元素
-            if (tagName == "title" || tagName == "desc" || tagName == "metadata" || tagName == "defs") {
-                continue;
+            case SVGElement::Type::Rect: {
+                const float values[] = {
+                    ParseLength(GetAttribute(attributes, "x", "0")),
+                    ParseLength(GetAttribute(attributes, "y", "0")),
+                    ParseLength(GetAttribute(attributes, "width", "0")),
+                    ParseLength(GetAttribute(attributes, "height", "0")),
+                    ParseLength(GetAttribute(attributes, "rx", "0")),
+                    ParseLength(GetAttribute(attributes, "ry", "0"))
+                };
+                document.AddShape(type, id, style, transform, shapeTransform, values, 6);
+                break;
             }
-            
-            if (tagName == "g") {
-                // 递归处理嵌套的<g>标签
-                ParseGroupElementFlattened(child, document, combinedTransform, combinedStyle);
-            } else {
-                // 根据标签类型创建对应的元素
-                SVGElement::Type elementType = SVGElement::Type::Path;
-                if (tagName == "circle") {
-                    elementType = SVGElement::Type::Circle;
-                } else if (tagName == "ellipse") {
-                    elementType = SVGElement::Type::Ellipse;
-                } else if (tagName == "rect") {
-                    elementType = SVGElement::Type::Rect;
-                } else if (tagName == "line") {
-                    elementType = SVGElement::Type::Line;
-                } else if (tagName == "text") {
-                    elementType = SVGElement::Type::Text;
-                } else if (tagName != "path") {
-                    // 未知标签类型，跳过
-                    continue;
-                }
-                
-                SVGElement childElement(elementType);
-                bool parsed = false;
-                
-                if (tagName == "path") {
-                    parsed = ParsePathElement(child, childElement);
-                } else if (tagName == "circle") {
-                    parsed = ParseCircleElement(child, childElement);
-                } else if (tagName == "ellipse") {
-                    parsed = ParseEllipseElement(child, childElement);
-                } else if (tagName == "rect") {
-                    parsed = ParseRectElement(child, childElement);
-                } else if (tagName == "line") {
-                    parsed = ParseLineElement(child, childElement);
-                } else if (tagName == "text") {
-                    parsed = ParseTextElement(child, childElement);
-                }
-                
-                if (parsed) {
-                    // 应用组合变换到元素（使用矩阵乘法）
-                    childElement.transform = combinedTransform * childElement.transform;
-                    
-                    // 继承样式（如果元素自身没有定义）
-                    if (!childElement.style.fillColor.has_value() && combinedStyle.fillColor.has_value()) {
-                        childElement.style.fillColor = combinedStyle.fillColor;
-                    }
-                    if (!childElement.style.strokeColor.has_value() && combinedStyle.strokeColor.has_value()) {
-                        childElement.style.strokeColor = combinedStyle.strokeColor;
-                    }
-                    if (!childElement.style.strokeWidth.has_value() && combinedStyle.strokeWidth.has_value()) {
-                        childElement.style.strokeWidth = combinedStyle.strokeWidth;
-                    }
-                    
-                    document.elements.push_back(std::move(childElement));
-                }
+
+            case SVGElement::Type::Line: {
+                const float values[] = {
+                    ParseLength(GetAttribute(attributes, "x1", "0")),
+                    ParseLength(GetAttribute(attributes, "y1", "0")),
+                    ParseLength(GetAttribute(attributes, "x2", "0")),
+                    ParseLength(GetAttribute(attributes, "y2", "0"))
+                };
+                document.AddShape(type, id, style, transform, shapeTransform, values, 4);
+                break;
             }
+
+            default:
+                break;
         }
+        return true;
     }
 
-    bool SVGParser::ParsePathElement(tinyxml2::XMLElement* element, SVGElement& svgElement) {
+    void SVGParser::ParseFlatText(const XmlAttributes& attributes, FlatDocument& document, std::uint32_t transform, FlatText& text) {
+        text.id = document.strings.Intern(GetAttribute(attributes, "id"));
+        text.style = document.AddStyle(ParseStyle(attributes));
+        text.transform = transform;
+        text.shapeTransform = document.AddTransform(ParseTransform(GetAttribute(attributes, "transform")).matrix);
+        text.run.position.x = ParseLength(GetAttribute(attributes, "x", "0"));
+        text.run.position.y = ParseLength(GetAttribute(attributes, "y", "0"));
+        text.run.fontSize = ParseLength(GetAttribute(attributes, "font-size", "12"), 12.0f);
+        text.run.fontFamily = document.strings.Intern(GetAttribute(attributes, "font-family", "Arial"));
+        text.run.text = 0;
+    }
+
+    bool SVGParser::ParsePathElement(const XmlAttributes& attributes, SVGElement& svgElement) {
         new (&svgElement.path) SVGPath();
 
-        svgElement.path.id = GetAttribute(element, "id");
-        svgElement.path.style = ParseStyle(element);
-        svgElement.path.transform = ParseTransform(GetAttribute(element, "transform"));
+        svgElement.path.id = GetAttribute(attributes, "id");
+        svgElement.path.style = ParseStyle(attributes);
+        svgElement.path.transform = ParseTransform(GetAttribute(attributes, "transform"));
 
-        std::string pathData = GetAttribute(element, "d");
+        std::string_view pathData = GetAttribute(attributes, "d");
         if (pathData.empty()) return false;
 
-        return ParsePathData(pathData, svgElement.path.commands);
+        // 并行模式由 Builder 记下 d，命令稍后填入
+        if (DefersPaths()) return PathDataParser::HasCommand(pathData);
+        return ParsePathData(pathData, svgElement.path.commands, _pathVerbs, _pathPoints);
     }
 
-    bool SVGParser::ParseCircleElement(tinyxml2::XMLElement* element, SVGElement& svgElement) {
+    bool SVGParser::ParseCircleElement(const XmlAttributes& attributes, SVGElement& svgElement) {
         new (&svgElement.circle) SVGCircle();
 
-        svgElement.circle.id = GetAttribute(element, "id");
-        svgElement.circle.center.x = ParseLength(GetAttribute(element, "cx", "0"));
-        svgElement.circle.center.y = ParseLength(GetAttribute(element, "cy", "0"));
-        svgElement.circle.radius = ParseLength(GetAttribute(element, "r", "0"));
-        svgElement.circle.style = ParseStyle(element);
-        svgElement.circle.transform = ParseTransform(GetAttribute(element, "transform"));
+        svgElement.circle.id = GetAttribute(attributes, "id");
+        svgElement.circle.center.x = ParseLength(GetAttribute(attributes, "cx", "0"));
+        svgElement.circle.center.y = ParseLength(GetAttribute(attributes, "cy", "0"));
+        svgElement.circle.radius = ParseLength(GetAttribute(attributes, "r", "0"));
+        svgElement.circle.style = ParseStyle(attributes);
+        svgElement.circle.transform = ParseTransform(GetAttribute(attributes, "transform"));
 
         return true;
     }
 
-    bool SVGParser::ParseEllipseElement(tinyxml2::XMLElement* element, SVGElement& svgElement) {
+    bool SVGParser::ParseEllipseElement(const XmlAttributes& attributes, SVGElement& svgElement) {
         new (&svgElement.ellipse) SVGEllipse();
 
-        svgElement.ellipse.id = GetAttribute(element, "id");
-        svgElement.ellipse.center.x = ParseLength(GetAttribute(element, "cx", "0"));
-        svgElement.ellipse.center.y = ParseLength(GetAttribute(element, "cy", "0"));
-        svgElement.ellipse.rx = ParseLength(GetAttribute(element, "rx", "0"));
-        svgElement.ellipse.ry = ParseLength(GetAttribute(element, "ry", "0"));
-        svgElement.ellipse.style = ParseStyle(element);
-        svgElement.ellipse.transform = ParseTransform(GetAttribute(element, "transform"));
+        svgElement.ellipse.id = GetAttribute(attributes, "id");
+        svgElement.ellipse.center.x = ParseLength(GetAttribute(attributes, "cx", "0"));
+        svgElement.ellipse.center.y = ParseLength(GetAttribute(attributes, "cy", "0"));
+        svgElement.ellipse.rx = ParseLength(GetAttribute(attributes, "rx", "0"));
+        svgElement.ellipse.ry = ParseLength(GetAttribute(attributes, "ry", "0"));
+        svgElement.ellipse.style = ParseStyle(attributes);
+        svgElement.ellipse.transform = ParseTransform(GetAttribute(attributes, "transform"));
 
         return true;
     }
 
-    bool SVGParser::ParseRectElement(tinyxml2::XMLElement* element, SVGElement& svgElement) {
+    bool SVGParser::ParseRectElement(const XmlAttributes& attributes, SVGElement& svgElement) {
         new (&svgElement.rect) SVGRect();
 
-        svgElement.rect.id = GetAttribute(element, "id");
-        svgElement.rect.position.x = ParseLength(GetAttribute(element, "x", "0"));
-        svgElement.rect.position.y = ParseLength(GetAttribute(element, "y", "0"));
-        svgElement.rect.width = ParseLength(GetAttribute(element, "width", "0"));
-        svgElement.rect.height = ParseLength(GetAttribute(element, "height", "0"));
-        svgElement.rect.rx = ParseLength(GetAttribute(element, "rx", "0"));
-        svgElement.rect.ry = ParseLength(GetAttribute(element, "ry", "0"));
-        svgElement.rect.style = ParseStyle(element);
-        svgElement.rect.transform = ParseTransform(GetAttribute(element, "transform"));
+        svgElement.rect.id = GetAttribute(attributes, "id");
+        svgElement.rect.position.x = ParseLength(GetAttribute(attributes, "x", "0"));
+        svgElement.rect.position.y = ParseLength(GetAttribute(attributes, "y", "0"));
+        svgElement.rect.width = ParseLength(GetAttribute(attributes, "width", "0"));
+        svgElement.rect.height = ParseLength(GetAttribute(attributes, "height", "0"));
+        svgElement.rect.rx = ParseLength(GetAttribute(attributes, "rx", "0"));
+        svgElement.rect.ry = ParseLength(GetAttribute(attributes, "ry", "0"));
+        svgElement.rect.style = ParseStyle(attributes);
+        svgElement.rect.transform = ParseTransform(GetAttribute(attributes, "transform"));
 
         return true;
     }
 
-    bool SVGParser::ParseLineElement(tinyxml2::XMLElement* element, SVGElement& svgElement) {
+    bool SVGParser::ParseLineElement(const XmlAttributes& attributes, SVGElement& svgElement) {
         new (&svgElement.line) SVGLine();
 
-        svgElement.line.id = GetAttribute(element, "id");
-        svgElement.line.start.x = ParseLength(GetAttribute(element, "x1", "0"));
-        svgElement.line.start.y = ParseLength(GetAttribute(element, "y1", "0"));
-        svgElement.line.end.x = ParseLength(GetAttribute(element, "x2", "0"));
-        svgElement.line.end.y = ParseLength(GetAttribute(element, "y2", "0"));
-        svgElement.line.style = ParseStyle(element);
-        svgElement.line.transform = ParseTransform(GetAttribute(element, "transform"));
+        svgElement.line.id = GetAttribute(attributes, "id");
+        svgElement.line.start.x = ParseLength(GetAttribute(attributes, "x1", "0"));
+        svgElement.line.start.y = ParseLength(GetAttribute(attributes, "y1", "0"));
+        svgElement.line.end.x = ParseLength(GetAttribute(attributes, "x2", "0"));
+        svgElement.line.end.y = ParseLength(GetAttribute(attributes, "y2", "0"));
+        svgElement.line.style = ParseStyle(attributes);
+        svgElement.line.transform = ParseTransform(GetAttribute(attributes, "transform"));
 
         return true;
     }
 
-    bool SVGParser::ParseTextElement(tinyxml2::XMLElement* element, SVGElement& svgElement) {
+    bool SVGParser::ParseTextElement(const XmlAttributes& attributes, SVGElement& svgElement) {
         new (&svgElement.text) SVGText();
 
-        svgElement.text.id = GetAttribute(element, "id");
-        svgElement.text.position.x = ParseLength(GetAttribute(element, "x", "0"));
-        svgElement.text.position.y = ParseLength(GetAttribute(element, "y", "0"));
-        svgElement.text.text = element->GetText() ? element->GetText() : "";
-        svgElement.text.fontSize = ParseLength(GetAttribute(element, "font-size", "12"), 12.0f);
-        svgElement.text.fontFamily = GetAttribute(element, "font-family", "Arial");
-        svgElement.text.style = ParseStyle(element);
-        svgElement.text.transform = ParseTransform(GetAttribute(element, "transform"));
+        svgElement.text.id = GetAttribute(attributes, "id");
+        svgElement.text.position.x = ParseLength(GetAttribute(attributes, "x", "0"));
+        svgElement.text.position.y = ParseLength(GetAttribute(attributes, "y", "0"));
+        svgElement.text.fontSize = ParseLength(GetAttribute(attributes, "font-size", "12"), 12.0f);
+        svgElement.text.fontFamily = GetAttribute(attributes, "font-family", "Arial");
+        svgElement.text.style = ParseStyle(attributes);
+        svgElement.text.transform = ParseTransform(GetAttribute(attributes, "transform"));
 
         return true;
     }
 
-    bool SVGParser::ParseGroupElement(tinyxml2::XMLElement* element, SVGElement& svgElement) {
-        svgElement.id = GetAttribute(element, "id");
-        svgElement.style = ParseStyle(element);
-        svgElement.transform = ParseTransform(GetAttribute(element, "transform"));
-
-        // 递归解析子元素
-        for (tinyxml2::XMLElement* child = element->FirstChildElement(); child; child = child->NextSiblingElement()) {
-            SVGElement childElement(SVGElement::Type::Path);
-            std::string tagName = child->Name();
-            bool parsed = false;
-
-            if (tagName == "path") {
-                childElement.type = SVGElement::Type::Path;
-                parsed = ParsePathElement(child, childElement);
-            } else if (tagName == "circle") {
-                childElement.type = SVGElement::Type::Circle;
-                parsed = ParseCircleElement(child, childElement);
-            } else if (tagName == "rect") {
-                childElement.type = SVGElement::Type::Rect;
-                parsed = ParseRectElement(child, childElement);
-            } else if (tagName == "line") {
-                childElement.type = SVGElement::Type::Line;
-                parsed = ParseLineElement(child, childElement);
-            } else if (tagName == "text") {
-                childElement.type = SVGElement::Type::Text;
-                parsed = ParseTextElement(child, childElement);
-            } else if (tagName == "g") {
-                // 递归处理嵌套的 <g> 标签
-                childElement.type = SVGElement::Type::Group;
-                parsed = ParseGroupElement(child, childElement);
-            }
+    SVGStyle SVGParser::ParseStyle(const XmlAttributes& attributes) {
+        SVGStyle style;
 
-            if (parsed) {
-                svgElement.children.push_back(std::move(childElement));
+        // 逗号或空白分隔的虚线长度
+        auto parseDashArray = [](std::string_view value) {
+            std::vector<float> dashValues;
+            std::istringstream dashStream{std::string(value)};
+            std::string dashToken;
+            while (std::getline(dashStream, dashToken, ',')) {
+                std::istringstream tokenStream(dashToken);
+                float v;
+                while (tokenStream >> v) {
+                    dashValues.push_back(v);
+                }
             }
-        }
-
-        return true;
-    }
-
-    SVGStyle SVGParser::ParseStyle(tinyxml2::XMLElement* element) {
-        SVGStyle style;
+            return dashValues;
+        };
 
         // 首先解析style属性（内联CSS样式）
-        if (HasAttribute(element, "style")) {
-            std::string styleStr = GetAttribute(element, "style");
-            std::istringstream iss(styleStr);
-            std::string prop;
-            
-            while (std::getline(iss, prop, ';')) {
+        if (const std::string_view* styleStr = attributes.Find("style")) {
+            std::string_view rest = *styleStr;
+            while (!rest.empty()) {
+                size_t end = rest.find(';');
+                std::string_view prop = rest.substr(0, end);
+                rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+
                 // 分割属性名和值
                 size_t colonPos = prop.find(':');
-                if (colonPos != std::string::npos) {
-                    std::string name = prop.substr(0, colonPos);
-                    std::string value = prop.substr(colonPos + 1);
-                    
-                    // 去除前后空白
-                    name.erase(0, name.find_first_not_of(" \t"));
-                    name.erase(name.find_last_not_of(" \t") + 1);
-                    value.erase(0, value.find_first_not_of(" \t"));
-                    value.erase(value.find_last_not_of(" \t") + 1);
-                    
-                    // 解析各种CSS属性
-                    if (name == "fill" && value != "none") {
-                        style.fillColor = ParseColor(value);
-                    } else if (name == "stroke" && value != "none") {
-                        style.strokeColor = ParseColor(value);
-                    } else if (name == "stroke-width") {
-                        style.strokeWidth = ParseLength(value, 1.0f);
-                    } else if (name == "opacity") {
-                        style.opacity = std::stof(value);
-                    } else if (name == "fill-opacity") {
-                        style.fillOpacity = std::stof(value);
-                    } else if (name == "stroke-opacity") {
-                        style.strokeOpacity = std::stof(value);
-                    } else if (name == "fill-rule") {
-                        style.fillRule = value;
-                    } else if (name == "stroke-linecap") {
-                        style.strokeLineCap = value;
-                    } else if (name == "stroke-linejoin") {
-                        style.strokeLineJoin = value;
-                    } else if (name == "stroke-miterlimit") {
-                        style.strokeMiterLimit = std::stof(value);
-                    } else if (name == "stroke-dasharray" && value != "none") {
-                        // Parse comma/space separated values
-                        std::vector<float> dashValues;
-                        std::istringstream dashStream(value);
-                        std::string dashToken;
-                        while (std::getline(dashStream, dashToken, ',')) {
-                            // Also handle space-separated values
-                            std::istringstream tokenStream(dashToken);
-                            float v;
-                            while (tokenStream >> v) {
-                                dashValues.push_back(v);
-                            }
-                        }
-                        if (!dashValues.empty()) {
-                            style.strokeDashArray = dashValues;
-                        }
-                    } else if (name == "stroke-dashoffset") {
-                        style.strokeDashOffset = ParseLength(value, 0.0f);
-                    } else if (name == "fill" && value == "none") {
-                        style.fillNone = true;
-                    } else if (name == "stroke" && value == "none") {
-                        style.strokeNone = true;
+                if (colonPos == std::string_view::npos) continue;
+                std::string_view name = prop.substr(0, colonPos);
+                std::string_view value = prop.substr(colonPos + 1);
+
+                // 去除前后空白
+                auto trim = [](std::string_view& text) {
+                    size_t first = text.find_first_not_of(" \t");
+                    if (first == std::string_view::npos) {
+                        text = std::string_view();
+                        return;
                     }
+                    text = text.substr(first, text.find_last_not_of(" \t") - first + 1);
+                };
+                trim(name);
+                trim(value);
+
+                // 解析各种CSS属性
+                if (name == "fill" && value != "none") {
+                    style.fillColor = ParseColor(value);
+                } else if (name == "stroke" && value != "none") {
+                    style.strokeColor = ParseColor(value);
+                } else if (name == "stroke-width") {
+                    style.strokeWidth = ParseLength(value, 1.0f);
+                } else if (name == "opacity") {
+                    if (std::optional<float> number = ParseNumber(value)) style.opacity = number;
+                } else if (name == "fill-opacity") {
+                    if (std::optional<float> number = ParseNumber(value)) style.fillOpacity = number;
+                } else if (name == "stroke-opacity") {
+                    if (std::optional<float> number = ParseNumber(value)) style.strokeOpacity = number;
+                } else if (name == "fill-rule") {
+                    style.fillRule = ParseFillRule(value);
+                } else if (name == "stroke-linecap") {
+                    style.strokeLineCap = ParseLineCap(value);
+                } else if (name == "stroke-linejoin") {
+                    style.strokeLineJoin = ParseLineJoin(value);
+                } else if (name == "stroke-miterlimit") {
+                    if (std::optional<float> number = ParseNumber(value)) style.strokeMiterLimit = number;
+                } else if (name == "stroke-dasharray" && value != "none") {
+                    std::vector<float> dashValues = parseDashArray(value);
+                    if (!dashValues.empty()) {
+                        style.strokeDashArray = dashValues;
+                    }
+                } else if (name == "stroke-dashoffset") {
+                    style.strokeDashOffset = ParseLength(value, 0.0f);
+                } else if (name == "fill" && value == "none") {
+                    style.fillNone = true;
+                } else if (name == "stroke" && value == "none") {
+                    style.strokeNone = true;
                 }
             }
         }
 
         // 解析fill属性（属性优先级高于style中的设置）
-        if (HasAttribute(element, "fill")) {
-            std::string fill = GetAttribute(element, "fill");
-            if (fill == "none") {
+        if (const std::string_view* fill = attributes.Find("fill")) {
+            if (*fill == "none") {
                 style.fillNone = true;
             } else {
-                style.fillColor = ParseColor(fill);
+                style.fillColor = ParseColor(*fill);
             }
         }
 
         // 解析stroke属性
-        if (HasAttribute(element, "stroke")) {
-            std::string stroke = GetAttribute(element, "stroke");
-            if (stroke == "none") {
+        if (const std::string_view* stroke = attributes.Find("stroke")) {
+            if (*stroke == "none") {
                 style.strokeNone = true;
             } else {
-                style.strokeColor = ParseColor(stroke);
+                style.strokeColor = ParseColor(*stroke);
             }
         }
 
         // 解析stroke-width属性
-        if (HasAttribute(element, "stroke-width")) {
-            style.strokeWidth = ParseLength(GetAttribute(element, "stroke-width"), 1.0f);
+        if (const std::string_view* value = attributes.Find("stroke-width")) {
+            style.strokeWidth = ParseLength(*value, 1.0f);
         }
 
         // 解析opacity属性
-        if (HasAttribute(element, "opacity")) {
-            style.opacity = std::stof(GetAttribute(element, "opacity"));
+        if (const std::string_view* value = attributes.Find("opacity")) {
+            if (std::optional<float> number = ParseNumber(*value)) style.opacity = number;
         }
 
         // 解析fill-opacity属性
-        if (HasAttribute(element, "fill-opacity")) {
-            style.fillOpacity = std::stof(GetAttribute(element, "fill-opacity"));
+        if (const std::string_view* value = attributes.Find("fill-opacity")) {
+            if (std::optional<float> number = ParseNumber(*value)) style.fillOpacity = number;
         }
 
         // 解析stroke-opacity属性
-        if (HasAttribute(element, "stroke-opacity")) {
-            style.strokeOpacity = std::stof(GetAttribute(element, "stroke-opacity"));
+        if (const std::string_view* value = attributes.Find("stroke-opacity")) {
+            if (std::optional<float> number = ParseNumber(*value)) style.strokeOpacity = number;
         }
 
         // 解析fill-rule属性
-        if (HasAttribute(element, "fill-rule")) {
-            style.fillRule = GetAttribute(element, "fill-rule");
+        if (const std::string_view* value = attributes.Find("fill-rule")) {
+            style.fillRule = ParseFillRule(*value);
         }
 
         // 解析stroke-linecap属性 (butt, round, square)
-        if (HasAttribute(element, "stroke-linecap")) {
-            style.strokeLineCap = GetAttribute(element, "stroke-linecap");
+        if (const std::string_view* value = attributes.Find("stroke-linecap")) {
+            style.strokeLineCap = ParseLineCap(*value);
         }
 
         // 解析stroke-linejoin属性 (miter, round, bevel)
-        if (HasAttribute(element, "stroke-linejoin")) {
-            style.strokeLineJoin = GetAttribute(element, "stroke-linejoin");
+        if (const std::string_view* value = attributes.Find("stroke-linejoin")) {
+            style.strokeLineJoin = ParseLineJoin(*value);
         }
 
         // 解析stroke-miterlimit属性
-        if (HasAttribute(element, "stroke-miterlimit")) {
-            style.strokeMiterLimit = std::stof(GetAttribute(element, "stroke-miterlimit"));
+        if (const std::string_view* value = attributes.Find("stroke-miterlimit")) {
+            if (std::optional<float> number = ParseNumber(*value)) style.strokeMiterLimit = number;
         }
 
         // 解析stroke-dasharray属性
-        if (HasAttribute(element, "stroke-dasharray")) {
-            std::string dashStr = GetAttribute(element, "stroke-dasharray");
-            if (dashStr != "none") {
-                std::vector<float> dashValues;
-                std::istringstream dashStream(dashStr);
-                std::string dashToken;
-                while (std::getline(dashStream, dashToken, ',')) {
-                    std::istringstream tokenStream(dashToken);
-                    float v;
-                    while (tokenStream >> v) {
-                        dashValues.push_back(v);
-                    }
-                }
+        if (const std::string_view* value = attributes.Find("stroke-dasharray")) {
+            if (*value != "none") {
+                std::vector<float> dashValues = parseDashArray(*value);
                 if (!dashValues.empty()) {
                     style.strokeDashArray = dashValues;
                 }
@@ -508,22 +714,22 @@ namespace VCX::Labs::SVG {
         }
 
         // 解析stroke-dashoffset属性
-        if (HasAttribute(element, "stroke-dashoffset")) {
-            style.strokeDashOffset = ParseLength(GetAttribute(element, "stroke-dashoffset"), 0.0f);
+        if (const std::string_view* value = attributes.Find("stroke-dashoffset")) {
+            style.strokeDashOffset = ParseLength(*value, 0.0f);
         }
 
         return style;
     }
 
-    Transform2D SVGParser::ParseTransform(const std::string& transformStr) {
+    Transform2D SVGParser::ParseTransform(std::string_view transformStr) {
         if (transformStr.empty()) return Transform2D();
 
         Transform2D result;
 
-        // 使用正则表达式解析变换字符串
-        std::regex transformRegex(R"((translate|scale|rotate|matrix)\s*\(([^)]+)\))");
-        std::sregex_iterator iter(transformStr.begin(), transformStr.end(), transformRegex);
-        std::sregex_iterator end;
+        // 使用正则表达式解析变换字符串（只编译一次）
+        static const std::regex transformRegex(R"((translate|scale|rotate|matrix)\s*\(([^)]+)\))");
+        std::cregex_iterator iter(transformStr.data(), transformStr.data() + transformStr.size(), transformRegex);
+        std::cregex_iterator end;
 
         for (; iter != end; ++iter) {
             std::string type = (*iter)[1].str();
@@ -536,8 +742,8 @@ namespace VCX::Labs::SVG {
             while (std::getline(iss, token, ',')) {
                 // 移除空白字符
                 token.erase(std::remove_if(token.begin(), token.end(), ::isspace), token.end());
-                if (!token.empty()) {
-                    values.push_back(std::stof(token));
+                if (std::optional<float> value = ParseNumber(token)) {
+                    values.push_back(*value);
                 }
             }
 
@@ -563,8 +769,9 @@ namespace VCX::Labs::SVG {
         return result;
     }
 
-    glm::vec4 SVGParser::ParseColor(const std::string& colorStr) {
-        if (colorStr.empty()) return glm::vec4(0, 0, 0, 1);
+    glm::vec4 SVGParser::ParseColor(std::string_view colorView) {
+        if (colorView.empty()) return glm::vec4(0, 0, 0, 1);
+        std::string colorStr(colorView);
 
         // 处理currentColor关键字（使用默认黑色）
         if (colorStr == "currentColor") {
@@ -576,16 +783,16 @@ namespace VCX::Labs::SVG {
             std::string hex = colorStr.substr(1);
             if (hex.length() == 3) {
                 // 缩写形式 #RGB
-                int r = std::stoi(hex.substr(0, 1) + hex.substr(0, 1), nullptr, 16);
-                int g = std::stoi(hex.substr(1, 1) + hex.substr(1, 1), nullptr, 16);
-                int b = std::stoi(hex.substr(2, 1) + hex.substr(2, 1), nullptr, 16);
-                return glm::vec4(r / 255.0f, g / 255.0f, b / 255.0f, 1.0f);
+                int r, g, b;
+                if (ParseHex(hex.substr(0, 1), r) && ParseHex(hex.substr(1, 1), g) && ParseHex(hex.substr(2, 1), b)) {
+                    return glm::vec4(r * 17 / 255.0f, g * 17 / 255.0f, b * 17 / 255.0f, 1.0f);
+                }
             } else if (hex.length() == 6) {
                 // 完整形式 #RRGGBB
-                int r = std::stoi(hex.substr(0, 2), nullptr, 16);
-                int g = std::stoi(hex.substr(2, 2), nullptr, 16);
-                int b = std::stoi(hex.substr(4, 2), nullptr, 16);
-                return glm::vec4(r / 255.0f, g / 255.0f, b / 255.0f, 1.0f);
+                int r, g, b;
+                if (ParseHex(hex.substr(0, 2), r) && ParseHex(hex.substr(2, 2), g) && ParseHex(hex.substr(4, 2), b)) {
+                    return glm::vec4(r / 255.0f, g / 255.0f, b / 255.0f, 1.0f);
+                }
             }
         }
 
@@ -600,9 +807,10 @@ namespace VCX::Labs::SVG {
                 token.erase(std::remove_if(token.begin(), token.end(), ::isspace), token.end());
                 if (!token.empty()) {
                     if (token.back() == '%') {
-                        values.push_back(std::stof(token.substr(0, token.size() - 1)) / 100.0f);
+                        std::string_view number(token.data(), token.size() - 1);
+                        if (std::optional<float> value = ParseNumber(number)) values.push_back(*value / 100.0f);
                     } else {
-                        values.push_back(std::stof(token) / 255.0f);
+                        if (std::optional<float> value = ParseNumber(token)) values.push_back(*value / 255.0f);
                     }
                 }
             }
@@ -636,394 +844,177 @@ namespace VCX::Labs::SVG {
         return glm::vec4(0, 0, 0, 1);
     }
 
-    float SVGParser::ParseLength(const std::string& lengthStr, float defaultValue) {
-        if (lengthStr.empty()) return defaultValue;
+    SVGFillRule SVGParser::ParseFillRule(std::string_view value) {
+        return value == "evenodd" ? SVGFillRule::EvenOdd : SVGFillRule::NonZero;
+    }
 
-        try {
-            std::string numStr;
-            std::string unit;
+    SVGLineCap SVGParser::ParseLineCap(std::string_view value) {
+        if (value == "round") return SVGLineCap::Round;
+        if (value == "square") return SVGLineCap::Square;
+        return SVGLineCap::Butt;
+    }
 
-            // 分离数字和单位
-            size_t i = 0;
-            while (i < lengthStr.size() && (std::isdigit(lengthStr[i]) || lengthStr[i] == '.' || lengthStr[i] == '-')) {
-                numStr += lengthStr[i];
-                i++;
-            }
-            while (i < lengthStr.size()) {
-                unit += lengthStr[i];
-                i++;
-            }
+    SVGLineJoin SVGParser::ParseLineJoin(std::string_view value) {
+        if (value == "round") return SVGLineJoin::Round;
+        if (value == "bevel") return SVGLineJoin::Bevel;
+        return SVGLineJoin::Miter;
+    }
 
-            float value = std::stof(numStr);
-
-            // 处理单位 (这里简化处理，大部分单位按像素处理)
-            if (unit == "px" || unit.empty()) {
-                return value;
-            } else if (unit == "pt") {
-                return value * 1.333f; // 1pt = 1.333px (approx)
-            } else if (unit == "pc") {
-                return value * 16.0f;  // 1pc = 16px
-            } else if (unit == "in") {
-                return value * 96.0f;  // 1in = 96px (assuming 96dpi)
-            } else if (unit == "cm") {
-                return value * 37.795f; // 1cm = 37.795px
-            } else if (unit == "mm") {
-                return value * 3.7795f; // 1mm = 3.7795px
-            } else if (unit == "em" || unit == "ex" || unit == "%") {
-                // 相对单位，暂时按像素处理
-                return value;
-            }
+    std::optional<float> SVGParser::ParseNumber(std::string_view text) {
+        // 与 std::stof 相同：跳过前导空白，忽略数字后的字符
+        size_t begin = 0;
+        while (begin < text.size() && std::isspace(static_cast<unsigned char>(text[begin]))) begin++;
+        size_t end = begin;
+        PathDataParser::ParseNumber(text, end);
 
-            return value;
-        } catch (const std::exception&) {
-            return defaultValue;
-        }
+        float value;
+        if (!PathDataParser::ToFloat(text.data() + begin, text.data() + end, value)) return std::nullopt;
+        return value;
     }
 
-    bool SVGParser::ParsePathData(const std::string& pathData, std::vector<PathCommand>& commands) {
-        commands.clear();
+    bool SVGParser::ParseHex(std::string_view text, int& value) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+        return result.ec == std::errc();
+    }
 
-        std::string data = pathData;
-        // 不要移除空白字符，因为它们是分隔符
-        // data.erase(std::remove_if(data.begin(), data.end(), ::isspace), data.end());
+    float SVGParser::ParseLength(std::string_view lengthStr, float defaultValue) {
+        if (lengthStr.empty()) return defaultValue;
 
+        // 分离数字和单位
         size_t i = 0;
-        Point2D currentPos(0, 0);
-        Point2D startPos(0, 0);
-        Point2D lastControlPoint(0, 0);  // 用于S/T命令的控制点反射
-        char lastCommand = '\0';
-        char lastUpperCommand = '\0';    // 用于跟踪上一个命令类型（用于S/T的控制点计算）
-
-        while (i < data.size()) {
-            // 跳过空白字符
-            while (i < data.size() && std::isspace(data[i])) i++;
-            if (i >= data.size()) break;
-
-            // 跳过逗号
-            if (data[i] == ',') {
-                i++;
-                continue;
-            }
-
-            char cmd = data[i];
-            bool relative = std::islower(cmd);
-            char upperCmd = std::toupper(cmd);
-
-            // 如果是连续的相同命令，可以省略命令字符
-            if ((cmd >= '0' && cmd <= '9') || cmd == '-' || cmd == '+' || cmd == '.') {
-                if (lastCommand != '\0') {
-                    upperCmd = std::toupper(lastCommand);
-                    relative = std::islower(lastCommand);
-                } else {
-                    continue; // 无效数据
-                }
-            } else {
-                i++; // 消耗命令字符
-                lastCommand = cmd;
-            }
-
-            // 在确定 relative 值后再创建 command
-            PathCommand command(PathCommandType::MoveTo, relative);
-
-            // 根据命令类型解析参数
-            switch (upperCmd) {
-                case 'M': // MoveTo
-                    command.type = PathCommandType::MoveTo;
-                    command.points = ParsePoints(data, i, 1);
-                    if (!command.points.empty()) {
-                        if (!relative) {
-                            currentPos = command.points[0];
-                            startPos = currentPos;
-                        } else {
-                            currentPos = currentPos + command.points[0];
-                            startPos = currentPos;
-                        }
-                        lastControlPoint = currentPos;  // 重置控制点
-                        
-                        // MoveTo 后面的隐式命令是 LineTo
-                        lastCommand = relative ? 'l' : 'L';
-                    }
-                    break;
-
-                case 'L': // LineTo
-                    command.type = PathCommandType::LineTo;
-                    command.points = ParsePoints(data, i, 1);
-                    if (!command.points.empty()) {
-                        if (!relative) {
-                            currentPos = command.points[0];
-                        } else {
-                            currentPos = currentPos + command.points[0];
-                        }
-                        lastControlPoint = currentPos;  // 重置控制点
-                    }
-                    break;
-
-                case 'C': // Cubic Bezier Curve
-                    command.type = PathCommandType::CurveTo;
-                    command.points = ParsePoints(data, i, 3);
-                    if (command.points.size() >= 3) {
-                        // 保存第二控制点用于S命令
-                        Point2D cp2 = relative ? currentPos + command.points[1] : command.points[1];
-                        lastControlPoint = cp2;
-                        if (!relative) {
-                            currentPos = command.points[2];
-                        } else {
-                            currentPos = currentPos + command.points[2];
-                        }
-                    }
-                    break;
-
-                case 'Q': // Quadratic Bezier Curve
-                    command.type = PathCommandType::QuadCurveTo;
-                    command.points = ParsePoints(data, i, 2);
-                    if (command.points.size() >= 2) {
-                        Point2D controlPoint = relative ? currentPos + command.points[0] : command.points[0];
-                        Point2D endPoint = relative ? currentPos + command.points[1] : command.points[1];
-                        lastControlPoint = controlPoint;  // 保存控制点用于T命令
-                        currentPos = endPoint;
-                    }
-                    break;
-
-                case 'H': // Horizontal Line To
-                {
-                    command.type = PathCommandType::LineTo;
-                    // H/h 只有一个x坐标参数
-                    float x = ParseNumber(data, i);
-                    if (relative) {
-                        command.points.push_back(Point2D(x, 0));  // 相对坐标，y增量为0
-                        currentPos.x += x;
-                    } else {
-                        command.points.push_back(Point2D(x, currentPos.y));  // 绝对坐标，y保持不变
-                        command.relative = false;
-                        currentPos.x = x;
-                    }
-                    lastControlPoint = currentPos;  // 重置控制点
-                    break;
-                }
-
-                case 'V': // Vertical Line To
-                {
-                    command.type = PathCommandType::LineTo;
-                    // V/v 只有一个y坐标参数
-                    float y = ParseNumber(data, i);
-                    if (relative) {
-                        command.points.push_back(Point2D(0, y));  // 相对坐标，x增量为0
-                        currentPos.y += y;
-                    } else {
-                        command.points.push_back(Point2D(currentPos.x, y));  // 绝对坐标，x保持不变
-                        command.relative = false;
-                        currentPos.y = y;
-                    }
-                    lastControlPoint = currentPos;  // 重置控制点
-                    break;
-                }
-
-                case 'S': // Smooth Cubic Bezier Curve (Shorthand)
-                {
-                    command.type = PathCommandType::CurveTo;
-                    // S/s 有两个点参数：第二控制点和终点
-                    // 第一控制点是上一个C/S命令的第二控制点的反射
-                    std::vector<Point2D> parsedPoints = ParsePoints(data, i, 2);
-                    if (parsedPoints.size() >= 2) {
-                        Point2D cp2 = relative ? currentPos + parsedPoints[0] : parsedPoints[0];
-                        Point2D endPoint = relative ? currentPos + parsedPoints[1] : parsedPoints[1];
-                        
-                        // 计算第一控制点（上一个控制点的反射）
-                        Point2D cp1;
-                        if (lastUpperCommand == 'C' || lastUpperCommand == 'S') {
-                            // 反射上一个控制点
-                            cp1 = Point2D(2 * currentPos.x - lastControlPoint.x, 
-                                         2 * currentPos.y - lastControlPoint.y);
-                        } else {
-                            // 如果上一个命令不是C或S，第一控制点等于当前点
-                            cp1 = currentPos;
-                        }
-                        
-                        // 转换为相对坐标存储（如果原命令是相对的）
-                        if (relative) {
-                            command.points.push_back(cp1 - currentPos);
-                            command.points.push_back(parsedPoints[0]);
-                            command.points.push_back(parsedPoints[1]);
-                        } else {
-                            command.points.push_back(cp1);
-                            command.points.push_back(cp2);
-                            command.points.push_back(endPoint);
-                            command.relative = false;
-                        }
-                        
-                        lastControlPoint = cp2;
-                        currentPos = endPoint;
-                    }
-                    break;
-                }
-
-                case 'T': // Smooth Quadratic Bezier Curve (Shorthand)
-                {
-                    command.type = PathCommandType::QuadCurveTo;
-                    // T/t 只有一个终点参数
-                    // 控制点是上一个Q/T命令的控制点的反射
-                    std::vector<Point2D> parsedPoints = ParsePoints(data, i, 1);
-                    if (parsedPoints.size() >= 1) {
-                        Point2D endPoint = relative ? currentPos + parsedPoints[0] : parsedPoints[0];
-                        
-                        // 计算控制点（上一个控制点的反射）
-                        Point2D cp;
-                        if (lastUpperCommand == 'Q' || lastUpperCommand == 'T') {
-                            // 反射上一个控制点
-                            cp = Point2D(2 * currentPos.x - lastControlPoint.x,
-                                        2 * currentPos.y - lastControlPoint.y);
-                        } else {
-                            // 如果上一个命令不是Q或T，控制点等于当前点
-                            cp = currentPos;
-                        }
-                        
-                        // 存储控制点和终点
-                        if (relative) {
-                            command.points.push_back(cp - currentPos);
-                            command.points.push_back(parsedPoints[0]);
-                        } else {
-                            command.points.push_back(cp);
-                            command.points.push_back(endPoint);
-                            command.relative = false;
-                        }
-                        
-                        lastControlPoint = cp;
-                        currentPos = endPoint;
-                    }
-                    break;
-                }
+        while (i < lengthStr.size() && (std::isdigit(lengthStr[i]) || lengthStr[i] == '.' || lengthStr[i] == '-')) {
+            i++;
+        }
+        std::string_view unit = lengthStr.substr(i);
 
-                case 'A': // Arc
-                    command.type = PathCommandType::ArcTo;
-                    // A/a rx ry x-axis-rotation large-arc-flag sweep-flag x y
-                    {
-                        float rx = ParseNumber(data, i);
-                        while (i < data.size() && std::isspace(data[i])) i++; if (i < data.size() && data[i] == ',') i++;
-                        float ry = ParseNumber(data, i);
-                        while (i < data.size() && std::isspace(data[i])) i++; if (i < data.size() && data[i] == ',') i++;
-                        float rot = ParseNumber(data, i);
-                        while (i < data.size() && std::isspace(data[i])) i++; if (i < data.size() && data[i] == ',') i++;
-                        float largeArc = ParseNumber(data, i);
-                        while (i < data.size() && std::isspace(data[i])) i++; if (i < data.size() && data[i] == ',') i++;
-                        float sweep = ParseNumber(data, i);
-                        while (i < data.size() && std::isspace(data[i])) i++; if (i < data.size() && data[i] == ',') i++;
-                        float x = ParseNumber(data, i);
-                        while (i < data.size() && std::isspace(data[i])) i++; if (i < data.size() && data[i] == ',') i++;
-                        float y = ParseNumber(data, i);
-                        while (i < data.size() && std::isspace(data[i])) i++; if (i < data.size() && data[i] == ',') i++;
-
-                        command.points.push_back(Point2D(rx, ry));
-                        command.points.push_back(Point2D(x, y));
-
-                        if (!relative) {
-                            currentPos = command.points[1];
-                        } else {
-                            currentPos = currentPos + command.points[1];
-                        }
-                    }
-                    break;
-
-                case 'Z': // ClosePath
-                    command.type = PathCommandType::ClosePath;
-                    command.points.clear();
-                    currentPos = startPos;
-                    lastControlPoint = currentPos;  // 重置控制点
-                    break;
-
-                default:
-                    // 未知命令，跳过
-                    i++;
-                    while (i < data.size() && !std::isalpha(data[i])) i++;
-                    continue;
-            }
+        float value;
+        if (!PathDataParser::ToFloat(lengthStr.data(), lengthStr.data() + i, value)) return defaultValue;
 
-            // 记录上一个命令类型（用于S/T命令的控制点计算）
-            lastUpperCommand = upperCmd;
-            commands.push_back(command);
+        // 处理单位 (这里简化处理，大部分单位按像素处理)
+        if (unit == "px" || unit.empty()) {
+            return value;
+        } else if (unit == "pt") {
+            return value * 1.333f; // 1pt = 1.333px (approx)
+        } else if (unit == "pc") {
+            return value * 16.0f;  // 1pc = 16px
+        } else if (unit == "in") {
+            return value * 96.0f;  // 1in = 96px (assuming 96dpi)
+        } else if (unit == "cm") {
+            return value * 37.795f; // 1cm = 37.795px
+        } else if (unit == "mm") {
+            return value * 3.7795f; // 1mm = 3.7795px
+        } else if (unit == "em" || unit == "ex" || unit == "%") {
+            // 相对单位，暂时按像素处理
+            return value;
         }
 
-        return !commands.empty();
+        return value;
     }
 
-    std::vector<Point2D> SVGParser::ParsePoints(const std::string& data, size_t& i, int count) {
-        std::vector<Point2D> points;
-
-        for (int p = 0; p < count; p++) {
-            // 解析x坐标
-            float x = ParseNumber(data, i);
-            
-            // 跳过分隔符（空白和逗号）
-            while (i < data.size() && std::isspace(data[i])) i++;
-            if (i < data.size() && data[i] == ',') i++;
+    bool SVGParser::ParsePathData(std::string_view pathData, std::vector<PathCommand>& commands,
+                                  std::vector<std::uint8_t>& verbs, std::vector<Point2D>& points) {
+        // 先打包到复用的数组，再展开为编辑用的 PathCommand
+        verbs.clear();
+        points.clear();
+        PathDataParser::Parse(pathData, verbs, points);
 
-            // 解析y坐标
-            float y = ParseNumber(data, i);
-
-            points.emplace_back(x, y);
-
-            // 跳过分隔符（空白和逗号），为下一个点做准备
-            while (i < data.size() && std::isspace(data[i])) i++;
-            if (i < data.size() && data[i] == ',') i++;
+        commands.clear();
+        commands.reserve(verbs.size());
+        PathView packed(verbs.data(), static_cast<std::uint32_t>(verbs.size()), points.data());
+        for (const auto& command : packed) {
+            PathCommand& out = commands.emplace_back(command.type, command.relative);
+            out.points.assign(command.points.data, command.points.data + command.points.count);
         }
-
-        return points;
+        return !commands.empty();
     }
 
-    float SVGParser::ParseNumber(const std::string& data, size_t& i) {
-        std::string numStr;
+    std::vector<size_t> SVGParser::SplitDeferredPaths() {
+        if (!_threadPool || (_threadCount != 0 && _threadPool->GetThreadCount() != _threadCount)) {
+            _threadPool = std::make_unique<ThreadPool>(_threadCount);
+        }
 
-        // 跳过空白字符
-        while (i < data.size() && std::isspace(data[i])) i++;
+        // 每线程几段以平衡长短不一的路径；数据太少时只分一段，在调用线程上完成
+        size_t totalBytes = 0;
+        for (const DeferredPath& path : _deferredPaths) totalBytes += path.data.size();
+        size_t chunkCount = totalBytes < c_MinParallelPathBytes ? 1 : _threadPool->GetThreadCount() * 4;
+        size_t chunkBytes = totalBytes / chunkCount + 1;
 
-        // 处理符号
-        if (i < data.size() && (data[i] == '-' || data[i] == '+')) {
-            numStr += data[i];
-            i++;
+        std::vector<size_t> starts { 0 };
+        size_t bytes = 0;
+        for (size_t i = 0; i < _deferredPaths.size(); ++i) {
+            bytes += _deferredPaths[i].data.size();
+            if (bytes >= chunkBytes && i + 1 < _deferredPaths.size()) {
+                starts.push_back(i + 1);
+                bytes = 0;
+            }
         }
+        starts.push_back(_deferredPaths.size());
+        return starts;
+    }
 
-        // 处理数字部分
-        bool hasDot = false;
-        while (i < data.size()) {
-            char c = data[i];
-            if (std::isdigit(c)) {
-                numStr += c;
-                i++;
-            } else if (c == '.' && !hasDot) {
-                numStr += c;
-                hasDot = true;
-                i++;
-            } else if (c == 'e' || c == 'E') {
-                numStr += c;
-                i++;
-                // 处理指数符号
-                if (i < data.size() && (data[i] == '-' || data[i] == '+')) {
-                    numStr += data[i];
-                    i++;
-                }
-                // 处理指数数字
-                while (i < data.size() && std::isdigit(data[i])) {
-                    numStr += data[i];
-                    i++;
-                }
-                break;
-            } else {
-                break;
+    void SVGParser::ParseDeferredPaths(FlatDocument& document) {
+        // 各段解析到自己的数组，路径范围先记段内偏移；再按文档顺序把各段拼接进 verbs/points
+        struct Chunk {
+            std::vector<std::uint8_t> verbs;
+            std::vector<Point2D> points;
+            size_t verbBase = 0;
+            size_t pointBase = 0;
+        };
+        std::vector<size_t> starts = SplitDeferredPaths();
+        std::vector<Chunk> chunks(starts.size() - 1);
+        _threadPool->ParallelFor(chunks.size(), [&](size_t c, unsigned) {
+            Chunk& chunk = chunks[c];
+            for (size_t i = starts[c]; i < starts[c + 1]; ++i) {
+                FlatDocument::PathRange& range = document.paths[_deferredPaths[i].target];
+                range.firstVerb = static_cast<std::uint32_t>(chunk.verbs.size());
+                range.firstPoint = static_cast<std::uint32_t>(chunk.points.size());
+                PathDataParser::Parse(_deferredPaths[i].data, chunk.verbs, chunk.points);
+                range.verbCount = static_cast<std::uint32_t>(chunk.verbs.size()) - range.firstVerb;
             }
-        }
+        });
+
+        size_t verbCount = document.verbs.size();
+        size_t pointCount = document.points.size();
+        for (Chunk& chunk : chunks) {
+            chunk.verbBase = verbCount;
+            chunk.pointBase = pointCount;
+            verbCount += chunk.verbs.size();
+            pointCount += chunk.points.size();
+        }
+        document.verbs.resize(verbCount);
+        document.points.resize(pointCount);
+        _threadPool->ParallelFor(chunks.size(), [&](size_t c, unsigned) {
+            const Chunk& chunk = chunks[c];
+            std::copy(chunk.verbs.begin(), chunk.verbs.end(), document.verbs.begin() + chunk.verbBase);
+            std::copy(chunk.points.begin(), chunk.points.end(), document.points.begin() + chunk.pointBase);
+            for (size_t i = starts[c]; i < starts[c + 1]; ++i) {
+                FlatDocument::PathRange& range = document.paths[_deferredPaths[i].target];
+                range.firstVerb += static_cast<std::uint32_t>(chunk.verbBase);
+                range.firstPoint += static_cast<std::uint32_t>(chunk.pointBase);
+            }
+        });
+    }
 
-        try {
-            return std::stof(numStr);
-        } catch (const std::exception&) {
-            return 0.0f;
-        }
+    void SVGParser::ParseDeferredPaths(SVGDocument& document) {
+        // 每个元素只由一段写入；打包用的临时数组每段一份
+        std::vector<size_t> starts = SplitDeferredPaths();
+        _threadPool->ParallelFor(starts.size() - 1, [&](size_t c, unsigned) {
+            std::vector<std::uint8_t> verbs;
+            std::vector<Point2D> points;
+            for (size_t i = starts[c]; i < starts[c + 1]; ++i) {
+                SVGElement& element = document.elements[_deferredPaths[i].target];
+                ParsePathData(_deferredPaths[i].data, element.path.commands, verbs, points);
+            }
+        });
     }
 
-    std::string SVGParser::GetAttribute(tinyxml2::XMLElement* element, const char* name, const std::string& defaultValue) {
-        const char* value = element->Attribute(name);
-        return value ? std::string(value) : defaultValue;
+    std::string_view SVGParser::GetAttribute(const XmlAttributes& attributes, std::string_view name, std::string_view defaultValue) {
+        const std::string_view* value = attributes.Find(name);
+        return value ? *value : defaultValue;
     }
 
-    bool SVGParser::HasAttribute(tinyxml2::XMLElement* element, const char* name) {
-        return element->Attribute(name) != nullptr;
+    bool SVGParser::HasAttribute(const XmlAttributes& attributes, std::string_view name) {
+        return attributes.Find(name) != nullptr;
     }
-}
\ No newline at end of file
+
+} // namespace VCX::Labs::SVG
@@ -1,59 +1,167 @@
 #pragma once
 
 #include "SVG.h"
-#include <string>
+#include "Document/FlatDocument.h"
+#include "Parser/XmlReader.h"
+#include "Core/ThreadPool.h"
+#include <algorithm>
+#include <cstddef>
 #include <memory>
-
-namespace tinyxml2 {
-    class XMLDocument;
-    class XMLElement;
-}
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace VCX::Labs::SVG {
 
+// 各元素在源文本中的位置（SVGParser::ParseString 可选输出），
+// 供代码编辑器只重新解析被改动的那个元素
+struct SVGSourceMap {
+    // 组合后的组变换与继承样式，即元素加入文档时所用的
+    struct Group {
+        Transform2D transform;
+        SVGStyle style;
+    };
+    // 元素的源文本 [begin, end)：从开始标签的 '<' 到结束标签（或自闭合标签）的 '>' 之后
+    struct Span {
+        size_t begin;
+        size_t end;
+        std::uint32_t group;            // Into groups
+    };
+
+    std::vector<Group> groups;          // [0] 为根元素
+    std::vector<Span> spans;            // 与本次解析加入的元素按顺序对应；范围递增且互不重叠
+
+    void Clear() {
+        groups.clear();
+        spans.clear();
+    }
+
+    // 完全位于某个元素首尾的 '<'、'>' 之间的范围 [begin, end) 属于哪个元素，-1 表示没有
+    int FindEnclosing(size_t begin, size_t end) const {
+        auto it = std::upper_bound(spans.begin(), spans.end(), begin,
+                                   [](size_t offset, const Span& span) { return offset < span.begin; });
+        if (it == spans.begin()) return -1;
+        --it;
+        if (begin <= it->begin || end >= it->end) return -1;
+        return static_cast<int>(it - spans.begin());
+    }
+
+    // 元素 index 的源文本长度变化了 delta：它的 end 与其后各元素整体移动
+    void Resize(size_t index, std::ptrdiff_t delta) {
+        spans[index].end += delta;
+        for (size_t i = index + 1; i < spans.size(); ++i) {
+            spans[i].begin += delta;
+            spans[i].end += delta;
+        }
+    }
+};
+
+// 流式解析：XmlReader 逐个标签回调，元素直接写入文档，不建立 XML DOM；
+// 文件通过内存映射读取
 class SVGParser {
 public:
-    SVGParser();
-    ~SVGParser();
-
     // 解析SVG文件
     bool ParseFile(const std::string& filename, SVGDocument& document);
 
     // 解析SVG字符串
     bool ParseString(const std::string& svgContent, SVGDocument& document);
+    // 同时记录各元素的源文本范围
+    bool ParseString(const std::string& svgContent, SVGDocument& document, SVGSourceMap& sourceMap);
+
+    // 把一个元素的源文本 markup 解析为处于 group 中的元素（编辑器局部更新）；
+    // markup 须恰好是一个会加入文档的元素，否则返回 false 且不输出错误
+    bool ParseElement(std::string_view markup, const SVGSourceMap::Group& group, SVGElement& element);
+
+    // 解析为紧凑的只读文档（加载与渲染用，不可逐元素编辑）
+    // ParseFile 优先读取源文件旁的 FlatDocumentCache 缓存，缓存缺失或过期时解析并重写
+    bool ParseFile(const std::string& filename, FlatDocument& document);
+    bool ParseString(const std::string& svgContent, FlatDocument& document);
+
+    // 是否使用/写入文档缓存（默认开启）
+    void SetDocumentCacheEnabled(bool enabled) { _documentCacheEnabled = enabled; }
+
+    // 1 = 串行（默认）；>1 = 路径数据 (d) 在 XML 读完后于线程池上分段并行解析，
+    // 0 = 每核一个线程。元素顺序与解析结果和串行相同
+    void SetThreadCount(unsigned count) { _threadCount = count; }
 
 private:
-    std::unique_ptr<tinyxml2::XMLDocument> _xmlDoc;
+    template <typename Document> class Builder;     // XmlReader 的回调（SVGParser.cpp）
+
+    // <text> 的开始标签已解析、等待其文本的 FlatDocument 节点
+    struct FlatText {
+        std::uint32_t id = 0;
+        std::uint32_t style = 0;
+        std::uint32_t transform = 0;
+        std::uint32_t shapeTransform = 0;
+        FlatDocument::TextRun run {};
+    };
+
+    // 延后解析的 d 属性（指向源文本）；target 为 FlatDocument::paths 或 SVGDocument::elements 的下标
+    struct DeferredPath {
+        std::uint32_t target;
+        std::string_view data;
+    };
+
+    XmlReader _reader;
+    bool _documentCacheEnabled = true;
+    std::vector<std::uint8_t> _pathVerbs;       // ParsePathData 的打包结果，复用
+    std::vector<Point2D> _pathPoints;
+
+    // 路径数据少于此字节数时不分段
+    static constexpr size_t c_MinParallelPathBytes = 256 * 1024;
+
+    unsigned _threadCount = 1;
+    std::unique_ptr<ThreadPool> _threadPool;
+    std::vector<DeferredPath> _deferredPaths;   // 文档顺序
+
+    // 并行模式下路径只检查有无命令，数据在 ParseDeferredPaths 中解析
+    bool DefersPaths() const { return _threadCount != 1; }
+    void ParseDeferredPaths(FlatDocument& document);
+    void ParseDeferredPaths(SVGDocument& document);
+    // 把 _deferredPaths 按数据量切成若干段，返回各段的起点（末尾为总数）
+    std::vector<size_t> SplitDeferredPaths();
+
+    // 解析整个源文本，description 用于错误信息（"content" / "file <name>"）
+    template <typename Document>
+    bool ParseSource(std::string_view source, const std::string& description, Document& document,
+                     SVGSourceMap* sourceMap = nullptr);
 
-    // 解析SVG根元素
-    bool ParseSVGElement(tinyxml2::XMLElement* svgElement, SVGDocument& document);
+    // 根元素的 width/height/viewBox
+    void ParseDocumentHeader(const XmlAttributes& attributes, float& width, float& height, std::string& viewBox);
 
-    // 解析各种SVG元素
-    bool ParsePathElement(tinyxml2::XMLElement* element, SVGElement& svgElement);
-    bool ParseCircleElement(tinyxml2::XMLElement* element, SVGElement& svgElement);
-    bool ParseEllipseElement(tinyxml2::XMLElement* element, SVGElement& svgElement);
-    bool ParseRectElement(tinyxml2::XMLElement* element, SVGElement& svgElement);
-    bool ParseLineElement(tinyxml2::XMLElement* element, SVGElement& svgElement);
-    bool ParseTextElement(tinyxml2::XMLElement* element, SVGElement& svgElement);
-    bool ParseGroupElement(tinyxml2::XMLElement* element, SVGElement& svgElement);
+    // 解析各种SVG元素（文本内容在读到子节点后由 Builder 填入）
+    bool ParsePathElement(const XmlAttributes& attributes, SVGElement& svgElement);
+    bool ParseCircleElement(const XmlAttributes& attributes, SVGElement& svgElement);
+    bool ParseEllipseElement(const XmlAttributes& attributes, SVGElement& svgElement);
+    bool ParseRectElement(const XmlAttributes& attributes, SVGElement& svgElement);
+    bool ParseLineElement(const XmlAttributes& attributes, SVGElement& svgElement);
+    bool ParseTextElement(const XmlAttributes& attributes, SVGElement& svgElement);
 
-    // 递归解析<g>标签并将所有子元素展平添加到document.elements
-    void ParseGroupElementFlattened(tinyxml2::XMLElement* element, SVGDocument& document, const Transform2D& parentTransform, const SVGStyle& parentStyle);
+    // FlatDocument 版本：形状直接写入各表；<text> 先记下属性，结束标签时写入
+    bool ParseFlatShape(std::string_view tagName, const XmlAttributes& attributes, FlatDocument& document, std::uint32_t transform);
+    void ParseFlatText(const XmlAttributes& attributes, FlatDocument& document, std::uint32_t transform, FlatText& text);
 
     // 解析样式和属性
-    SVGStyle ParseStyle(tinyxml2::XMLElement* element);
-    Transform2D ParseTransform(const std::string& transformStr);
-    glm::vec4 ParseColor(const std::string& colorStr);
-    float ParseLength(const std::string& lengthStr, float defaultValue = 0.0f);
+    SVGStyle ParseStyle(const XmlAttributes& attributes);
+    Transform2D ParseTransform(std::string_view transformStr);
+    glm::vec4 ParseColor(std::string_view colorStr);
+    float ParseLength(std::string_view lengthStr, float defaultValue = 0.0f);
+    // 数值与十六进制数；不是数字时失败而不抛异常（编辑器每次按键都会解析）
+    static std::optional<float> ParseNumber(std::string_view text);
+    static bool ParseHex(std::string_view text, int& value);
+    static SVGFillRule ParseFillRule(std::string_view value);
+    static SVGLineCap ParseLineCap(std::string_view value);
+    static SVGLineJoin ParseLineJoin(std::string_view value);
 
-    // 解析路径数据 (d属性)
-    bool ParsePathData(const std::string& pathData, std::vector<PathCommand>& commands);
+    // 解析路径数据 (d属性)，verbs/points 为打包结果的临时数组；
+    // FlatDocument 直接用 PathDataParser 写入文档
+    static bool ParsePathData(std::string_view pathData, std::vector<PathCommand>& commands,
+                              std::vector<std::uint8_t>& verbs, std::vector<Point2D>& points);
 
     // 工具函数
-    std::string GetAttribute(tinyxml2::XMLElement* element, const char* name, const std::string& defaultValue = "");
-    bool HasAttribute(tinyxml2::XMLElement* element, const char* name);
-    std::vector<Point2D> ParsePoints(const std::string& data, size_t& i, int count);
-    float ParseNumber(const std::string& data, size_t& i);
+    std::string_view GetAttribute(const XmlAttributes& attributes, std::string_view name, std::string_view defaultValue = {});
+    bool HasAttribute(const XmlAttributes& attributes, std::string_view name);
 };
 
 } // namespace VCX::Labs::SVG
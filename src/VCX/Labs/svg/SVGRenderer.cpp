@@ -222,7 +222,7 @@ void SVGRenderer::RenderPath(const SVGPath& path, Common::ImageRGB& image) {
 
     // 判断填充规则：默认为NonZero
     bool useNonZeroRule = true;
-    if (path.style.fillRule.has_value() && path.style.fillRule.value() == "evenodd") {
+    if (path.style.fillRule == SVGFillRule::EvenOdd) {
         useNonZeroRule = false;
     }
 
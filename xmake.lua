@@ -16,7 +16,6 @@ add_requires("fmt")
 add_requires("tinyobjloader")
 add_requires("yaml-cpp")
 add_requires("eigen")
-add_requires("tinyxml2")
 
 if is_plat("macosx") then
     add_defines("PLATFORM_MACOSX")
@@ -52,7 +51,6 @@ target("engine")
     add_packages("fmt"          , { public = true })
     add_packages("tinyobjloader", { public = true })
     add_packages("yaml-cpp"     , { public = true })
-    add_packages("tinyxml2"     , { public = true })
 
     add_includedirs("src/3rdparty", { public = true })
     add_includedirs("src/VCX"     , { public = true })
@@ -78,4 +76,50 @@ target("svgrender")
     add_headerfiles("src/VCX/Labs/svg/*.h")
     add_headerfiles("src/VCX/Labs/svg/*.hpp")
     add_files      ("src/VCX/Labs/svg/*.cpp")
-    add_packages("tinyxml2")
\ No newline at end of file
+
+-- Headless batch renderer: SVGParser + SVGRendererV2 only, no engine/GL
+target("svgrender-cli")
+    set_kind("binary")
+    add_packages("glm"     )
+    add_packages("stb"     )
+    add_includedirs("src/VCX")
+    add_includedirs("src/VCX/Labs/svg")
+    add_files      ("src/VCX/Labs/svg/Cli/*.cpp")
+    add_files      ("src/VCX/Labs/svg/SVGParser.cpp")
+    add_files      ("src/VCX/Labs/svg/SVG.cpp")
+    add_files      ("src/3rdparty/stb_image.cpp")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+-- Per-stage rendering benchmark on synthetic scenes (JSON report)
+target("svg-bench")
+    set_kind("binary")
+    add_packages("glm"     )
+    add_includedirs("src/VCX")
+    add_includedirs("src/VCX/Labs/svg")
+    add_files      ("src/VCX/Labs/svg/Bench/*.cpp")
+    add_files      ("src/VCX/Labs/svg/SVGParser.cpp")
+    add_files      ("src/VCX/Labs/svg/SVG.cpp")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    elseif is_plat("windows") then
+        add_syslinks("psapi")
+    end
+
+-- Golden-image check: renders assets/ and assets/golden/ in every AA mode and
+-- fill rule and compares against assets/golden/reference/*.png
+target("svg-golden")
+    set_kind("binary")
+    add_packages("glm"     )
+    add_packages("stb"     )
+    add_includedirs("src/VCX")
+    add_includedirs("src/VCX/Labs/svg")
+    add_files      ("src/VCX/Labs/svg/Golden/*.cpp")
+    add_files      ("src/VCX/Labs/svg/SVGParser.cpp")
+    add_files      ("src/VCX/Labs/svg/SVG.cpp")
+    add_files      ("src/3rdparty/stb_image.cpp")
+    set_rundir("$(projectdir)")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end